@@ -0,0 +1,1125 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "s21_matrix_batch.h"
+#include "s21_matrix_io.h"
+#include "s21_matrix_oop.h"
+#include "s21_sparse_matrix.h"
+#include "s21_strassen.h"
+
+//-------------Подсчет выделений памяти-------------------
+
+// Глобальные operator new/delete заменены, чтобы считать выделения в куче
+// (включая выровненные буферы матриц и служебные выделения пула потоков).
+// Варианты new[]/delete[] стандартной библиотеки вызывают эти функции.
+// noinline: иначе GCC видит пару malloc/free за new/delete и выдает ложное
+// -Wmismatched-new-delete
+#define S21_BENCH_NOINLINE __attribute__((noinline))
+
+static std::atomic<long> g_allocations{0};
+
+S21_BENCH_NOINLINE void* operator new(size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+S21_BENCH_NOINLINE void* operator new(size_t size, std::align_val_t align) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  size_t a = static_cast<size_t>(align);
+  size = (size + a - 1) / a * a;
+  if (void* p = std::aligned_alloc(a, size ? size : a)) return p;
+  throw std::bad_alloc();
+}
+
+S21_BENCH_NOINLINE void operator delete(void* p) noexcept { std::free(p); }
+S21_BENCH_NOINLINE void operator delete(void* p, size_t) noexcept {
+  std::free(p);
+}
+S21_BENCH_NOINLINE void operator delete(void* p, std::align_val_t) noexcept {
+  std::free(p);
+}
+S21_BENCH_NOINLINE void operator delete(void* p, size_t,
+                                        std::align_val_t) noexcept {
+  std::free(p);
+}
+
+namespace {
+
+/**
+ * @brief Считает выделения памяти за время жизни объекта и по завершении
+ * бенчмарка публикует среднее число выделений на итерацию
+ */
+class AllocationCounter {
+ public:
+  explicit AllocationCounter(benchmark::State& state)
+      : state_(state), start_(g_allocations.load()) {}
+  ~AllocationCounter() {
+    state_.counters["allocs"] = benchmark::Counter(
+        (double)(g_allocations.load() - start_),
+        benchmark::Counter::kAvgIterations);
+  }
+
+ private:
+  benchmark::State& state_;
+  long start_;
+};
+
+// Скорость в операциях с плавающей точкой (выводится как FLOP/s с
+// приставкой: 32G/s = 32 GFLOP/s) и объем памяти за итерацию (GB/s)
+void SetRates(benchmark::State& state, double flops, double bytes) {
+  if (flops > 0) {
+    state.counters["FLOP/s"] = benchmark::Counter(
+        flops, benchmark::Counter::kIsIterationInvariantRate);
+  }
+  if (bytes > 0) state.SetBytesProcessed((int64_t)(bytes * state.iterations()));
+}
+
+S21Matrix MakeMatrix(int rows, int cols) {
+  S21Matrix m(rows, cols);
+  m.sequent_filling(0.5, 1.0 / ((double)rows * cols + 1));
+  return m;
+}
+
+// Сбрасывает сохраненное разложение матрицы (выдача доступа на запись
+// через data()), чтобы каждая итерация раскладывала ее заново
+template <typename T>
+void DropFactors(S21BasicMatrix<T>& a) {
+  benchmark::DoNotOptimize(a.data());
+}
+
+// Хорошо обусловленная квадратная матрица (диагональное преобладание) для
+// определителя, обращения и разложений
+S21Matrix MakeSquare(int n) {
+  S21Matrix m(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) m(i, j) = ((i * 7 + j * 13) % 17 - 8) * 0.01;
+    m(i, i) += 2;
+  }
+  return m;
+}
+
+constexpr double kDouble = sizeof(double);
+
+//-------------Наборы размеров-------------------
+
+// Квадратные размеры 1 ... max (степени 8 и max)
+void SquareSizes(benchmark::internal::Benchmark* b, int max) {
+  for (int n = 1; n < max; n *= 8) b->Args({n, n});
+  b->Args({max, max});
+}
+
+// Квадратные, неквадратные, высокие/узкие и низкие/широкие формы
+void ElementwiseShapes(benchmark::internal::Benchmark* b) {
+  SquareSizes(b, 4096);
+  b->Args({100, 300})->Args({4096, 8})->Args({8, 4096})->Args({65536, 4});
+}
+
+void SquareShapes4096(benchmark::internal::Benchmark* b) {
+  SquareSizes(b, 4096);
+}
+
+// Обращение и дополнения в 3 раза дороже определителя: до 2048
+void SquareShapes2048(benchmark::internal::Benchmark* b) {
+  SquareSizes(b, 2048);
+}
+
+// m x k на k x n
+void GemmShapes(benchmark::internal::Benchmark* b) {
+  for (int n = 1; n < 4096; n *= 8) b->Args({n, n, n});
+  b->Args({4096, 4096, 4096});
+  b->Args({300, 200, 100});
+  b->Args({4096, 16, 4096});  // внешнее произведение узких
+  b->Args({16, 4096, 16});    // внутреннее произведение длинных
+  b->Args({4096, 64, 64});    // высокая на маленькую
+  b->Args({65536, 8, 8});
+}
+
+//-------------Конструкторы и присваивание-------------------
+
+void BM_ConstructorDefault(benchmark::State& state) {
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    S21Matrix m;
+    benchmark::DoNotOptimize(m(0, 0));
+  }
+}
+BENCHMARK(BM_ConstructorDefault);
+
+void BM_ConstructorSize(benchmark::State& state) {
+  int rows = state.range(0), cols = state.range(1);
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    S21Matrix m(rows, cols);
+    benchmark::DoNotOptimize(m(0, 0));
+  }
+  SetRates(state, 0, kDouble * rows * cols);
+}
+BENCHMARK(BM_ConstructorSize)->Apply(ElementwiseShapes);
+
+void BM_ConstructorCopy(benchmark::State& state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = MakeMatrix(rows, cols);
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    S21Matrix m(a);
+    benchmark::DoNotOptimize(m(0, 0));
+  }
+  SetRates(state, 0, 2 * kDouble * rows * cols);
+}
+BENCHMARK(BM_ConstructorCopy)->Apply(ElementwiseShapes);
+
+void BM_ConstructorMove(benchmark::State& state) {
+  S21Matrix a = MakeMatrix(state.range(0), state.range(1));
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    S21Matrix m(std::move(a));
+    a = std::move(m);
+  }
+}
+BENCHMARK(BM_ConstructorMove)->Args({64, 64});
+
+void BM_AssignCopy(benchmark::State& state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = MakeMatrix(rows, cols), b(rows, cols);
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    b = a;
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, 0, 2 * kDouble * rows * cols);
+}
+BENCHMARK(BM_AssignCopy)->Apply(ElementwiseShapes);
+
+void BM_AssignMove(benchmark::State& state) {
+  S21Matrix a = MakeMatrix(state.range(0), state.range(1)), b;
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    b = std::move(a);
+    a = std::move(b);
+  }
+}
+BENCHMARK(BM_AssignMove)->Args({64, 64});
+
+void BM_Mutator(benchmark::State& state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = MakeMatrix(rows, cols);
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    a.mutator(rows + 1, cols + 1);
+    a.mutator(rows, cols);
+  }
+  SetRates(state, 0, 4 * kDouble * rows * cols);
+}
+BENCHMARK(BM_Mutator)->Apply(ElementwiseShapes);
+
+void BM_OperatorIndex(benchmark::State& state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = MakeMatrix(rows, cols);
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    double sum = 0;
+    for (int m = 0; m < rows; m++) {
+      for (int n = 0; n < cols; n++) sum += a(m, n);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  SetRates(state, (double)rows * cols, kDouble * rows * cols);
+}
+BENCHMARK(BM_OperatorIndex)->Args({64, 64})->Args({1024, 1024});
+
+//-------------Поэлементные операции-------------------
+
+void BM_EqMatrix(benchmark::State& state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = MakeMatrix(rows, cols), b(a);
+  AllocationCounter allocs(state);
+  for (auto _ : state) benchmark::DoNotOptimize(a.EqMatrix(b));
+  SetRates(state, 0, 2 * kDouble * rows * cols);
+}
+BENCHMARK(BM_EqMatrix)->Apply(ElementwiseShapes);
+
+void BM_OperatorEqual(benchmark::State& state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = MakeMatrix(rows, cols), b(a);
+  AllocationCounter allocs(state);
+  for (auto _ : state) benchmark::DoNotOptimize(a == b);
+  SetRates(state, 0, 2 * kDouble * rows * cols);
+}
+BENCHMARK(BM_OperatorEqual)->Args({1024, 1024});
+
+void BM_SumMatrix(benchmark::State& state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = MakeMatrix(rows, cols), b = MakeMatrix(rows, cols);
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    a.SumMatrix(b);
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, (double)rows * cols, 3 * kDouble * rows * cols);
+}
+BENCHMARK(BM_SumMatrix)->Apply(ElementwiseShapes);
+
+void BM_SubMatrix(benchmark::State& state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = MakeMatrix(rows, cols), b = MakeMatrix(rows, cols);
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    a.SubMatrix(b);
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, (double)rows * cols, 3 * kDouble * rows * cols);
+}
+BENCHMARK(BM_SubMatrix)->Apply(ElementwiseShapes);
+
+void BM_MulNumber(benchmark::State& state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = MakeMatrix(rows, cols);
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    a.MulNumber(1.0000001);
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, (double)rows * cols, 2 * kDouble * rows * cols);
+}
+BENCHMARK(BM_MulNumber)->Apply(ElementwiseShapes);
+
+void BM_OperatorSum(benchmark::State& state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = MakeMatrix(rows, cols), b = MakeMatrix(rows, cols), c;
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    c = a + b;
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, (double)rows * cols, 3 * kDouble * rows * cols);
+}
+BENCHMARK(BM_OperatorSum)->Apply(ElementwiseShapes);
+
+void BM_OperatorSub(benchmark::State& state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = MakeMatrix(rows, cols), b = MakeMatrix(rows, cols), c;
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    c = a - b;
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, (double)rows * cols, 3 * kDouble * rows * cols);
+}
+BENCHMARK(BM_OperatorSub)->Apply(ElementwiseShapes);
+
+void BM_OperatorMulNumber(benchmark::State& state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = MakeMatrix(rows, cols), c;
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    c = a * 2.0;
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, (double)rows * cols, 2 * kDouble * rows * cols);
+}
+BENCHMARK(BM_OperatorMulNumber)->Apply(ElementwiseShapes);
+
+void BM_OperatorNumberMul(benchmark::State& state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = MakeMatrix(rows, cols), c;
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    c = 2.0 * a;
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, (double)rows * cols, 2 * kDouble * rows * cols);
+}
+BENCHMARK(BM_OperatorNumberMul)->Apply(ElementwiseShapes);
+
+// a + b * 2 - 0.5 * c: 4 операции на элемент, 3 чтения и 1 запись
+void BM_ExpressionChain(benchmark::State& state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = MakeMatrix(rows, cols), b = MakeMatrix(rows, cols);
+  S21Matrix c = MakeMatrix(rows, cols), d;
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    d = a + b * 2 - 0.5 * c;
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, 4.0 * rows * cols, 4 * kDouble * rows * cols);
+}
+BENCHMARK(BM_ExpressionChain)->Apply(ElementwiseShapes);
+
+void BM_OperatorSumAssign(benchmark::State& state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = MakeMatrix(rows, cols), b = MakeMatrix(rows, cols);
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    a += b;
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, (double)rows * cols, 3 * kDouble * rows * cols);
+}
+BENCHMARK(BM_OperatorSumAssign)->Apply(ElementwiseShapes);
+
+void BM_OperatorSubAssign(benchmark::State& state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = MakeMatrix(rows, cols), b = MakeMatrix(rows, cols);
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    a -= b;
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, (double)rows * cols, 3 * kDouble * rows * cols);
+}
+BENCHMARK(BM_OperatorSubAssign)->Apply(ElementwiseShapes);
+
+void BM_OperatorMulAssignNumber(benchmark::State& state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = MakeMatrix(rows, cols);
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    a *= 1.0000001;
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, (double)rows * cols, 2 * kDouble * rows * cols);
+}
+BENCHMARK(BM_OperatorMulAssignNumber)->Apply(ElementwiseShapes);
+
+//-------------Транспонирование-------------------
+
+void BM_Transpose(benchmark::State& state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = MakeMatrix(rows, cols);
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    S21Matrix t = a.Transpose();
+    benchmark::DoNotOptimize(t(0, 0));
+  }
+  SetRates(state, 0, 2 * kDouble * rows * cols);
+}
+BENCHMARK(BM_Transpose)->Apply(ElementwiseShapes);
+
+void BM_TransposeInPlace(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeMatrix(n, n);
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    a.TransposeInPlace();
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, 0, 2 * kDouble * n * n);
+}
+BENCHMARK(BM_TransposeInPlace)->Apply(SquareShapes4096);
+
+// m x k на k x n и порог Штрассена: квадратные, нечетные и неквадратные
+void StrassenShapes(benchmark::internal::Benchmark* b) {
+  for (int crossover : {0, 256, 512, 1024}) {
+    for (int n : {1024, 2048, 4096}) b->Args({n, n, n, crossover});
+    b->Args({2047, 2049, 2051, crossover});
+    b->Args({4096, 1024, 2048, crossover});
+  }
+}
+
+//-------------Умножение матриц-------------------
+
+void BM_MulMatrix(benchmark::State& state) {
+  int m = state.range(0), k = state.range(1), n = state.range(2);
+  S21Matrix a = MakeMatrix(m, k), b = MakeMatrix(k, n);
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    S21Matrix c(a);
+    c.MulMatrix(b);
+    benchmark::DoNotOptimize(c(0, 0));
+  }
+  SetRates(state, 2.0 * m * n * k, kDouble * ((double)m * k + k * n + m * n));
+}
+BENCHMARK(BM_MulMatrix)->Apply(GemmShapes)->Unit(benchmark::kMillisecond);
+
+void BM_OperatorMulMatrix(benchmark::State& state) {
+  int m = state.range(0), k = state.range(1), n = state.range(2);
+  S21Matrix a = MakeMatrix(m, k), b = MakeMatrix(k, n), c;
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    c = a * b;
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, 2.0 * m * n * k, kDouble * ((double)m * k + k * n + m * n));
+}
+BENCHMARK(BM_OperatorMulMatrix)
+    ->Apply(GemmShapes)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_OperatorMulAssignMatrix(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeMatrix(n, n), b = MakeSquare(n);
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    a *= b;
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, 2.0 * n * n * n, 3 * kDouble * n * n);
+}
+BENCHMARK(BM_OperatorMulAssignMatrix)
+    ->Apply(SquareShapes2048)
+    ->Unit(benchmark::kMillisecond);
+
+// Матрица m x n на вектор (аргумент 2: 0 - a * x для столбца n x 1,
+// 1 - x^T * a для строки 1 x m, 2 - MulVector, 3 - VectorMul в готовый
+// буфер без выделения памяти)
+void BM_MulVector(benchmark::State& state) {
+  int m = state.range(0), n = state.range(1), mode = state.range(2);
+  S21Matrix a = MakeMatrix(m, n), x = MakeMatrix(n, 1), xt = MakeMatrix(1, m);
+  S21Matrix c;
+  std::vector<double> y(std::max(m, n));
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    if (mode == 0) {
+      c = a * x;
+    } else if (mode == 1) {
+      c = xt * a;
+    } else if (mode == 2) {
+      a.MulVector(x.data(), y.data());
+    } else {
+      a.VectorMul(xt.data(), y.data());
+    }
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, 2.0 * m * n, kDouble * (double)m * n);
+}
+BENCHMARK(BM_MulVector)
+    ->ArgsProduct({{4096}, {4096}, {0, 1, 2, 3}})
+    ->ArgsProduct({{1000000}, {16}, {0, 1, 2, 3}})
+    ->ArgsProduct({{16}, {1000000}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Штрассен–Виноград с порогом crossover (0 - классический Gemm); скорость
+// в эквивалентных операциях классического умножения 2 * m * n * k
+void BM_MulMatrixStrassen(benchmark::State& state) {
+  int m = state.range(0), k = state.range(1), n = state.range(2);
+  S21Matrix a = MakeMatrix(m, k), b = MakeMatrix(k, n), c;
+  s21::SetStrassenCrossover(state.range(3));
+  for (auto _ : state) {
+    c = a * b;
+    benchmark::ClobberMemory();
+  }
+  s21::SetStrassenCrossover(0);
+  SetRates(state, 2.0 * m * n * k, kDouble * ((double)m * k + k * n + m * n));
+}
+BENCHMARK(BM_MulMatrixStrassen)
+    ->Apply(StrassenShapes)
+    ->Unit(benchmark::kMillisecond);
+
+//-------------Определитель, обращение, разложения-------------------
+
+void BM_Determinant(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeSquare(n);
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    DropFactors(a);
+    benchmark::DoNotOptimize(a.Determinant());
+  }
+  SetRates(state, 2.0 / 3 * n * n * n, kDouble * n * n);
+}
+BENCHMARK(BM_Determinant)
+    ->Apply(SquareShapes4096)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_InverseMatrix(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeSquare(n);
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    DropFactors(a);
+    S21Matrix inv = a.InverseMatrix();
+    benchmark::DoNotOptimize(inv(0, 0));
+  }
+  SetRates(state, 2.0 * n * n * n, 2 * kDouble * n * n);
+}
+BENCHMARK(BM_InverseMatrix)
+    ->Apply(SquareShapes2048)
+    ->Unit(benchmark::kMillisecond);
+
+// Determinant, затем InverseMatrix той же матрицы (аргумент 1: 0 - разложение
+// сброшено перед InverseMatrix, как без сохранения, 1 - InverseMatrix берет
+// LU-разложение, сохраненное Determinant)
+void BM_DeterminantThenInverse(benchmark::State& state) {
+  int n = state.range(0), reuse = state.range(1);
+  S21Matrix a = MakeSquare(n);
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    DropFactors(a);
+    benchmark::DoNotOptimize(a.Determinant());
+    if (!reuse) DropFactors(a);
+    S21Matrix inv = a.InverseMatrix();
+    benchmark::DoNotOptimize(inv(0, 0));
+  }
+}
+BENCHMARK(BM_DeterminantThenInverse)
+    ->ArgsProduct({{256, 1024}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+// Ax = B для n x k правых частей: через обращение, прямое решение и
+// смешанная точность (аргумент 2: 0 - InverseMatrix() * B, 1 - Solve,
+// 2 - Solve(kMixedPrecision))
+void BM_Solve(benchmark::State& state) {
+  int n = state.range(0), k = state.range(1), mode = state.range(2);
+  S21Matrix a = MakeSquare(n), b = MakeMatrix(n, k), x;
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    DropFactors(a);
+    if (mode == 0) {
+      x = a.InverseMatrix() * b;
+    } else {
+      x = a.Solve(b, mode == 1 ? s21::SolveMode::kDirect
+                               : s21::SolveMode::kMixedPrecision);
+    }
+    benchmark::DoNotOptimize(x(0, 0));
+  }
+  SetRates(state, 2.0 / 3 * n * n * n + 2.0 * n * n * k,
+           kDouble * ((double)n * n + 2.0 * n * k));
+}
+BENCHMARK(BM_Solve)
+    ->ArgsProduct({{256, 1024, 2048}, {1, 64}, {0, 1, 2}})
+    ->Unit(benchmark::kMillisecond);
+
+// Симметричная положительно определенная матрица (диагональное
+// преобладание) для путей через разложение Холецкого
+S21Matrix MakeSpd(int n) {
+  S21Matrix m(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) m(i, j) = ((i + j) % 17 - 8) * 0.1 / n;
+    m(i, i) += 2;
+  }
+  return m;
+}
+
+// SPD матрица: 0 - DeterminantSPD, 1 - InverseMatrixSPD, 2 - SolveSPD на 64
+// правые части; общий путь для сравнения - BM_Determinant, BM_InverseMatrix
+// и BM_Solve
+void BM_Spd(benchmark::State& state) {
+  int n = state.range(0), op = state.range(1);
+  S21Matrix a = MakeSpd(n), b = MakeMatrix(n, 64), x;
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    DropFactors(a);
+    if (op == 0) {
+      benchmark::DoNotOptimize(a.DeterminantSPD());
+    } else {
+      x = op == 1 ? a.InverseMatrixSPD() : a.SolveSPD(b);
+      benchmark::DoNotOptimize(x(0, 0));
+    }
+  }
+  double flops = op == 1 ? 1.0 * n * n * n : 1.0 / 3 * n * n * n;
+  if (op == 2) flops += 2.0 * n * n * 64;
+  SetRates(state, flops, 2 * kDouble * n * n);
+}
+BENCHMARK(BM_Spd)
+    ->ArgsProduct({{256, 1024, 2048}, {0, 1, 2}})
+    ->Unit(benchmark::kMillisecond);
+
+// Наименьшие квадраты для высокой m x n матрицы и одной правой части:
+// аргумент 2: 0 - нормальные уравнения (A^T * A) * x = A^T * b через
+// Transpose, MulMatrix и Solve, 1 - LeastSquares (QR)
+void BM_LeastSquares(benchmark::State& state) {
+  int m = state.range(0), n = state.range(1), mode = state.range(2);
+  S21Matrix a = MakeMatrix(m, n), b = MakeMatrix(m, 1), x;
+  for (int i = 0; i < n; i++) a(i, i) += 1;
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    if (mode == 0) {
+      S21Matrix at = a.Transpose();
+      x = (at * a).Solve(at * b);
+    } else {
+      DropFactors(a);
+      x = a.LeastSquares(b);
+    }
+    benchmark::DoNotOptimize(x(0, 0));
+  }
+  SetRates(state, 2.0 * m * n * n, kDouble * (double)m * (n + 1));
+}
+BENCHMARK(BM_LeastSquares)
+    ->ArgsProduct({{100000}, {16, 128}, {0, 1}})
+    ->Args({2000000, 8, 0})
+    ->Args({2000000, 8, 1})
+    ->Args({2048, 512, 0})
+    ->Args({2048, 512, 1})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_CalcComplements(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeSquare(n);
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    DropFactors(a);
+    S21Matrix c = a.CalcComplements();
+    benchmark::DoNotOptimize(c(0, 0));
+  }
+  SetRates(state, 2.0 * n * n * n, 2 * kDouble * n * n);
+}
+BENCHMARK(BM_CalcComplements)
+    ->Apply(SquareShapes2048)
+    ->Unit(benchmark::kMillisecond);
+
+// Вырожденная матрица: ветка с полным выбором ведущего элемента, O(n^3)
+void BM_CalcComplementsSingular(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeSquare(n);
+  for (int j = 0; j < n; j++) a(n - 1, j) = a(0, j);
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    DropFactors(a);
+    S21Matrix c = a.CalcComplements();
+    benchmark::DoNotOptimize(c(0, 0));
+  }
+  SetRates(state, 2.0 / 3 * n * n * n, 2 * kDouble * n * n);
+}
+BENCHMARK(BM_CalcComplementsSingular)
+    ->Args({8, 8})
+    ->Args({64, 64})
+    ->Args({512, 512})
+    ->Unit(benchmark::kMillisecond);
+
+// Минор через вычеркивание строки и столбца (вспомогательная операция)
+void BM_CreateMiniMatrix(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeSquare(n);
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    S21Matrix minor = a.CreateMiniMatrix(n / 2, n / 2);
+    benchmark::DoNotOptimize(minor(0, 0));
+  }
+  SetRates(state, 0, 2 * kDouble * n * n);
+}
+BENCHMARK(BM_CreateMiniMatrix)->Args({8, 8})->Args({512, 512});
+
+void BM_LUInPlace(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeSquare(n);
+  std::vector<int> perm;
+  AllocationCounter allocs(state);
+  for (auto _ : state) {
+    S21Matrix lu(a);
+    benchmark::DoNotOptimize(lu.LUInPlace(perm));
+  }
+  SetRates(state, 2.0 / 3 * n * n * n, 2 * kDouble * n * n);
+}
+BENCHMARK(BM_LUInPlace)
+    ->Apply(SquareShapes4096)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_LU(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeSquare(n), l, u;
+  std::vector<int> perm;
+  AllocationCounter allocs(state);
+  for (auto _ : state) benchmark::DoNotOptimize(a.LU(l, u, perm));
+  SetRates(state, 2.0 / 3 * n * n * n, 3 * kDouble * n * n);
+}
+BENCHMARK(BM_LU)->Apply(SquareShapes2048)->Unit(benchmark::kMillisecond);
+
+//-------------Виды-------------------
+
+// Сумма блоков 64 x 64 по всей матрице: через виды без копирования ...
+void BM_BlockSumView(benchmark::State& state) {
+  int n = state.range(0), b = 64;
+  S21Matrix m = MakeMatrix(n, n), acc(b, b);
+  for (auto _ : state) {
+    for (int i = 0; i < n; i += b) {
+      for (int j = 0; j < n; j += b) acc += m.Block(i, j, b, b);
+    }
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, (double)n * n, kDouble * n * n);
+}
+BENCHMARK(BM_BlockSumView)->Arg(2048);
+
+// ... и с копированием каждого блока в отдельную матрицу
+void BM_BlockSumCopy(benchmark::State& state) {
+  int n = state.range(0), b = 64;
+  S21Matrix m = MakeMatrix(n, n), acc(b, b);
+  for (auto _ : state) {
+    for (int i = 0; i < n; i += b) {
+      for (int j = 0; j < n; j += b) {
+        S21Matrix block(b, b);
+        for (int r = 0; r < b; r++) {
+          for (int c = 0; c < b; c++) block(r, c) = m(i + r, j + c);
+        }
+        acc += block;
+      }
+    }
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, (double)n * n, kDouble * n * n);
+}
+BENCHMARK(BM_BlockSumCopy)->Arg(2048);
+
+// A^T * B через транспонированный вид: Gemm читает A по шагам
+void BM_MulTransposedView(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeMatrix(n, n), b = MakeMatrix(n, n);
+  for (auto _ : state) {
+    S21Matrix c = a.view().Transposed() * b;
+    benchmark::DoNotOptimize(c(0, 0));
+  }
+  SetRates(state, 2.0 * n * n * n, 3 * kDouble * n * n);
+}
+BENCHMARK(BM_MulTransposedView)->Arg(1024)->Unit(benchmark::kMillisecond);
+
+//-------------Типы элементов-------------------
+
+// Одни и те же операции для float, double и long double: у float вдвое
+// меньше байт на элемент и вдвое шире вектор, у long double векторов нет
+template <typename T>
+S21BasicMatrix<T> MakeMatrixOf(int rows, int cols) {
+  S21BasicMatrix<T> m(rows, cols);
+  m.sequent_filling(T(0.5), T(1) / ((T)rows * cols + 1));
+  return m;
+}
+
+template <typename T>
+void BM_SumMatrixOf(benchmark::State& state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21BasicMatrix<T> a = MakeMatrixOf<T>(rows, cols);
+  S21BasicMatrix<T> b = MakeMatrixOf<T>(rows, cols);
+  for (auto _ : state) {
+    a.SumMatrix(b);
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, (double)rows * cols, 3.0 * sizeof(T) * rows * cols);
+}
+BENCHMARK_TEMPLATE(BM_SumMatrixOf, float)->Args({1024, 1024});
+BENCHMARK_TEMPLATE(BM_SumMatrixOf, double)->Args({1024, 1024});
+BENCHMARK_TEMPLATE(BM_SumMatrixOf, long double)->Args({1024, 1024});
+
+template <typename T>
+void BM_MulMatrixOf(benchmark::State& state) {
+  int n = state.range(0);
+  S21BasicMatrix<T> a = MakeMatrixOf<T>(n, n), b = MakeMatrixOf<T>(n, n);
+  for (auto _ : state) {
+    S21BasicMatrix<T> c = a * b;
+    benchmark::DoNotOptimize(c(0, 0));
+  }
+  SetRates(state, 2.0 * n * n * n, 3.0 * sizeof(T) * n * n);
+}
+BENCHMARK_TEMPLATE(BM_MulMatrixOf, float)
+    ->Arg(512)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_MulMatrixOf, double)
+    ->Arg(512)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_MulMatrixOf, long double)
+    ->Arg(512)
+    ->Unit(benchmark::kMillisecond);
+
+template <typename T>
+void BM_InverseMatrixOf(benchmark::State& state) {
+  int n = state.range(0);
+  S21BasicMatrix<T> a(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) a(i, j) = T((i * 7 + j * 13) % 17 - 8) / 100;
+    a(i, i) += 2;
+  }
+  for (auto _ : state) {
+    DropFactors(a);
+    S21BasicMatrix<T> inv = a.InverseMatrix();
+    benchmark::DoNotOptimize(inv(0, 0));
+  }
+  SetRates(state, 2.0 * n * n * n, 2.0 * sizeof(T) * n * n);
+}
+BENCHMARK_TEMPLATE(BM_InverseMatrixOf, float)
+    ->Arg(512)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_InverseMatrixOf, double)
+    ->Arg(512)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_InverseMatrixOf, long double)
+    ->Arg(512)
+    ->Unit(benchmark::kMillisecond);
+
+//-------------Пакеты маленьких матриц-------------------
+
+// Пакет count матриц n x n с диагональным преобладанием
+template <typename T>
+S21BasicMatrixBatch<T> MakeBatchOf(int count, int n) {
+  S21BasicMatrixBatch<T> batch(count, n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      T* p = batch.plane(i, j);
+      for (int b = 0; b < count; b++) {
+        p[b] = T((b * 31 + i * 7 + j * 17) % 23 - 11) + (i == j ? 40 : 0);
+      }
+    }
+  }
+  return batch;
+}
+
+template <typename T>
+void BM_BatchDeterminant(benchmark::State& state) {
+  int n = state.range(0), count = state.range(1);
+  S21BasicMatrixBatch<T> batch = MakeBatchOf<T>(count, n);
+  for (auto _ : state) {
+    std::vector<T> det = batch.Determinant();
+    benchmark::DoNotOptimize(det.data());
+  }
+  SetRates(state, count, (double)sizeof(T) * n * n * count);
+}
+BENCHMARK_TEMPLATE(BM_BatchDeterminant, float)
+    ->Args({3, 1 << 20})
+    ->Args({4, 1 << 20})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_BatchDeterminant, double)
+    ->Args({3, 1 << 20})
+    ->Args({4, 1 << 20})
+    ->Unit(benchmark::kMillisecond);
+
+template <typename T>
+void BM_BatchInverse(benchmark::State& state) {
+  int n = state.range(0), count = state.range(1);
+  S21BasicMatrixBatch<T> batch = MakeBatchOf<T>(count, n);
+  for (auto _ : state) {
+    S21BasicMatrixBatch<T> inv = batch.InverseMatrix();
+    benchmark::DoNotOptimize(inv.plane(0, 0));
+  }
+  SetRates(state, count, 2.0 * sizeof(T) * n * n * count);
+}
+BENCHMARK_TEMPLATE(BM_BatchInverse, float)
+    ->Args({3, 1 << 20})
+    ->Args({4, 1 << 20})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_BatchInverse, double)
+    ->Args({3, 1 << 20})
+    ->Args({4, 1 << 20})
+    ->Unit(benchmark::kMillisecond);
+
+// Для сравнения: те же матрицы по одной через S21Matrix
+void BM_BatchInverseOneByOne(benchmark::State& state) {
+  int n = state.range(0), count = state.range(1);
+  std::vector<S21Matrix> matrices = MakeBatchOf<double>(count, n).ToMatrices();
+  std::vector<S21Matrix> inv(count);
+  for (auto _ : state) {
+    for (int b = 0; b < count; b++) {
+      DropFactors(matrices[b]);
+      inv[b] = matrices[b].InverseMatrix();
+    }
+    benchmark::DoNotOptimize(inv.data());
+  }
+  SetRates(state, count, 2.0 * sizeof(double) * n * n * count);
+}
+BENCHMARK(BM_BatchInverseOneByOne)
+    ->Args({3, 1 << 20})
+    ->Args({4, 1 << 20})
+    ->Unit(benchmark::kMillisecond);
+
+template <typename T>
+void BM_BatchMulMatrix(benchmark::State& state) {
+  int n = state.range(0), count = state.range(1);
+  S21BasicMatrixBatch<T> a = MakeBatchOf<T>(count, n);
+  S21BasicMatrixBatch<T> b = MakeBatchOf<T>(count, n);
+  for (auto _ : state) {
+    S21BasicMatrixBatch<T> c = a * b;
+    benchmark::DoNotOptimize(c.plane(0, 0));
+  }
+  SetRates(state, 2.0 * n * n * n * count, 3.0 * sizeof(T) * n * n * count);
+}
+BENCHMARK_TEMPLATE(BM_BatchMulMatrix, float)
+    ->Args({4, 1 << 20})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_BatchMulMatrix, double)
+    ->Args({4, 1 << 20})
+    ->Unit(benchmark::kMillisecond);
+
+//-------------Разреженные матрицы-------------------
+
+// n x n, per_row ненулевых в строке на случайных позициях
+S21SparseMatrix MakeSparse(int n, int per_row, S21SparseMatrix::Format format) {
+  std::vector<S21SparseMatrix::Triplet> triplets;
+  unsigned state = 12345;
+  for (int i = 0; i < n; i++) {
+    for (int k = 0; k < per_row; k++) {
+      state = state * 1664525u + 1013904223u;
+      triplets.push_back({i, (int)(state >> 8) % n, 1.0 + (state & 7)});
+    }
+  }
+  return S21SparseMatrix(n, n, triplets, format);
+}
+
+void BM_SparseMulVector(benchmark::State& state) {
+  int n = state.range(0), per_row = state.range(1);
+  auto format = static_cast<S21SparseMatrix::Format>(state.range(2));
+  S21SparseMatrix a = MakeSparse(n, per_row, format);
+  std::vector<double> x(n, 1.0), y(n);
+  for (auto _ : state) {
+    a.MulVector(x.data(), y.data());
+    benchmark::DoNotOptimize(y.data());
+  }
+  SetRates(state, 2.0 * a.nnz(), (kDouble + sizeof(int)) * a.nnz());
+}
+BENCHMARK(BM_SparseMulVector)
+    ->Args({1 << 20, 8, S21SparseMatrix::kCsr})
+    ->Args({1 << 20, 8, S21SparseMatrix::kCsc});
+
+void BM_SparseMulDense(benchmark::State& state) {
+  int n = state.range(0), per_row = state.range(1), cols = state.range(2);
+  S21SparseMatrix a = MakeSparse(n, per_row, S21SparseMatrix::kCsr);
+  S21Matrix b = MakeMatrix(n, cols);
+  for (auto _ : state) {
+    S21Matrix c = a * b;
+    benchmark::DoNotOptimize(c(0, 0));
+  }
+  SetRates(state, 2.0 * a.nnz() * cols, kDouble * a.nnz() * cols);
+}
+BENCHMARK(BM_SparseMulDense)
+    ->Args({4096, 8, 512})
+    ->Unit(benchmark::kMillisecond);
+
+// Для сравнения: та же матрица (99.8% нулей) в плотном виде
+void BM_SparseAsDenseMul(benchmark::State& state) {
+  int n = state.range(0), per_row = state.range(1), cols = state.range(2);
+  S21Matrix a = MakeSparse(n, per_row, S21SparseMatrix::kCsr).ToDense();
+  S21Matrix b = MakeMatrix(n, cols);
+  for (auto _ : state) {
+    S21Matrix c = a * b;
+    benchmark::DoNotOptimize(c(0, 0));
+  }
+  SetRates(state, 2.0 * n * n * cols, kDouble * n * cols);
+}
+BENCHMARK(BM_SparseAsDenseMul)
+    ->Args({4096, 8, 512})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_SparseSum(benchmark::State& state) {
+  int n = state.range(0), per_row = state.range(1);
+  S21SparseMatrix a = MakeSparse(n, per_row, S21SparseMatrix::kCsr);
+  S21SparseMatrix b = a.Transpose();
+  for (auto _ : state) {
+    S21SparseMatrix c = a + b;
+    benchmark::DoNotOptimize(c.values().data());
+  }
+  SetRates(state, 0, 2.0 * (kDouble + sizeof(int)) * a.nnz());
+}
+BENCHMARK(BM_SparseSum)
+    ->Args({1 << 20, 8})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_SparseTranspose(benchmark::State& state) {
+  int n = state.range(0), per_row = state.range(1);
+  S21SparseMatrix a = MakeSparse(n, per_row, S21SparseMatrix::kCsr);
+  for (auto _ : state) {
+    S21SparseMatrix t = a.Transpose();
+    benchmark::DoNotOptimize(t.values().data());
+  }
+  SetRates(state, 0, 2.0 * (kDouble + sizeof(int)) * a.nnz());
+}
+BENCHMARK(BM_SparseTranspose)
+    ->Args({1 << 20, 8})
+    ->Unit(benchmark::kMillisecond);
+
+//-------------Файлы-------------------
+
+// Файл матрицы n x n (128 МБ при 4096) создается при первом обращении
+const char* MatrixFile(int n) {
+  static const char* path = "bench_matrix.bin";
+  static int saved = 0;
+  if (saved != n) {
+    s21::SaveMatrix(MakeMatrix(n, n), path, 4096);
+    saved = n;
+  }
+  return path;
+}
+
+void BM_SaveMatrix(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix m = MakeMatrix(n, n);
+  for (auto _ : state) s21::SaveMatrix(m, "bench_matrix_save.bin");
+  std::remove("bench_matrix_save.bin");
+  SetRates(state, 0, kDouble * n * n);
+}
+BENCHMARK(BM_SaveMatrix)->Arg(4096)->Unit(benchmark::kMillisecond);
+
+void BM_LoadMatrix(benchmark::State& state) {
+  int n = state.range(0);
+  const char* path = MatrixFile(n);
+  for (auto _ : state) {
+    S21Matrix m = s21::LoadMatrix<double>(path);
+    benchmark::DoNotOptimize(m(0, 0));
+  }
+  SetRates(state, 0, kDouble * n * n);
+}
+BENCHMARK(BM_LoadMatrix)->Arg(4096)->Unit(benchmark::kMillisecond);
+
+// Отображение без обращения к данным: стоимость старта
+void BM_MapMatrix(benchmark::State& state) {
+  int n = state.range(0);
+  const char* path = MatrixFile(n);
+  for (auto _ : state) {
+    const S21Matrix m =
+        s21::MapMatrix<double>(path, s21::MapMode::kReadOnly);
+    benchmark::DoNotOptimize(m.data());
+  }
+}
+BENCHMARK(BM_MapMatrix)->Arg(4096)->Unit(benchmark::kMicrosecond);
+
+// Отображение и один проход по всем элементам (страницы из кэша ОС)
+void BM_MapMatrixSum(benchmark::State& state) {
+  int n = state.range(0);
+  const char* path = MatrixFile(n);
+  for (auto _ : state) {
+    const S21Matrix m =
+        s21::MapMatrix<double>(path, s21::MapMode::kReadOnly);
+    double sum = 0;
+    const double* p = m.data();
+    for (size_t k = 0; k < (size_t)n * n; k++) sum += p[k];
+    benchmark::DoNotOptimize(sum);
+  }
+  SetRates(state, (double)n * n, kDouble * n * n);
+}
+BENCHMARK(BM_MapMatrixSum)->Arg(4096)->Unit(benchmark::kMillisecond);
+
+void BM_FormatMatrix(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix m = MakeMatrix(n, n);
+  size_t bytes = 0;
+  for (auto _ : state) {
+    std::string text = s21::FormatMatrix(m);
+    bytes = text.size();
+    benchmark::DoNotOptimize(text.data());
+  }
+  SetRates(state, 0, (double)bytes);
+}
+BENCHMARK(BM_FormatMatrix)->Arg(2048)->Unit(benchmark::kMillisecond);
+
+// bytes_per_second - скорость разбора текста
+void BM_ParseMatrix(benchmark::State& state) {
+  int n = state.range(0);
+  std::string text = s21::FormatMatrix(MakeMatrix(n, n));
+  for (auto _ : state) {
+    S21Matrix m = s21::ParseMatrix<double>(text);
+    benchmark::DoNotOptimize(m(0, 0));
+  }
+  SetRates(state, 0, (double)text.size());
+}
+BENCHMARK(BM_ParseMatrix)->Arg(2048)->Unit(benchmark::kMillisecond);
+
+// Для сравнения: поэлементное чтение оператором >>, как в fill_matrix
+void BM_ParseIostream(benchmark::State& state) {
+  int n = state.range(0);
+  std::string text = s21::FormatMatrix(MakeMatrix(n, n));
+  for (auto _ : state) {
+    std::istringstream in(text);
+    S21Matrix m(n, n);
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) in >> m(i, j);
+    }
+    benchmark::DoNotOptimize(m(0, 0));
+  }
+  SetRates(state, 0, (double)text.size());
+}
+BENCHMARK(BM_ParseIostream)->Arg(2048)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,240 @@
+#include "s21_allocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+namespace {
+
+void* aligned_new(size_t bytes) {
+  return ::operator new[](bytes, std::align_val_t(kMatrixAlign));
+}
+
+void aligned_delete(void* p) {
+  ::operator delete[](p, std::align_val_t(kMatrixAlign));
+}
+
+// Аллокатор по умолчанию (nullptr - глобальный пул) и арена текущего потока
+std::atomic<S21Allocator*> g_default{nullptr};
+thread_local S21Allocator* t_scope = nullptr;
+
+// Размер классов до 1 КБ и число классов на степень двойки после
+constexpr size_t kSmallStep = 64;
+constexpr size_t kSmallLimit = 1024;
+constexpr int kSmallClasses = kSmallLimit / kSmallStep;
+constexpr int kSubClasses = 4;
+constexpr int kClassCount = kSmallClasses + 64 * kSubClasses;
+
+}  // namespace
+
+//-------------S21Allocator-------------------
+
+S21Allocator* S21Allocator::Current() {
+  if (t_scope) return t_scope;
+  S21Allocator* allocator = g_default.load(std::memory_order_acquire);
+  return allocator ? allocator : &S21PoolAllocator::Instance();
+}
+
+void S21Allocator::SetDefault(S21Allocator* allocator) {
+  g_default.store(allocator, std::memory_order_release);
+}
+
+//-------------S21PoolAllocator-------------------
+
+/**
+ * @brief Глобальный пул. Объект никогда не разрушается, чтобы матрицы со
+ * статическим временем жизни могли вернуть буфер в любом порядке; при
+ * завершении программы кэш очищается и дальше буферы освобождаются сразу
+ */
+S21PoolAllocator& S21PoolAllocator::Instance() {
+  alignas(S21PoolAllocator) static unsigned char storage[sizeof(
+      S21PoolAllocator)];
+  static S21PoolAllocator* pool = new (storage) S21PoolAllocator();
+  static struct ExitTrim {
+    ~ExitTrim() { pool->SetMaxCachedBytes(0); }
+  } exit_trim;
+  (void)exit_trim;
+  return *pool;
+}
+
+S21PoolAllocator::S21PoolAllocator(size_t max_cached_bytes)
+    : free_(kClassCount), max_cached_(max_cached_bytes), stats_{0, 0, 0} {}
+
+S21PoolAllocator::~S21PoolAllocator() { Trim(); }
+
+/**
+ * @brief Номер класса размера и размер буфера этого класса в байтах
+ */
+size_t S21PoolAllocator::size_class(size_t bytes, size_t* class_bytes) {
+  if (bytes <= kSmallLimit) {
+    size_t k = bytes ? (bytes + kSmallStep - 1) / kSmallStep : 1;
+    *class_bytes = k * kSmallStep;
+    return k - 1;
+  }
+  // 2^e < bytes <= 2^(e + 1), шаг класса 2^(e - 2)
+  int e = 63 - __builtin_clzll((unsigned long long)(bytes - 1));
+  size_t step = size_t(1) << (e - 2);
+  size_t k = (bytes + step - 1) / step;  // 5..8
+  *class_bytes = k * step;
+  return kSmallClasses + (size_t)(e - 10) * kSubClasses + (k - 5);
+}
+
+void* S21PoolAllocator::Allocate(size_t bytes) {
+  size_t class_bytes;
+  size_t index = size_class(bytes, &class_bytes);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<void*>& list = free_[index];
+    if (!list.empty()) {
+      void* p = list.back();
+      list.pop_back();
+      stats_.cached_bytes -= class_bytes;
+      stats_.hits++;
+      return p;
+    }
+    stats_.misses++;
+  }
+  return aligned_new(class_bytes);
+}
+
+void S21PoolAllocator::Deallocate(void* p, size_t bytes) {
+  size_t class_bytes;
+  size_t index = size_class(bytes, &class_bytes);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stats_.cached_bytes + class_bytes <= max_cached_) {
+      free_[index].push_back(p);
+      stats_.cached_bytes += class_bytes;
+      return;
+    }
+  }
+  aligned_delete(p);
+}
+
+void S21PoolAllocator::Trim() {
+  std::vector<std::vector<void*>> released(kClassCount);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    released.swap(free_);
+    stats_.cached_bytes = 0;
+  }
+  for (std::vector<void*>& list : released) {
+    for (void* p : list) aligned_delete(p);
+  }
+}
+
+void S21PoolAllocator::SetMaxCachedBytes(size_t bytes) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_cached_ = bytes;
+    if (stats_.cached_bytes <= max_cached_) return;
+  }
+  Trim();
+}
+
+S21PoolAllocator::Stats S21PoolAllocator::stats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+//-------------S21ArenaScope-------------------
+
+/**
+ * @brief Арена: последовательное выделение из блоков. Живет, пока открыта
+ * область или есть хотя бы один невозвращенный буфер, и удаляет себя сама
+ */
+class S21ArenaScope::Arena : public S21Allocator {
+ public:
+  explicit Arena(size_t block_bytes) : block_bytes_(block_bytes) {}
+
+  void* Allocate(size_t size) override {
+    size_t bytes = round_up(size);
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (current_ < blocks_.size() &&
+           blocks_[current_].used + bytes > blocks_[current_].size) {
+      current_++;
+    }
+    if (current_ == blocks_.size()) {
+      size_t size = std::max(block_bytes_, bytes);
+      blocks_.push_back({static_cast<char*>(aligned_new(size)), size, 0});
+      reserved_ += size;
+    }
+    Block& block = blocks_[current_];
+    char* p = block.data + block.used;
+    block.used += bytes;
+    live_++;
+    return p;
+  }
+
+  void Deallocate(void* p, size_t size) override {
+    size_t bytes = round_up(size);
+    bool release = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      Block& block = blocks_[current_];
+      char* begin = static_cast<char*>(p);
+      // Последний выделенный буфер: его место сразу свободно
+      if (begin >= block.data && begin + bytes == block.data + block.used) {
+        block.used -= bytes;
+      }
+      if (--live_ == 0) {
+        for (Block& b : blocks_) b.used = 0;
+        current_ = 0;
+        release = closed_;
+      }
+    }
+    if (release) delete this;
+  }
+
+  // Конец области: блоки освобождаются сейчас или с последним буфером
+  void Close() {
+    bool release;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+      release = live_ == 0;
+    }
+    if (release) delete this;
+  }
+
+  size_t reserved_bytes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return reserved_;
+  }
+
+  ~Arena() override {
+    for (Block& block : blocks_) aligned_delete(block.data);
+  }
+
+ private:
+  struct Block {
+    char* data;
+    size_t size, used;
+  };
+
+  static size_t round_up(size_t bytes) {
+    return (bytes + kMatrixAlign - 1) / kMatrixAlign * kMatrixAlign;
+  }
+
+  std::mutex mutex_;
+  std::vector<Block> blocks_;
+  size_t current_ = 0;
+  size_t live_ = 0;
+  size_t reserved_ = 0;
+  size_t block_bytes_;
+  bool closed_ = false;
+};
+
+S21ArenaScope::S21ArenaScope(size_t block_bytes)
+    : arena_(new Arena(block_bytes)), previous_(t_scope) {
+  t_scope = arena_;
+}
+
+S21ArenaScope::~S21ArenaScope() {
+  t_scope = previous_;
+  arena_->Close();
+}
+
+size_t S21ArenaScope::reserved_bytes() const {
+  return arena_->reserved_bytes();
+}
@@ -0,0 +1,107 @@
+#ifndef __S21ALLOCATOR_H__
+#define __S21ALLOCATOR_H__
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+// Выравнивание буфера матрицы в байтах (кэш-линия, вектор AVX-512)
+constexpr size_t kMatrixAlign = 64;
+
+/**
+ * @brief Источник памяти для буферов матриц
+ * Буфер выделяется аллокатором, текущим для потока на момент создания
+ * матрицы, и возвращается ему же в деструкторе (матрица запоминает
+ * аллокатор). Все буферы выровнены на kMatrixAlign
+ */
+class S21Allocator {
+ public:
+  virtual ~S21Allocator() = default;
+  // Буфер размером bytes байт. Размер в байтах, а не в элементах: один
+  // аллокатор обслуживает матрицы любого типа элемента
+  virtual void* Allocate(size_t bytes) = 0;
+  // bytes - тот же размер, что был передан в Allocate
+  virtual void Deallocate(void* p, size_t bytes) = 0;
+
+  // Аллокатор для новых матриц: арена активной S21ArenaScope этого потока,
+  // иначе аллокатор по умолчанию
+  static S21Allocator* Current();
+  // Задать аллокатор по умолчанию для всех потоков (nullptr - пул
+  // S21PoolAllocator::Instance()). Аллокатор должен пережить все матрицы,
+  // созданные через него
+  static void SetDefault(S21Allocator* allocator);
+};
+
+/**
+ * @brief Пул буферов по классам размеров
+ * Размер округляется вверх до класса: кратного 64 байтам до 1 КБ, дальше по 4
+ * класса на каждую степень двойки (потери не больше 25%). Освобожденные
+ * буферы не отдаются системе, а складываются в список своего класса и
+ * переиспользуются следующими матрицами того же класса, пока общий объем
+ * кэша не превышает предел
+ */
+class S21PoolAllocator : public S21Allocator {
+ public:
+  // Глобальный пул - аллокатор по умолчанию
+  static S21PoolAllocator& Instance();
+
+  explicit S21PoolAllocator(size_t max_cached_bytes = kDefaultMaxCached);
+  ~S21PoolAllocator() override;
+  S21PoolAllocator(const S21PoolAllocator&) = delete;
+  S21PoolAllocator& operator=(const S21PoolAllocator&) = delete;
+
+  void* Allocate(size_t bytes) override;
+  void Deallocate(void* p, size_t bytes) override;
+
+  // Вернуть системе все закэшированные буферы
+  void Trim();
+  // Предел объема кэша (0 - не кэшировать). Лишние буферы сразу освобождаются
+  void SetMaxCachedBytes(size_t bytes);
+
+  struct Stats {
+    size_t hits;          // выделений из кэша
+    size_t misses;        // выделений из системы
+    size_t cached_bytes;  // объем свободных буферов в кэше
+  };
+  Stats stats();
+
+  static constexpr size_t kDefaultMaxCached = size_t(256) << 20;
+
+ private:
+  static size_t size_class(size_t bytes, size_t* class_bytes);
+
+  std::mutex mutex_;
+  std::vector<std::vector<void*>> free_;
+  size_t max_cached_;
+  Stats stats_;
+};
+
+/**
+ * @brief Арена на время области видимости
+ * Пока объект жив, все матрицы, создаваемые в этом потоке, берут память
+ * последовательно из крупных блоков арены; освобождение почти бесплатно (при
+ * освобождении последнего выделенного буфера место сразу переиспользуется, а
+ * когда живых буферов не остается, арена начинается заново). При выходе из
+ * области блоки освобождаются разом. Матрицы, пережившие область (например,
+ * возвращенные из функции), остаются корректными: блоки арены освобождаются
+ * вместе с последней из них. Области могут быть вложенными
+ */
+class S21ArenaScope {
+ public:
+  explicit S21ArenaScope(size_t block_bytes = kDefaultBlock);
+  ~S21ArenaScope();
+  S21ArenaScope(const S21ArenaScope&) = delete;
+  S21ArenaScope& operator=(const S21ArenaScope&) = delete;
+
+  // Объем памяти, занятой блоками арены
+  size_t reserved_bytes() const;
+
+  static constexpr size_t kDefaultBlock = size_t(4) << 20;
+
+ private:
+  class Arena;
+  Arena* arena_;
+  S21Allocator* previous_;
+};
+
+#endif
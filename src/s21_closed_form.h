@@ -0,0 +1,70 @@
+#ifndef __S21CLOSEDFORM_H__
+#define __S21CLOSEDFORM_H__
+
+namespace s21 {
+
+/**
+ * @brief Определитель и (если Adj) присоединенная матрица r = adj(a)
+ * row-major матрицы N x N (N <= 4) явными формулами: у 4x4 разложение по
+ * 2 x 2 минорам верхней (s) и нижней (c) пар строк. V - тип элемента или
+ * векторный тип GCC (по матрице в каждой полосе), поэтому формулы общие у
+ * S21FixedMatrix и пакетов S21BasicMatrixBatch. Функция всегда встраивается,
+ * чтобы векторы считались с набором инструкций вызывающего ядра
+ */
+template <int N, bool Adj, typename V>
+[[gnu::always_inline]] constexpr void ClosedFormDetAdj(const V* a, V& det,
+                                                       V* r) {
+  static_assert(N >= 1 && N <= 4, "Явные формулы только до 4 x 4");
+  if constexpr (N == 1) {
+    det = a[0];
+    if constexpr (Adj) r[0] = a[0] * 0 + 1;
+  } else if constexpr (N == 2) {
+    det = a[0] * a[3] - a[1] * a[2];
+    if constexpr (Adj) {
+      r[0] = a[3], r[1] = -a[1];
+      r[2] = -a[2], r[3] = a[0];
+    }
+  } else if constexpr (N == 3) {
+    V r0 = a[4] * a[8] - a[5] * a[7], r3 = a[5] * a[6] - a[3] * a[8];
+    V r6 = a[3] * a[7] - a[4] * a[6];
+    det = a[0] * r0 + a[1] * r3 + a[2] * r6;
+    if constexpr (Adj) {
+      r[0] = r0, r[1] = a[2] * a[7] - a[1] * a[8];
+      r[2] = a[1] * a[5] - a[2] * a[4], r[3] = r3;
+      r[4] = a[0] * a[8] - a[2] * a[6], r[5] = a[2] * a[3] - a[0] * a[5];
+      r[6] = r6, r[7] = a[1] * a[6] - a[0] * a[7];
+      r[8] = a[0] * a[4] - a[1] * a[3];
+    }
+  } else {
+    V s[6] = {a[0] * a[5] - a[4] * a[1], a[0] * a[6] - a[4] * a[2],
+              a[0] * a[7] - a[4] * a[3], a[1] * a[6] - a[5] * a[2],
+              a[1] * a[7] - a[5] * a[3], a[2] * a[7] - a[6] * a[3]};
+    V c[6] = {a[8] * a[13] - a[12] * a[9], a[8] * a[14] - a[12] * a[10],
+              a[8] * a[15] - a[12] * a[11], a[9] * a[14] - a[13] * a[10],
+              a[9] * a[15] - a[13] * a[11], a[10] * a[15] - a[14] * a[11]};
+    det = s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] -
+          s[4] * c[1] + s[5] * c[0];
+    if constexpr (Adj) {
+      r[0] = a[5] * c[5] - a[6] * c[4] + a[7] * c[3];
+      r[1] = -a[1] * c[5] + a[2] * c[4] - a[3] * c[3];
+      r[2] = a[13] * s[5] - a[14] * s[4] + a[15] * s[3];
+      r[3] = -a[9] * s[5] + a[10] * s[4] - a[11] * s[3];
+      r[4] = -a[4] * c[5] + a[6] * c[2] - a[7] * c[1];
+      r[5] = a[0] * c[5] - a[2] * c[2] + a[3] * c[1];
+      r[6] = -a[12] * s[5] + a[14] * s[2] - a[15] * s[1];
+      r[7] = a[8] * s[5] - a[10] * s[2] + a[11] * s[1];
+      r[8] = a[4] * c[4] - a[5] * c[2] + a[7] * c[0];
+      r[9] = -a[0] * c[4] + a[1] * c[2] - a[3] * c[0];
+      r[10] = a[12] * s[4] - a[13] * s[2] + a[15] * s[0];
+      r[11] = -a[8] * s[4] + a[9] * s[2] - a[11] * s[0];
+      r[12] = -a[4] * c[3] + a[5] * c[1] - a[6] * c[0];
+      r[13] = a[0] * c[3] - a[1] * c[1] + a[2] * c[0];
+      r[14] = -a[12] * s[3] + a[13] * s[1] - a[14] * s[0];
+      r[15] = a[8] * s[3] - a[9] * s[1] + a[10] * s[0];
+    }
+  }
+}
+
+}  // namespace s21
+
+#endif
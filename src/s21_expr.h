@@ -0,0 +1,225 @@
+#ifndef __S21EXPR_H__
+#define __S21EXPR_H__
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "s21_simd.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define S21_EXPR_X86 1
+#endif
+
+template <typename T>
+class S21BasicMatrix;
+
+namespace s21 {
+
+/**
+ * Шаблоны выражений для поэлементных операций (+, -, умножение на число).
+ * Выражение вида a + b * 2 - c не считается сразу, а собирается в дерево
+ * узлов и вычисляется при присваивании в S21Matrix одним проходом: каждый
+ * элемент результата читается из операндов и записывается ровно один раз,
+ * без промежуточных матриц. Все операнды выражения - матрицы одного типа
+ * элемента (value_type узла). Узлы ссылаются на матрицы-операнды по
+ * указателю, а временные матрицы (a + Make()) забирают себе, поэтому
+ * выражение, сохраненное в auto, действительно, пока живы его именованные
+ * операнды, и отражает их текущие значения
+ */
+
+// Векторный тип GCC из элементов T размером Bytes байт: операции над ним
+// компилируются под набор инструкций функции, в которую встроен цикл
+// вычисления
+template <typename T, size_t Bytes>
+struct ExprVec {
+  typedef T type __attribute__((vector_size(Bytes)));
+};
+
+// Лист дерева: непрерывный буфер матрицы rows x cols
+template <typename T>
+class ExprLeaf {
+ public:
+  using value_type = T;
+  ExprLeaf(const T* data, int rows, int cols)
+      : data_(data), rows_(rows), cols_(cols) {}
+  int rows() const { return rows_; }
+  int cols() const { return cols_; }
+  // v = элементы [k, k + длина V) (V - T или векторный тип)
+  template <typename V>
+  void load(size_t k, V& v) const {
+    memcpy(&v, data_ + k, sizeof(V));
+  }
+
+ private:
+  const T* data_;
+  int rows_, cols_;
+};
+
+struct ExprAdd {
+  template <typename V>
+  static void apply(V& a, const V& b) {
+    a += b;
+  }
+};
+
+struct ExprSub {
+  template <typename V>
+  static void apply(V& a, const V& b) {
+    a -= b;
+  }
+};
+
+// Поэлементная операция над двумя поддеревьями одного размера
+template <typename L, typename R, typename Op>
+class ExprBinary {
+ public:
+  using value_type = typename L::value_type;
+  ExprBinary(const L& l, const R& r) : l_(l), r_(r) {}
+  int rows() const { return l_.rows(); }
+  int cols() const { return l_.cols(); }
+  template <typename V>
+  void load(size_t k, V& v) const {
+    V rhs;
+    l_.load(k, v);
+    r_.load(k, rhs);
+    Op::apply(v, rhs);
+  }
+
+ private:
+  L l_;
+  R r_;
+};
+
+// Умножение поддерева на число
+template <typename E>
+class ExprScale {
+ public:
+  using value_type = typename E::value_type;
+  ExprScale(const E& e, value_type num) : e_(e), num_(num) {}
+  int rows() const { return e_.rows(); }
+  int cols() const { return e_.cols(); }
+  template <typename V>
+  void load(size_t k, V& v) const {
+    e_.load(k, v);
+    v *= num_;
+  }
+
+ private:
+  E e_;
+  value_type num_;
+};
+
+/**
+ * @brief Невычисленное выражение над матрицами, результат операторов +, - и
+ * умножения на число. Преобразуется в матрицу того же типа элемента при
+ * инициализации или присваивании. Читающие методы матрицы доступны и у
+ * выражения: (a + b)(i, j) считает один элемент, остальные вычисляют
+ * выражение во временную матрицу (определены в s21_matrix_oop.h)
+ */
+template <typename E>
+class S21Expr {
+ public:
+  using value_type = typename E::value_type;
+  using Matrix = S21BasicMatrix<value_type>;
+  explicit S21Expr(const E& node) : node_(node) {}
+  int rows() const { return node_.rows(); }
+  int cols() const { return node_.cols(); }
+  const E& node() const { return node_; }
+
+  int acc_rows() const { return rows(); }
+  int acc_cols() const { return cols(); }
+  value_type operator()(int rows, int cols) const;
+  Matrix eval() const;
+  bool EqMatrix(const Matrix& other) const;
+  Matrix Transpose() const;
+  value_type Determinant() const;
+  Matrix CalcComplements() const;
+  Matrix CreateMiniMatrix(int r, int c) const;
+  Matrix InverseMatrix() const;
+
+ private:
+  E node_;
+};
+
+namespace expr_detail {
+
+/**
+ * @brief Цикл вычисления: векторы ширины V, хвост поэлементно. Каждый
+ * элемент dst зависит только от элементов операндов с тем же индексом,
+ * поэтому dst может совпадать с одним из операндов
+ */
+template <typename V, typename T, typename E>
+inline __attribute__((always_inline)) void EvalLoop(T* dst, const E& e,
+                                                    size_t n) {
+  const size_t width = sizeof(V) / sizeof(T);
+  size_t k = 0;
+  for (; k + width <= n; k += width) {
+    V v;
+    e.load(k, v);
+    memcpy(dst + k, &v, sizeof(V));
+  }
+  for (; k < n; k++) e.load(k, dst[k]);
+}
+
+template <typename T, typename E>
+void EvalScalar(T* dst, const E& e, size_t n) {
+  EvalLoop<T>(dst, e, n);
+}
+
+#ifdef S21_EXPR_X86
+template <typename T, typename E>
+__attribute__((target("sse2"))) void EvalSse2(T* dst, const E& e, size_t n) {
+  EvalLoop<typename ExprVec<T, 16>::type>(dst, e, n);
+}
+
+template <typename T, typename E>
+__attribute__((target("avx2"))) void EvalAvx2(T* dst, const E& e, size_t n) {
+  EvalLoop<typename ExprVec<T, 32>::type>(dst, e, n);
+}
+
+template <typename T, typename E>
+__attribute__((target("avx512f"))) void EvalAvx512(T* dst, const E& e,
+                                                   size_t n) {
+  EvalLoop<typename ExprVec<T, 64>::type>(dst, e, n);
+}
+#endif
+
+// Векторные типы есть только для float и double (long double - x87)
+template <typename T>
+constexpr bool kVectorizable =
+    std::is_same<T, float>::value || std::is_same<T, double>::value;
+
+}  // namespace expr_detail
+
+/**
+ * @brief Вычисляет n элементов выражения в dst ядром активного для T уровня
+ * SIMD
+ */
+template <typename T, typename E>
+void EvalExpr(T* dst, const E& e, size_t n) {
+  static_assert(std::is_same<T, typename E::value_type>::value,
+                "Тип элемента выражения не совпадает с типом матрицы");
+#ifdef S21_EXPR_X86
+  if constexpr (expr_detail::kVectorizable<T>) {
+    switch (Simd<T>().level) {
+      case kSimdAvx512:
+        expr_detail::EvalAvx512(dst, e, n);
+        return;
+      case kSimdAvx2:
+        expr_detail::EvalAvx2(dst, e, n);
+        return;
+      case kSimdSse2:
+        expr_detail::EvalSse2(dst, e, n);
+        return;
+      default:
+        break;
+    }
+  }
+#endif
+  expr_detail::EvalScalar(dst, e, n);
+}
+
+}  // namespace s21
+
+#endif
@@ -0,0 +1,271 @@
+#ifndef __S21FIXEDMATRIX_H__
+#define __S21FIXEDMATRIX_H__
+
+#include <initializer_list>
+#include <limits>
+
+#include "s21_closed_form.h"
+#include "s21_matrix_oop.h"
+
+/**
+ * @brief Матрица фиксированного размера R x C (размер - часть типа)
+ * Элементы хранятся внутри объекта (на стеке), без выделения памяти. Все
+ * операции constexpr, циклы с известным на этапе компиляции числом итераций
+ * разворачиваются полностью. Определитель и обратная матрица для размеров до
+ * 4 x 4 считаются по явным формулам, для больших - методом Гаусса. Несовпадение
+ * размеров операндов - ошибка компиляции. Доступ по индексу без проверок
+ */
+template <int R, int C>
+class S21FixedMatrix {
+  static_assert(R > 0 && C > 0, "Матрица должна иметь хотя бы один элемент");
+
+ public:
+  constexpr S21FixedMatrix() : data_{} {}
+
+  /**
+   * @brief Заполнение по строкам, недостающие элементы равны 0
+   */
+  constexpr S21FixedMatrix(std::initializer_list<double> values) : data_{} {
+    if (values.size() > (size_t)R * C) S21Matrix::not_same_size();
+    int k = 0;
+    for (double v : values) data_[k++] = v;
+  }
+
+  /**
+   * @brief Копия динамической матрицы того же размера
+   */
+  explicit S21FixedMatrix(const S21Matrix& other) : data_{} {
+    if (other.acc_rows() != R || other.acc_cols() != C) {
+      S21Matrix::not_same_size();
+    }
+    const double* src = other.data();
+    for (int k = 0; k < R * C; k++) data_[k] = src[k];
+  }
+
+  // Единичная матрица
+  static constexpr S21FixedMatrix Identity() {
+    static_assert(R == C, "Единичная матрица должна быть квадратной");
+    S21FixedMatrix res;
+    for (int i = 0; i < R; i++) res.data_[i * C + i] = 1;
+    return res;
+  }
+
+  S21Matrix ToMatrix() const {
+    S21Matrix res(R, C);
+    double* dst = res.data();
+    for (int k = 0; k < R * C; k++) dst[k] = data_[k];
+    return res;
+  }
+
+  static constexpr int rows() { return R; }
+  static constexpr int cols() { return C; }
+  constexpr double& operator()(int row, int col) {
+    return data_[row * C + col];
+  }
+  constexpr double operator()(int row, int col) const {
+    return data_[row * C + col];
+  }
+
+  // Operations:
+  constexpr bool EqMatrix(const S21FixedMatrix& other) const {
+    bool equal = true;
+#pragma GCC unroll 16
+    for (int k = 0; k < R * C; k++) {
+      equal = equal && Abs(data_[k] - other.data_[k]) <= SCI_NOT;
+    }
+    return equal;
+  }
+
+  constexpr void SumMatrix(const S21FixedMatrix& other) {
+#pragma GCC unroll 16
+    for (int k = 0; k < R * C; k++) data_[k] += other.data_[k];
+  }
+
+  constexpr void SubMatrix(const S21FixedMatrix& other) {
+#pragma GCC unroll 16
+    for (int k = 0; k < R * C; k++) data_[k] -= other.data_[k];
+  }
+
+  constexpr void MulNumber(double num) {
+#pragma GCC unroll 16
+    for (int k = 0; k < R * C; k++) data_[k] *= num;
+  }
+
+  // Умножение на месте меняет размер только для квадратного множителя
+  constexpr void MulMatrix(const S21FixedMatrix<C, C>& other) {
+    *this = Mul(other);
+  }
+
+  template <int K>
+  constexpr S21FixedMatrix<R, K> Mul(const S21FixedMatrix<C, K>& other) const {
+    S21FixedMatrix<R, K> res;
+#pragma GCC unroll 4
+    for (int i = 0; i < R; i++) {
+#pragma GCC unroll 4
+      for (int j = 0; j < K; j++) {
+        double sum = 0;
+#pragma GCC unroll 4
+        for (int k = 0; k < C; k++) sum += (*this)(i, k) * other(k, j);
+        res(i, j) = sum;
+      }
+    }
+    return res;
+  }
+
+  constexpr S21FixedMatrix<C, R> Transpose() const {
+    S21FixedMatrix<C, R> res;
+#pragma GCC unroll 4
+    for (int i = 0; i < R; i++) {
+#pragma GCC unroll 4
+      for (int j = 0; j < C; j++) res(j, i) = (*this)(i, j);
+    }
+    return res;
+  }
+
+  constexpr double Determinant() const {
+    static_assert(R == C, "Определитель считается только для квадратной");
+    if constexpr (R <= 4) {
+      double det = 0;
+      s21::ClosedFormDetAdj<R, false, double>(data_, det, nullptr);
+      return det;
+    } else {
+      S21FixedMatrix work(*this);
+      return work.eliminate(nullptr);
+    }
+  }
+
+  /**
+   * @brief Обратная матрица. Исключение, если матрица вырождена: |det| не
+   * больше R * eps * (произведение максимумов модулей по столбцам)
+   */
+  constexpr S21FixedMatrix InverseMatrix() const {
+    static_assert(R == C, "Обратная матрица только для квадратной");
+    S21FixedMatrix inv;
+    if constexpr (R <= 4) {
+      double det = 0;
+      s21::ClosedFormDetAdj<R, true>(data_, det, inv.data_);
+      if (singular(det)) S21Matrix::null_determinant();
+      inv.MulNumber(1 / det);
+    } else {
+      S21FixedMatrix work(*this);
+      inv = Identity();
+      if (work.eliminate(&inv) == 0) S21Matrix::null_determinant();
+    }
+    return inv;
+  }
+
+  // Overloads:
+  constexpr bool operator==(const S21FixedMatrix& other) const {
+    return EqMatrix(other);
+  }
+  constexpr S21FixedMatrix operator+(const S21FixedMatrix& other) const {
+    S21FixedMatrix res(*this);
+    res.SumMatrix(other);
+    return res;
+  }
+  constexpr S21FixedMatrix operator-(const S21FixedMatrix& other) const {
+    S21FixedMatrix res(*this);
+    res.SubMatrix(other);
+    return res;
+  }
+  template <int K>
+  constexpr S21FixedMatrix<R, K> operator*(
+      const S21FixedMatrix<C, K>& other) const {
+    return Mul(other);
+  }
+  constexpr S21FixedMatrix operator*(double num) const {
+    S21FixedMatrix res(*this);
+    res.MulNumber(num);
+    return res;
+  }
+  friend constexpr S21FixedMatrix operator*(double num,
+                                            const S21FixedMatrix& other) {
+    return other * num;
+  }
+  constexpr S21FixedMatrix& operator+=(const S21FixedMatrix& other) {
+    SumMatrix(other);
+    return *this;
+  }
+  constexpr S21FixedMatrix& operator-=(const S21FixedMatrix& other) {
+    SubMatrix(other);
+    return *this;
+  }
+  constexpr S21FixedMatrix& operator*=(double num) {
+    MulNumber(num);
+    return *this;
+  }
+  constexpr S21FixedMatrix& operator*=(const S21FixedMatrix<C, C>& other) {
+    MulMatrix(other);
+    return *this;
+  }
+
+ private:
+  template <int, int>
+  friend class S21FixedMatrix;
+
+  static constexpr double Abs(double x) { return x < 0 ? -x : x; }
+
+  constexpr void swap_rows(int a, int b) {
+    for (int j = 0; j < C; j++) {
+      double t = (*this)(a, j);
+      (*this)(a, j) = (*this)(b, j);
+      (*this)(b, j) = t;
+    }
+  }
+
+  constexpr bool singular(double det) const {
+    double scale = 1;
+    for (int j = 0; j < C; j++) {
+      double col_max = 0;
+      for (int i = 0; i < R; i++) {
+        if (Abs((*this)(i, j)) > col_max) col_max = Abs((*this)(i, j));
+      }
+      scale *= col_max;
+    }
+    return Abs(det) <= R * std::numeric_limits<double>::epsilon() * scale;
+  }
+
+  /**
+   * @brief Исключение Гаусса с частичным выбором ведущего элемента (для
+   * размеров больше 4). Если передан rhs, те же преобразования применяются к
+   * нему и в конце он содержит A^-1 * rhs (Гаусс-Жордан)
+   * @return Определитель, 0 - матрица вырождена
+   */
+  constexpr double eliminate(S21FixedMatrix* rhs) {
+    S21FixedMatrix original(*this);
+    double det = 1;
+    for (int k = 0; k < R; k++) {
+      int p = k;
+      for (int i = k + 1; i < R; i++) {
+        if (Abs((*this)(i, k)) > Abs((*this)(p, k))) p = i;
+      }
+      if (p != k) {
+        det = -det;
+        swap_rows(k, p);
+        if (rhs) rhs->swap_rows(k, p);
+      }
+      double pivot = (*this)(k, k);
+      det *= pivot;
+      if (pivot == 0) return 0;
+      for (int i = 0; i < R; i++) {
+        if (i == k || (!rhs && i < k)) continue;
+        double l = (*this)(i, k) / pivot;
+        for (int j = k; j < C; j++) (*this)(i, j) -= l * (*this)(k, j);
+        if (rhs) {
+          for (int j = 0; j < C; j++) (*rhs)(i, j) -= l * (*rhs)(k, j);
+        }
+      }
+    }
+    if (original.singular(det)) return 0;
+    if (rhs) {
+      for (int i = 0; i < R; i++) {
+        for (int j = 0; j < C; j++) (*rhs)(i, j) /= (*this)(i, i);
+      }
+    }
+    return det;
+  }
+
+  double data_[R * C];
+};
+
+#endif
@@ -0,0 +1,869 @@
+#include "s21_gemm.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#include "s21_simd.h"
+#include "s21_thread_pool.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace s21 {
+
+namespace {
+
+//-------------Параметры блочного разбиения-------------------
+
+// Панель A (kMC x kKC) живет в L2, микропанель B (kKC x nr) - в L1,
+// панель B (kKC x kNC) - в L3. kMC и kNC кратны размерам блоков всех
+// микроядер (double: 4x4, 6x8, 8x16; float: 4x8, 6x16, 8x32)
+constexpr int kMC = 96;
+constexpr int kKC = 256;
+constexpr int kNC = 4096;
+// Произведения меньше этого объема (m * n * k) считаются без упаковки
+constexpr long long kSmallGemm = 16 * 16 * 16;
+// Начиная с этого объема блоки C раздаются потокам пула, меньшие
+// произведения считаются в вызывающем потоке без накладных расходов
+constexpr long long kParallelGemm = 128 * 128 * 128;
+// Начиная с этого объема (m * n) Gemv и Gevm делят работу между потоками
+constexpr double kParallelGemv = 1 << 17;
+// Части строк Gevm: по kGevmRows строк, но не больше kGevmParts частей;
+// ширина полосы столбцов - kGevmCols
+constexpr int kGevmRows = 2048;
+constexpr int kGevmParts = 64;
+constexpr int kGevmCols = 512;
+
+typedef double v2d __attribute__((vector_size(16)));
+typedef float v4sf __attribute__((vector_size(16)));
+
+/**
+ * @brief Микроядро и размер блока C (mr x nr), который оно держит в регистрах
+ */
+template <typename T>
+struct GemmKernel {
+  int mr, nr;
+  void (*run)(int kc, const T* a, const T* b, T alpha, T beta, T* c,
+              ptrdiff_t ldc, int mr, int nr);
+};
+
+/**
+ * @brief Буфер под упакованные панели, выровненный по кэш-линии
+ */
+class PackBuffer {
+ public:
+  PackBuffer() : data_(nullptr), size_(0) {}
+  ~PackBuffer() { release(); }
+  PackBuffer(const PackBuffer&) = delete;
+  PackBuffer& operator=(const PackBuffer&) = delete;
+
+  // Буфер под count элементов типа T (размер хранится в байтах)
+  template <typename T>
+  T* reserve(size_t count) {
+    size_t size = count * sizeof(T);
+    if (size > size_) {
+      release();
+      data_ = ::operator new[](size, std::align_val_t(64));
+      size_ = size;
+    }
+    return static_cast<T*>(data_);
+  }
+
+ private:
+  void release() {
+    if (data_) ::operator delete[](data_, std::align_val_t(64));
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  void* data_;
+  size_t size_;
+};
+
+/**
+ * @brief Рабочий буфер одного вызова: поточный буфер слота Slot, если он
+ * свободен, иначе собственный. Поток, ожидающий свои задачи в пуле, может
+ * выполнить чужой вызов, пока его поточный буфер занят
+ */
+template <int Slot>
+class ScratchBuffer {
+ public:
+  ScratchBuffer() : owns_shared_(!busy()) { busy() = true; }
+  ~ScratchBuffer() {
+    if (owns_shared_) busy() = false;
+  }
+  ScratchBuffer(const ScratchBuffer&) = delete;
+  ScratchBuffer& operator=(const ScratchBuffer&) = delete;
+
+  template <typename T>
+  T* reserve(size_t count) {
+    return (owns_shared_ ? shared() : local_).template reserve<T>(count);
+  }
+
+ private:
+  static PackBuffer& shared() {
+    static thread_local PackBuffer buffer;
+    return buffer;
+  }
+  static bool& busy() {
+    static thread_local bool flag = false;
+    return flag;
+  }
+
+  bool owns_shared_;
+  PackBuffer local_;
+};
+
+/**
+ * @brief Упаковывает блок A (mc x kc) в микропанели по mr_max строк:
+ * внутри микропанели элементы идут по k, для каждого k - mr_max строк подряд.
+ * Недостающие строки крайней микропанели дополняются нулями
+ */
+template <typename T>
+void PackA(int mc, int kc, int mr_max, const T* a, ptrdiff_t rsa,
+           ptrdiff_t csa, T* packed) {
+  for (int ir = 0; ir < mc; ir += mr_max) {
+    int mr = std::min(mr_max, mc - ir);
+    const T* src = a + ir * rsa;
+    for (int p = 0; p < kc; p++) {
+      int i = 0;
+      for (; i < mr; i++) packed[i] = src[i * rsa + p * csa];
+      for (; i < mr_max; i++) packed[i] = 0;
+      packed += mr_max;
+    }
+  }
+}
+
+/**
+ * @brief Упаковывает блок B (kc x nc) в микропанели по nr_max столбцов:
+ * для каждого k - nr_max элементов строки подряд, хвост дополняется нулями
+ */
+template <typename T>
+void PackB(int kc, int nc, int nr_max, const T* b, ptrdiff_t rsb,
+           ptrdiff_t csb, T* packed) {
+  for (int jr = 0; jr < nc; jr += nr_max) {
+    int nr = std::min(nr_max, nc - jr);
+    const T* src = b + jr * csb;
+    for (int p = 0; p < kc; p++) {
+      const T* row = src + p * rsb;
+      int j = 0;
+      if (csb == 1) {
+        for (; j < nr; j++) packed[j] = row[j];
+      } else {
+        for (; j < nr; j++) packed[j] = row[j * csb];
+      }
+      for (; j < nr_max; j++) packed[j] = 0;
+      packed += nr_max;
+    }
+  }
+}
+
+/**
+ * @brief Записывает посчитанный блок tile (MR x NR) в C с учетом alpha, beta
+ * и фактического размера блока mr x nr
+ */
+template <typename T, int MR, int NR>
+void StoreTile(const T (&tile)[MR][NR], T alpha, T beta, T* c, ptrdiff_t ldc,
+               int mr, int nr) {
+  for (int i = 0; i < mr; i++) {
+    T* row = c + i * ldc;
+    if (beta == 0) {
+      for (int j = 0; j < nr; j++) row[j] = alpha * tile[i][j];
+    } else {
+      for (int j = 0; j < nr; j++) row[j] = beta * row[j] + alpha * tile[i][j];
+    }
+  }
+}
+
+//-------------Микроядра-------------------
+
+/**
+ * @brief Микроядро: C[mr x nr] = alpha * Ap * Bp + beta * C
+ * Ap, Bp - упакованные микропанели длины kc. Блок 4 x 2W (W - число
+ * элементов в векторе V) накапливается в восьми векторных регистрах, C
+ * читается и пишется один раз. Переносимый вариант (векторные расширения
+ * GCC, 128 бит): 4x4 для double, 4x8 для float
+ */
+template <typename T, typename V>
+void MicroKernelVec(int kc, const T* a, const T* b, T alpha, T beta, T* c,
+                    ptrdiff_t ldc, int mr, int nr) {
+  constexpr int W = sizeof(V) / sizeof(T);
+  V c00 = {}, c01 = {}, c10 = {}, c11 = {};
+  V c20 = {}, c21 = {}, c30 = {}, c31 = {};
+  V a0, a1, a2, a3;
+  for (int p = 0; p < kc; p++) {
+    V b0, b1;
+    memcpy(&b0, b, sizeof(V));
+    memcpy(&b1, b + W, sizeof(V));
+    for (int l = 0; l < W; l++) a0[l] = a[0], a1[l] = a[1];
+    c00 += a0 * b0;
+    c01 += a0 * b1;
+    c10 += a1 * b0;
+    c11 += a1 * b1;
+    for (int l = 0; l < W; l++) a2[l] = a[2], a3[l] = a[3];
+    c20 += a2 * b0;
+    c21 += a2 * b1;
+    c30 += a3 * b0;
+    c31 += a3 * b1;
+    a += 4;
+    b += 2 * W;
+  }
+  T tile[4][2 * W];
+  memcpy(tile[0], &c00, sizeof(V)), memcpy(tile[0] + W, &c01, sizeof(V));
+  memcpy(tile[1], &c10, sizeof(V)), memcpy(tile[1] + W, &c11, sizeof(V));
+  memcpy(tile[2], &c20, sizeof(V)), memcpy(tile[2] + W, &c21, sizeof(V));
+  memcpy(tile[3], &c30, sizeof(V)), memcpy(tile[3] + W, &c31, sizeof(V));
+  StoreTile(tile, alpha, beta, c, ldc, mr, nr);
+}
+
+/**
+ * @brief Скалярное микроядро 4x4 для типов без векторных инструкций
+ * (long double)
+ */
+template <typename T>
+void MicroKernelScalar(int kc, const T* a, const T* b, T alpha, T beta, T* c,
+                       ptrdiff_t ldc, int mr, int nr) {
+  T tile[4][4] = {};
+  for (int p = 0; p < kc; p++) {
+    for (int i = 0; i < 4; i++) {
+      for (int j = 0; j < 4; j++) tile[i][j] += a[i] * b[j];
+    }
+    a += 4;
+    b += 4;
+  }
+  StoreTile(tile, alpha, beta, c, ldc, mr, nr);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// Одна строка блока: C[i][0..2*W) += a[i] * (b0, b1)
+#define S21_FMA_ROW(set1, fmadd, i)    \
+  {                                     \
+    auto ai = set1(a[i]);               \
+    c##i##0 = fmadd(ai, b0, c##i##0);   \
+    c##i##1 = fmadd(ai, b1, c##i##1);   \
+  }
+
+/**
+ * @brief Микроядро AVX2 + FMA: блок 6x8 в двенадцати регистрах ymm
+ */
+__attribute__((target("avx2,fma"))) void MicroKernelAvx2(
+    int kc, const double* a, const double* b, double alpha, double beta,
+    double* c, ptrdiff_t ldc, int mr, int nr) {
+  __m256d c00 = _mm256_setzero_pd(), c01 = c00, c10 = c00, c11 = c00;
+  __m256d c20 = c00, c21 = c00, c30 = c00, c31 = c00;
+  __m256d c40 = c00, c41 = c00, c50 = c00, c51 = c00;
+  for (int p = 0; p < kc; p++) {
+    __m256d b0 = _mm256_loadu_pd(b), b1 = _mm256_loadu_pd(b + 4);
+    S21_FMA_ROW(_mm256_set1_pd, _mm256_fmadd_pd, 0)
+    S21_FMA_ROW(_mm256_set1_pd, _mm256_fmadd_pd, 1)
+    S21_FMA_ROW(_mm256_set1_pd, _mm256_fmadd_pd, 2)
+    S21_FMA_ROW(_mm256_set1_pd, _mm256_fmadd_pd, 3)
+    S21_FMA_ROW(_mm256_set1_pd, _mm256_fmadd_pd, 4)
+    S21_FMA_ROW(_mm256_set1_pd, _mm256_fmadd_pd, 5)
+    a += 6;
+    b += 8;
+  }
+  double tile[6][8];
+  _mm256_storeu_pd(tile[0], c00), _mm256_storeu_pd(tile[0] + 4, c01);
+  _mm256_storeu_pd(tile[1], c10), _mm256_storeu_pd(tile[1] + 4, c11);
+  _mm256_storeu_pd(tile[2], c20), _mm256_storeu_pd(tile[2] + 4, c21);
+  _mm256_storeu_pd(tile[3], c30), _mm256_storeu_pd(tile[3] + 4, c31);
+  _mm256_storeu_pd(tile[4], c40), _mm256_storeu_pd(tile[4] + 4, c41);
+  _mm256_storeu_pd(tile[5], c50), _mm256_storeu_pd(tile[5] + 4, c51);
+  StoreTile(tile, alpha, beta, c, ldc, mr, nr);
+}
+
+/**
+ * @brief Микроядро AVX-512: блок 8x16 в шестнадцати регистрах zmm
+ */
+__attribute__((target("avx512f"))) void MicroKernelAvx512(
+    int kc, const double* a, const double* b, double alpha, double beta,
+    double* c, ptrdiff_t ldc, int mr, int nr) {
+  __m512d c00 = _mm512_setzero_pd(), c01 = c00, c10 = c00, c11 = c00;
+  __m512d c20 = c00, c21 = c00, c30 = c00, c31 = c00;
+  __m512d c40 = c00, c41 = c00, c50 = c00, c51 = c00;
+  __m512d c60 = c00, c61 = c00, c70 = c00, c71 = c00;
+  for (int p = 0; p < kc; p++) {
+    __m512d b0 = _mm512_loadu_pd(b), b1 = _mm512_loadu_pd(b + 8);
+    S21_FMA_ROW(_mm512_set1_pd, _mm512_fmadd_pd, 0)
+    S21_FMA_ROW(_mm512_set1_pd, _mm512_fmadd_pd, 1)
+    S21_FMA_ROW(_mm512_set1_pd, _mm512_fmadd_pd, 2)
+    S21_FMA_ROW(_mm512_set1_pd, _mm512_fmadd_pd, 3)
+    S21_FMA_ROW(_mm512_set1_pd, _mm512_fmadd_pd, 4)
+    S21_FMA_ROW(_mm512_set1_pd, _mm512_fmadd_pd, 5)
+    S21_FMA_ROW(_mm512_set1_pd, _mm512_fmadd_pd, 6)
+    S21_FMA_ROW(_mm512_set1_pd, _mm512_fmadd_pd, 7)
+    a += 8;
+    b += 16;
+  }
+  double tile[8][16];
+  _mm512_storeu_pd(tile[0], c00), _mm512_storeu_pd(tile[0] + 8, c01);
+  _mm512_storeu_pd(tile[1], c10), _mm512_storeu_pd(tile[1] + 8, c11);
+  _mm512_storeu_pd(tile[2], c20), _mm512_storeu_pd(tile[2] + 8, c21);
+  _mm512_storeu_pd(tile[3], c30), _mm512_storeu_pd(tile[3] + 8, c31);
+  _mm512_storeu_pd(tile[4], c40), _mm512_storeu_pd(tile[4] + 8, c41);
+  _mm512_storeu_pd(tile[5], c50), _mm512_storeu_pd(tile[5] + 8, c51);
+  _mm512_storeu_pd(tile[6], c60), _mm512_storeu_pd(tile[6] + 8, c61);
+  _mm512_storeu_pd(tile[7], c70), _mm512_storeu_pd(tile[7] + 8, c71);
+  StoreTile(tile, alpha, beta, c, ldc, mr, nr);
+}
+
+/**
+ * @brief Микроядро AVX2 + FMA для float: блок 6x16 в двенадцати регистрах ymm
+ */
+__attribute__((target("avx2,fma"))) void MicroKernelAvx2F(
+    int kc, const float* a, const float* b, float alpha, float beta,
+    float* c, ptrdiff_t ldc, int mr, int nr) {
+  __m256 c00 = _mm256_setzero_ps(), c01 = c00, c10 = c00, c11 = c00;
+  __m256 c20 = c00, c21 = c00, c30 = c00, c31 = c00;
+  __m256 c40 = c00, c41 = c00, c50 = c00, c51 = c00;
+  for (int p = 0; p < kc; p++) {
+    __m256 b0 = _mm256_loadu_ps(b), b1 = _mm256_loadu_ps(b + 8);
+    S21_FMA_ROW(_mm256_set1_ps, _mm256_fmadd_ps, 0)
+    S21_FMA_ROW(_mm256_set1_ps, _mm256_fmadd_ps, 1)
+    S21_FMA_ROW(_mm256_set1_ps, _mm256_fmadd_ps, 2)
+    S21_FMA_ROW(_mm256_set1_ps, _mm256_fmadd_ps, 3)
+    S21_FMA_ROW(_mm256_set1_ps, _mm256_fmadd_ps, 4)
+    S21_FMA_ROW(_mm256_set1_ps, _mm256_fmadd_ps, 5)
+    a += 6;
+    b += 16;
+  }
+  float tile[6][16];
+  _mm256_storeu_ps(tile[0], c00), _mm256_storeu_ps(tile[0] + 8, c01);
+  _mm256_storeu_ps(tile[1], c10), _mm256_storeu_ps(tile[1] + 8, c11);
+  _mm256_storeu_ps(tile[2], c20), _mm256_storeu_ps(tile[2] + 8, c21);
+  _mm256_storeu_ps(tile[3], c30), _mm256_storeu_ps(tile[3] + 8, c31);
+  _mm256_storeu_ps(tile[4], c40), _mm256_storeu_ps(tile[4] + 8, c41);
+  _mm256_storeu_ps(tile[5], c50), _mm256_storeu_ps(tile[5] + 8, c51);
+  StoreTile(tile, alpha, beta, c, ldc, mr, nr);
+}
+
+/**
+ * @brief Микроядро AVX-512 для float: блок 8x32 в шестнадцати регистрах zmm
+ */
+__attribute__((target("avx512f"))) void MicroKernelAvx512F(
+    int kc, const float* a, const float* b, float alpha, float beta,
+    float* c, ptrdiff_t ldc, int mr, int nr) {
+  __m512 c00 = _mm512_setzero_ps(), c01 = c00, c10 = c00, c11 = c00;
+  __m512 c20 = c00, c21 = c00, c30 = c00, c31 = c00;
+  __m512 c40 = c00, c41 = c00, c50 = c00, c51 = c00;
+  __m512 c60 = c00, c61 = c00, c70 = c00, c71 = c00;
+  for (int p = 0; p < kc; p++) {
+    __m512 b0 = _mm512_loadu_ps(b), b1 = _mm512_loadu_ps(b + 16);
+    S21_FMA_ROW(_mm512_set1_ps, _mm512_fmadd_ps, 0)
+    S21_FMA_ROW(_mm512_set1_ps, _mm512_fmadd_ps, 1)
+    S21_FMA_ROW(_mm512_set1_ps, _mm512_fmadd_ps, 2)
+    S21_FMA_ROW(_mm512_set1_ps, _mm512_fmadd_ps, 3)
+    S21_FMA_ROW(_mm512_set1_ps, _mm512_fmadd_ps, 4)
+    S21_FMA_ROW(_mm512_set1_ps, _mm512_fmadd_ps, 5)
+    S21_FMA_ROW(_mm512_set1_ps, _mm512_fmadd_ps, 6)
+    S21_FMA_ROW(_mm512_set1_ps, _mm512_fmadd_ps, 7)
+    a += 8;
+    b += 32;
+  }
+  float tile[8][32];
+  _mm512_storeu_ps(tile[0], c00), _mm512_storeu_ps(tile[0] + 16, c01);
+  _mm512_storeu_ps(tile[1], c10), _mm512_storeu_ps(tile[1] + 16, c11);
+  _mm512_storeu_ps(tile[2], c20), _mm512_storeu_ps(tile[2] + 16, c21);
+  _mm512_storeu_ps(tile[3], c30), _mm512_storeu_ps(tile[3] + 16, c31);
+  _mm512_storeu_ps(tile[4], c40), _mm512_storeu_ps(tile[4] + 16, c41);
+  _mm512_storeu_ps(tile[5], c50), _mm512_storeu_ps(tile[5] + 16, c51);
+  _mm512_storeu_ps(tile[6], c60), _mm512_storeu_ps(tile[6] + 16, c61);
+  _mm512_storeu_ps(tile[7], c70), _mm512_storeu_ps(tile[7] + 16, c71);
+  StoreTile(tile, alpha, beta, c, ldc, mr, nr);
+}
+
+#undef S21_FMA_ROW
+
+#endif
+
+//-------------Матрица на вектор-------------------
+
+/**
+ * @brief Сумма элементов вектора V (для скалярного V - сам элемент)
+ */
+template <typename T, typename V>
+inline __attribute__((always_inline)) T HorizontalSum(const V& v) {
+  if constexpr (std::is_same<T, V>::value) {
+    return v;
+  } else {
+    T sum = 0;
+    for (size_t l = 0; l < sizeof(V) / sizeof(T); l++) sum += v[l];
+    return sum;
+  }
+}
+
+/**
+ * @brief y_i = alpha * (A(i, :) * x) + beta * y_i для строк [0, rows):
+ * четыре строки за проход делят загрузки x, у каждой строки свой векторный
+ * накопитель. V - векторный тип (или сам T), загрузки невыровненные
+ */
+template <typename T, typename V>
+inline __attribute__((always_inline)) void DotRowsBody(
+    int rows, int n, T alpha, const T* a, ptrdiff_t lda, const T* x, T beta,
+    T* y, ptrdiff_t incy) {
+  constexpr int kLanes = sizeof(V) / sizeof(T);
+  auto store = [&](int i, T dot) {
+    T* out = y + i * incy;
+    *out = (beta == 0) ? alpha * dot : beta * *out + alpha * dot;
+  };
+  int i = 0;
+  for (; i + 4 <= rows; i += 4) {
+    const T* a0 = a + i * lda;
+    const T* a1 = a0 + lda;
+    const T* a2 = a1 + lda;
+    const T* a3 = a2 + lda;
+    V s0 = V(), s1 = V(), s2 = V(), s3 = V();
+    int j = 0;
+    for (; j + kLanes <= n; j += kLanes) {
+      V xv, v0, v1, v2, v3;
+      std::memcpy(&xv, x + j, sizeof(V));
+      std::memcpy(&v0, a0 + j, sizeof(V));
+      std::memcpy(&v1, a1 + j, sizeof(V));
+      std::memcpy(&v2, a2 + j, sizeof(V));
+      std::memcpy(&v3, a3 + j, sizeof(V));
+      s0 += v0 * xv;
+      s1 += v1 * xv;
+      s2 += v2 * xv;
+      s3 += v3 * xv;
+    }
+    T d0 = HorizontalSum<T>(s0), d1 = HorizontalSum<T>(s1),
+      d2 = HorizontalSum<T>(s2), d3 = HorizontalSum<T>(s3);
+    for (; j < n; j++) {
+      d0 += a0[j] * x[j];
+      d1 += a1[j] * x[j];
+      d2 += a2[j] * x[j];
+      d3 += a3[j] * x[j];
+    }
+    store(i, d0);
+    store(i + 1, d1);
+    store(i + 2, d2);
+    store(i + 3, d3);
+  }
+  for (; i < rows; i++) {
+    const T* row = a + i * lda;
+    V sum = V();
+    int j = 0;
+    for (; j + kLanes <= n; j += kLanes) {
+      V xv, v;
+      std::memcpy(&xv, x + j, sizeof(V));
+      std::memcpy(&v, row + j, sizeof(V));
+      sum += v * xv;
+    }
+    T dot = HorizontalSum<T>(sum);
+    for (; j < n; j++) dot += row[j] * x[j];
+    store(i, dot);
+  }
+}
+
+/**
+ * @brief y += alpha * (x_0 * A(0, :) + ... + x_{rows-1} * A(rows-1, :)),
+ * y непрерывен (n элементов): четыре строки A за проход, y читается и
+ * пишется один раз на четыре строки
+ */
+template <typename T, typename V>
+inline __attribute__((always_inline)) void AxpyRowsBody(
+    int rows, int n, T alpha, const T* x, ptrdiff_t incx, const T* a,
+    ptrdiff_t lda, T* y) {
+  constexpr int kLanes = sizeof(V) / sizeof(T);
+  int i = 0;
+  for (; i + 4 <= rows; i += 4) {
+    const T* a0 = a + i * lda;
+    const T* a1 = a0 + lda;
+    const T* a2 = a1 + lda;
+    const T* a3 = a2 + lda;
+    const T x0 = alpha * x[i * incx], x1 = alpha * x[(i + 1) * incx],
+            x2 = alpha * x[(i + 2) * incx], x3 = alpha * x[(i + 3) * incx];
+    const V b0 = V() + x0, b1 = V() + x1, b2 = V() + x2, b3 = V() + x3;
+    int j = 0;
+    for (; j + kLanes <= n; j += kLanes) {
+      V acc, v0, v1, v2, v3;
+      std::memcpy(&acc, y + j, sizeof(V));
+      std::memcpy(&v0, a0 + j, sizeof(V));
+      std::memcpy(&v1, a1 + j, sizeof(V));
+      std::memcpy(&v2, a2 + j, sizeof(V));
+      std::memcpy(&v3, a3 + j, sizeof(V));
+      acc += b0 * v0 + b1 * v1 + b2 * v2 + b3 * v3;
+      std::memcpy(y + j, &acc, sizeof(V));
+    }
+    for (; j < n; j++) {
+      y[j] += x0 * a0[j] + x1 * a1[j] + x2 * a2[j] + x3 * a3[j];
+    }
+  }
+  for (; i < rows; i++) {
+    const T* row = a + i * lda;
+    const T xi = alpha * x[i * incx];
+    const V bi = V() + xi;
+    int j = 0;
+    for (; j + kLanes <= n; j += kLanes) {
+      V acc, v;
+      std::memcpy(&acc, y + j, sizeof(V));
+      std::memcpy(&v, row + j, sizeof(V));
+      acc += bi * v;
+      std::memcpy(y + j, &acc, sizeof(V));
+    }
+    for (; j < n; j++) y[j] += xi * row[j];
+  }
+}
+
+/**
+ * @brief Ядра Gemv и Gevm для одного уровня SIMD (см. DotRowsBody,
+ * AxpyRowsBody)
+ */
+template <typename T>
+struct VectorKernels {
+  void (*dot_rows)(int rows, int n, T alpha, const T* a, ptrdiff_t lda,
+                   const T* x, T beta, T* y, ptrdiff_t incy);
+  void (*axpy_rows)(int rows, int n, T alpha, const T* x, ptrdiff_t incx,
+                    const T* a, ptrdiff_t lda, T* y);
+};
+
+template <typename T, typename V>
+void DotRowsVec(int rows, int n, T alpha, const T* a, ptrdiff_t lda,
+                const T* x, T beta, T* y, ptrdiff_t incy) {
+  DotRowsBody<T, V>(rows, n, alpha, a, lda, x, beta, y, incy);
+}
+
+template <typename T, typename V>
+void AxpyRowsVec(int rows, int n, T alpha, const T* x, ptrdiff_t incx,
+                 const T* a, ptrdiff_t lda, T* y) {
+  AxpyRowsBody<T, V>(rows, n, alpha, x, incx, a, lda, y);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+typedef double v4d __attribute__((vector_size(32)));
+typedef double v8d __attribute__((vector_size(64)));
+typedef float v8sf __attribute__((vector_size(32)));
+typedef float v16sf __attribute__((vector_size(64)));
+
+// Те же тела, собранные под AVX2 / AVX-512 (векторы 256 / 512 бит)
+#define S21_VECTOR_KERNELS(name, isa, T, V)                                  \
+  __attribute__((target(isa))) void DotRows##name(                           \
+      int rows, int n, T alpha, const T* a, ptrdiff_t lda, const T* x,       \
+      T beta, T* y, ptrdiff_t incy) {                                        \
+    DotRowsBody<T, V>(rows, n, alpha, a, lda, x, beta, y, incy);             \
+  }                                                                          \
+  __attribute__((target(isa))) void AxpyRows##name(                          \
+      int rows, int n, T alpha, const T* x, ptrdiff_t incx, const T* a,      \
+      ptrdiff_t lda, T* y) {                                                 \
+    AxpyRowsBody<T, V>(rows, n, alpha, x, incx, a, lda, y);                  \
+  }
+
+S21_VECTOR_KERNELS(Avx2, "avx2", double, v4d)
+S21_VECTOR_KERNELS(Avx512, "avx512f", double, v8d)
+S21_VECTOR_KERNELS(Avx2F, "avx2", float, v8sf)
+S21_VECTOR_KERNELS(Avx512F, "avx512f", float, v16sf)
+
+#undef S21_VECTOR_KERNELS
+
+#endif
+
+/**
+ * @brief Выбирает ядра Gemv и Gevm по типу элемента и уровню SIMD
+ */
+template <typename T>
+VectorKernels<T> select_vector_kernels() {
+  return {DotRowsVec<T, T>, AxpyRowsVec<T, T>};
+}
+
+template <>
+VectorKernels<double> select_vector_kernels<double>() {
+  VectorKernels<double> kernels = {DotRowsVec<double, v2d>,
+                                   AxpyRowsVec<double, v2d>};
+#if defined(__x86_64__) || defined(__i386__)
+  if (Simd().level == kSimdAvx512) {
+    kernels = {DotRowsAvx512, AxpyRowsAvx512};
+  } else if (Simd().level == kSimdAvx2) {
+    kernels = {DotRowsAvx2, AxpyRowsAvx2};
+  }
+#endif
+  return kernels;
+}
+
+template <>
+VectorKernels<float> select_vector_kernels<float>() {
+  VectorKernels<float> kernels = {DotRowsVec<float, v4sf>,
+                                  AxpyRowsVec<float, v4sf>};
+#if defined(__x86_64__) || defined(__i386__)
+  if (Simd<float>().level == kSimdAvx512) {
+    kernels = {DotRowsAvx512F, AxpyRowsAvx512F};
+  } else if (Simd<float>().level == kSimdAvx2) {
+    kernels = {DotRowsAvx2F, AxpyRowsAvx2F};
+  }
+#endif
+  return kernels;
+}
+
+/**
+ * @brief body(0) .. body(count - 1): в пуле потоков, если задач больше
+ * одной и потоков больше одного, иначе в вызывающем потоке
+ */
+template <typename Body>
+void RunTasks(int count, const Body& body) {
+  if (count > 1 && S21ThreadPool::ThreadCount() > 1) {
+    S21ThreadPool::Instance().ParallelFor(count, body);
+  } else {
+    for (int task = 0; task < count; task++) body(task);
+  }
+}
+
+/**
+ * @brief Выбирает микроядро по типу элемента и уровню SIMD, выбранному при
+ * старте
+ */
+template <typename T>
+GemmKernel<T> select_kernel();
+
+template <>
+GemmKernel<double> select_kernel<double>() {
+  GemmKernel<double> kernel = {4, 4, MicroKernelVec<double, v2d>};
+#if defined(__x86_64__) || defined(__i386__)
+  if (Simd().level == kSimdAvx512) {
+    kernel = {8, 16, MicroKernelAvx512};
+  } else if (Simd().level == kSimdAvx2) {
+    kernel = {6, 8, MicroKernelAvx2};
+  }
+#endif
+  return kernel;
+}
+
+template <>
+GemmKernel<float> select_kernel<float>() {
+  GemmKernel<float> kernel = {4, 8, MicroKernelVec<float, v4sf>};
+#if defined(__x86_64__) || defined(__i386__)
+  if (Simd<float>().level == kSimdAvx512) {
+    kernel = {8, 32, MicroKernelAvx512F};
+  } else if (Simd<float>().level == kSimdAvx2) {
+    kernel = {6, 16, MicroKernelAvx2F};
+  }
+#endif
+  return kernel;
+}
+
+template <>
+GemmKernel<long double> select_kernel<long double>() {
+  return {4, 4, MicroKernelScalar<long double>};
+}
+
+/**
+ * @brief Умножение без упаковки для маленьких матриц, где упаковка дороже
+ * самого произведения
+ */
+template <typename T>
+void SmallGemm(int m, int n, int k, T alpha, const T* a, ptrdiff_t rsa,
+               ptrdiff_t csa, const T* b, ptrdiff_t rsb, ptrdiff_t csb,
+               T beta, T* c, ptrdiff_t ldc) {
+  for (int i = 0; i < m; i++) {
+    T* row = c + i * ldc;
+    for (int j = 0; j < n; j++) {
+      T acc = 0;
+      for (int p = 0; p < k; p++) {
+        acc += a[i * rsa + p * csa] * b[p * rsb + j * csb];
+      }
+      row[j] = (beta == 0) ? alpha * acc : beta * row[j] + alpha * acc;
+    }
+  }
+}
+
+/**
+ * @brief C = beta * C для вырожденных случаев (k == 0 или alpha == 0)
+ */
+template <typename T>
+void ScaleC(int m, int n, T beta, T* c, ptrdiff_t ldc) {
+  for (int i = 0; i < m; i++) {
+    T* row = c + i * ldc;
+    for (int j = 0; j < n; j++) row[j] = (beta == 0) ? 0 : beta * row[j];
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void Gemm(int m, int n, int k, T alpha, const T* a, ptrdiff_t rsa,
+          ptrdiff_t csa, const T* b, ptrdiff_t rsb, ptrdiff_t csb, T beta,
+          T* c, ptrdiff_t ldc) {
+  if (m <= 0 || n <= 0) return;
+  if (k <= 0 || alpha == 0) {
+    ScaleC(m, n, beta, c, ldc);
+  } else if (n == 1 && (csa == 1 || rsa == 1)) {
+    // Один столбец B: A * b, строки A подряд - Gemv, столбцы - Gevm по A^T
+    if (csa == 1) {
+      Gemv(m, k, alpha, a, rsa, b, rsb, beta, c, ldc);
+    } else {
+      Gevm(k, m, alpha, b, rsb, a, csa, beta, c, ldc);
+    }
+  } else if (m == 1 && (csb == 1 || rsb == 1)) {
+    // Одна строка A: a^T * B
+    if (csb == 1) {
+      Gevm(k, n, alpha, a, csa, b, rsb, beta, c, 1);
+    } else {
+      Gemv(n, k, alpha, b, csb, a, csa, beta, c, 1);
+    }
+  } else if ((long long)m * n * k <= kSmallGemm) {
+    SmallGemm(m, n, k, alpha, a, rsa, csa, b, rsb, csb, beta, c, ldc);
+  } else {
+    S21ThreadPool& pool = S21ThreadPool::Instance();
+    int threads = ((long long)m * n * k >= kParallelGemm)
+                      ? S21ThreadPool::ThreadCount()
+                      : 1;
+    // Панель B общая для всех задач этого вызова
+    ScratchBuffer<0> buf_b;
+    const GemmKernel<T> kernel = select_kernel<T>();
+    const int mr_max = kernel.mr, nr_max = kernel.nr;
+    int nc_max = (std::min(n, kNC) + nr_max - 1) / nr_max * nr_max;
+    T* packed_b = buf_b.reserve<T>((size_t)kKC * nc_max);
+    for (int jc = 0; jc < n; jc += kNC) {
+      int nc = std::min(kNC, n - jc);
+      int panels = (nc + nr_max - 1) / nr_max;
+      int m_blocks = (m + kMC - 1) / kMC;
+      // Делим столбцы панели B на части так, чтобы задач было не меньше
+      // удвоенного числа потоков
+      int n_parts = std::min(panels, std::max(1, (2 * threads + m_blocks - 1) /
+                                                     m_blocks));
+      auto part_begin = [&](int part) {
+        return (int)((long long)panels * part / n_parts) * nr_max;
+      };
+      auto part_end = [&](int part) {
+        return std::min(nc, part_begin(part + 1));
+      };
+      for (int pc = 0; pc < k; pc += kKC) {
+        int kc = std::min(kKC, k - pc);
+        T beta_pc = (pc == 0) ? beta : T(1);
+        auto pack_part = [&](int part) {
+          int j0 = part_begin(part), j1 = part_end(part);
+          PackB(kc, j1 - j0, nr_max, b + pc * rsb + (jc + j0) * csb, rsb, csb,
+                packed_b + (size_t)j0 * kc);
+        };
+        // Каждая задача считает блок kMC строк на свою часть столбцов.
+        // Разбиение идет только по m и n, порядок суммирования по k у
+        // каждого элемента C не зависит от числа потоков
+        auto tile = [&](int task) {
+          int ic = (task % m_blocks) * kMC, part = task / m_blocks;
+          int mc = std::min(kMC, m - ic);
+          int j0 = part_begin(part), j1 = part_end(part);
+          static thread_local PackBuffer buf_a;
+          T* packed_a = buf_a.reserve<T>((size_t)kMC * kKC);
+          PackA(mc, kc, mr_max, a + ic * rsa + pc * csa, rsa, csa, packed_a);
+          for (int jr = j0; jr < j1; jr += nr_max) {
+            for (int ir = 0; ir < mc; ir += mr_max) {
+              kernel.run(kc, packed_a + ir * kc, packed_b + (size_t)jr * kc,
+                         alpha, beta_pc, c + (ic + ir) * ldc + jc + jr, ldc,
+                         std::min(mr_max, mc - ir), std::min(nr_max, nc - jr));
+            }
+          }
+        };
+        if (threads > 1) {
+          pool.ParallelFor(n_parts, pack_part);
+          pool.ParallelFor(m_blocks * n_parts, tile);
+        } else {
+          for (int part = 0; part < n_parts; part++) pack_part(part);
+          for (int task = 0; task < m_blocks * n_parts; task++) tile(task);
+        }
+      }
+    }
+  }
+}
+
+template <typename T>
+void Gemv(int m, int n, T alpha, const T* a, ptrdiff_t lda, const T* x,
+          ptrdiff_t incx, T beta, T* y, ptrdiff_t incy) {
+  if (m <= 0) return;
+  if (n <= 0 || alpha == 0) {
+    ScaleC(m, 1, beta, y, incy);
+    return;
+  }
+  ScratchBuffer<1> buf_x;
+  if (incx != 1) {
+    T* packed = buf_x.reserve<T>(n);
+    for (int j = 0; j < n; j++) packed[j] = x[j * incx];
+    x = packed;
+  }
+  const auto dot_rows = select_vector_kernels<T>().dot_rows;
+  // Строки делятся между потоками, каждый y_i считается одним ядром целиком
+  const int parts = ((double)m * n >= kParallelGemv)
+                        ? std::min(m, S21ThreadPool::ThreadCount())
+                        : 1;
+  RunTasks(parts, [&](int part) {
+    int begin = (int)((long long)m * part / parts);
+    int end = (int)((long long)m * (part + 1) / parts);
+    dot_rows(end - begin, n, alpha, a + begin * lda, lda, x, beta,
+             y + begin * incy, incy);
+  });
+}
+
+template <typename T>
+void Gevm(int m, int n, T alpha, const T* x, ptrdiff_t incx, const T* a,
+          ptrdiff_t lda, T beta, T* y, ptrdiff_t incy) {
+  if (n <= 0) return;
+  if (m <= 0 || alpha == 0) {
+    ScaleC(n, 1, beta, y, incy);
+    return;
+  }
+  const auto axpy_rows = select_vector_kernels<T>().axpy_rows;
+  const bool large = (double)m * n >= kParallelGemv;
+  const int row_parts =
+      large ? std::min((m + kGevmRows - 1) / kGevmRows, kGevmParts) : 1;
+  const int col_parts = large ? (n + kGevmCols - 1) / kGevmCols : 1;
+  auto col_begin = [&](int part) {
+    return (int)((long long)n * part / col_parts);
+  };
+  if (row_parts == 1 && incy == 1) {
+    // Одна часть строк: сумма копится прямо в y, полосы столбцов - задачи
+    ScaleC(1, n, beta, y, n);
+    RunTasks(col_parts, [&](int part) {
+      int c0 = col_begin(part), c1 = col_begin(part + 1);
+      axpy_rows(m, c1 - c0, alpha, x, incx, a + c0, lda, y + c0);
+    });
+    return;
+  }
+  // Частичные суммы частей строк складываются по порядку частей
+  ScratchBuffer<1> buf;
+  T* partial = buf.reserve<T>((size_t)row_parts * n);
+  RunTasks(row_parts * col_parts, [&](int task) {
+    int row_part = task % row_parts, col_part = task / row_parts;
+    int r0 = (int)((long long)m * row_part / row_parts);
+    int r1 = (int)((long long)m * (row_part + 1) / row_parts);
+    int c0 = col_begin(col_part), c1 = col_begin(col_part + 1);
+    T* acc = partial + (size_t)row_part * n + c0;
+    std::fill(acc, acc + (c1 - c0), T(0));
+    axpy_rows(r1 - r0, c1 - c0, alpha, x + r0 * incx, incx,
+              a + r0 * lda + c0, lda, acc);
+  });
+  for (int j = 0; j < n; j++) {
+    T sum = partial[j];
+    for (int part = 1; part < row_parts; part++) {
+      sum += partial[(size_t)part * n + j];
+    }
+    T* out = y + j * incy;
+    *out = (beta == 0) ? sum : beta * *out + sum;
+  }
+}
+
+template void Gemm(int, int, int, float, const float*, ptrdiff_t, ptrdiff_t,
+                   const float*, ptrdiff_t, ptrdiff_t, float, float*,
+                   ptrdiff_t);
+template void Gemm(int, int, int, double, const double*, ptrdiff_t,
+                   ptrdiff_t, const double*, ptrdiff_t, ptrdiff_t, double,
+                   double*, ptrdiff_t);
+template void Gemm(int, int, int, long double, const long double*, ptrdiff_t,
+                   ptrdiff_t, const long double*, ptrdiff_t, ptrdiff_t,
+                   long double, long double*, ptrdiff_t);
+
+#define S21_GEMV_INSTANTIATE(T)                                              \
+  template void Gemv(int, int, T, const T*, ptrdiff_t, const T*, ptrdiff_t, \
+                     T, T*, ptrdiff_t);                                      \
+  template void Gevm(int, int, T, const T*, ptrdiff_t, const T*, ptrdiff_t, \
+                     T, T*, ptrdiff_t);
+
+S21_GEMV_INSTANTIATE(float)
+S21_GEMV_INSTANTIATE(double)
+S21_GEMV_INSTANTIATE(long double)
+
+#undef S21_GEMV_INSTANTIATE
+
+}  // namespace s21
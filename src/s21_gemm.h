@@ -0,0 +1,80 @@
+#ifndef __S21GEMM_H__
+#define __S21GEMM_H__
+
+#include <cstddef>
+
+namespace s21 {
+
+/**
+ * @brief Блочное умножение матриц C = alpha * A * B + beta * C
+ * Матрицы задаются указателем и шагами по строкам/столбцам, поэтому
+ * транспонированные операнды передаются без копирования (достаточно поменять
+ * шаги местами)
+ * @param m Количество строк A и C
+ * @param n Количество столбцов B и C
+ * @param k Количество столбцов A и строк B
+ * @param rsa, csa Шаг между строками и столбцами матрицы A
+ * @param rsb, csb Шаг между строками и столбцами матрицы B
+ * @param ldc Шаг между строками матрицы C (C всегда row-major)
+ * При beta == 0 исходное содержимое C не читается. Определено для
+ * T = float, double, long double, у каждого типа свои микроядра
+ */
+template <typename T>
+void Gemm(int m, int n, int k, T alpha, const T* a, ptrdiff_t rsa,
+          ptrdiff_t csa, const T* b, ptrdiff_t rsb, ptrdiff_t csb, T beta,
+          T* c, ptrdiff_t ldc);
+
+/**
+ * @brief Умножение row-major матриц C = A * B
+ */
+template <typename T>
+inline void Gemm(int m, int n, int k, const T* a, ptrdiff_t lda, const T* b,
+                 ptrdiff_t ldb, T* c, ptrdiff_t ldc) {
+  Gemm(m, n, k, T(1), a, lda, 1, b, ldb, 1, T(0), c, ldc);
+}
+
+/**
+ * @brief Умножение матрицы на вектор y = alpha * A * x + beta * y (GEMV)
+ * A - row-major m x n с шагом lda, x - n элементов с шагом incx, y - m
+ * элементов с шагом incy. Каждый y_i - скалярное произведение строки A на x:
+ * четыре строки за проход векторными регистрами, x с шагом (incx != 1)
+ * предварительно собирается в поточный буфер. Высокие матрицы делятся по
+ * строкам между потоками пула. При beta == 0 исходное содержимое y не
+ * читается. Gemm с одним столбцом B вызывает Gemv
+ */
+template <typename T>
+void Gemv(int m, int n, T alpha, const T* a, ptrdiff_t lda, const T* x,
+          ptrdiff_t incx, T beta, T* y, ptrdiff_t incy);
+
+/**
+ * @brief Умножение вектора на матрицу y = alpha * x^T * A + beta * y (GEVM)
+ * x - m элементов с шагом incx, A - row-major m x n с шагом lda, y - n
+ * элементов с шагом incy. Строки A прибавляются к накоплению по четыре за
+ * проход, матрица читается подряд. Большие матрицы делятся на части строк
+ * (число частей зависит только от размеров, не от числа потоков, поэтому
+ * результат не меняется с числом потоков) и полосы столбцов; частичные суммы
+ * лежат в поточном буфере. Gemm с одной строкой A вызывает Gevm
+ */
+template <typename T>
+void Gevm(int m, int n, T alpha, const T* x, ptrdiff_t incx, const T* a,
+          ptrdiff_t lda, T beta, T* y, ptrdiff_t incy);
+
+/**
+ * @brief y = A * x для непрерывных векторов (x - n, y - m элементов)
+ */
+template <typename T>
+inline void Gemv(int m, int n, const T* a, ptrdiff_t lda, const T* x, T* y) {
+  Gemv(m, n, T(1), a, lda, x, 1, T(0), y, 1);
+}
+
+/**
+ * @brief y = x^T * A для непрерывных векторов (x - m, y - n элементов)
+ */
+template <typename T>
+inline void Gevm(int m, int n, const T* x, const T* a, ptrdiff_t lda, T* y) {
+  Gevm(m, n, T(1), x, 1, a, lda, T(0), y, 1);
+}
+
+}  // namespace s21
+
+#endif
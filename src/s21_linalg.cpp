@@ -0,0 +1,864 @@
+#include "s21_linalg.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "s21_gemm.h"
+#include "s21_simd.h"
+#include "s21_thread_pool.h"
+#include "s21_transpose.h"
+
+namespace s21 {
+
+namespace {
+
+// Ширина панели блочного LU: панель раскладывается построчными axpy,
+// остаток матрицы обновляется одним Gemm на панель
+constexpr int kLuBlock = 64;
+// Объем работы (в умножениях), начиная с которого она делится между
+// потоками пула
+constexpr double kParallelWork = 1 << 18;
+// Ширина панели QR: панель раскладывается рекурсивно, к хвосту ее
+// отражения применяются блоком
+constexpr int kQrBlock = 32;
+// Ширина полосы, которую QrPanel раскладывает уже по одному столбцу
+constexpr int kQrLeaf = 8;
+// Ширина блока разложения Холецкого - глубина Gemm при обновлении хвоста.
+// Панель L21 считается одним Gemm, а не построчно, поэтому блок шире, чем у
+// LU (на 2048 x 2048 разложение с 192 быстрее, чем с 64, примерно на 30%)
+constexpr int kCholeskyBlock = 192;
+template <typename T>
+constexpr T kEps = std::numeric_limits<T>::epsilon();
+
+/**
+ * @brief Раскладывает панель из столбцов [k, k + kb) (строки k..n-1)
+ * Строки переставляются целиком, поэтому уже посчитанная часть L и еще не
+ * обработанные столбцы переставляются вместе с панелью
+ * @param tol Порог вырожденности для каждого столбца
+ * @param sign Знак перестановки, меняется при каждой перестановке строк
+ * @return true - встретился пренебрежимо малый ведущий элемент
+ */
+template <typename T>
+bool LuPanel(int n, int k, int kb, T* a, ptrdiff_t lda, int* piv,
+             const T* tol, int& sign) {
+  const BasicSimdKernels<T>& simd = Simd<T>();
+  bool singular = false;
+  for (int j = k; j < k + kb; j++) {
+    int p = j;
+    T best = std::fabs(a[j * lda + j]);
+    for (int i = j + 1; i < n; i++) {
+      T value = std::fabs(a[i * lda + j]);
+      if (value > best) {
+        best = value;
+        p = i;
+      }
+    }
+    piv[j] = p;
+    if (p != j) {
+      std::swap_ranges(a + j * lda, a + j * lda + n, a + p * lda);
+      sign = -sign;
+    }
+    const T* pivot_row = a + j * lda;
+    T pivot = pivot_row[j];
+    if (std::fabs(pivot) <= tol[j]) singular = true;
+    if (pivot != 0) {
+      for (int i = j + 1; i < n; i++) {
+        T* row = a + i * lda;
+        T l = row[j] / pivot;
+        row[j] = l;
+        if (l != 0) {
+          simd.axpy(row + j + 1, -l, pivot_row + j + 1, k + kb - j - 1);
+        }
+      }
+    }
+  }
+  return singular;
+}
+
+/**
+ * @brief Скалярное произведение с четырьмя независимыми накопителями
+ */
+template <typename T>
+T Dot(const T* x, const T* y, int n) {
+  T s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    s0 += x[i] * y[i];
+    s1 += x[i + 1] * y[i + 1];
+    s2 += x[i + 2] * y[i + 2];
+    s3 += x[i + 3] * y[i + 3];
+  }
+  for (; i < n; i++) s0 += x[i] * y[i];
+  return (s0 + s1) + (s2 + s3);
+}
+
+/**
+ * @brief Обращает верхнюю треугольную часть матрицы на месте, не трогая L
+ * под диагональю. Блочные строки обрабатываются снизу вверх:
+ * X11 = U11^-1, X12 = -X11 * (U12 * X22), где X22 уже посчитан. Основная
+ * работа - U12 * X22 через Gemm по блокам столбцов, диагональные блоки X22
+ * (под ними лежит L) домножаются отдельно построчными axpy
+ */
+template <typename T>
+void InvertUpper(int n, T* a, ptrdiff_t lda) {
+  const BasicSimdKernels<T>& simd = Simd<T>();
+  int nb = std::min(kLuBlock, n);
+  std::vector<T> t((size_t)nb * n), row_sum(nb);
+  int last = (n - 1) / nb * nb;
+  for (int ib = last; ib >= 0; ib -= nb) {
+    int iend = std::min(ib + nb, n), kb = iend - ib, rest = n - iend;
+    // T = U12 * X22
+    for (int jb = iend; jb < n; jb += nb) {
+      int jend = std::min(jb + nb, n);
+      T* tj = t.data() + (jb - iend);
+      Gemm(kb, jend - jb, jb - iend, T(1), a + ib * lda + iend, lda, 1,
+           a + iend * lda + jb, lda, 1, T(0), tj, rest);
+      for (int r = 0; r < kb; r++) {
+        const T* u = a + (ib + r) * lda;
+        T* t_row = tj + (size_t)r * rest;
+        for (int k = jb; k < jend; k++) {
+          if (u[k] != 0) {
+            simd.axpy(t_row + (k - jb), u[k], a + k * lda + k, jend - k);
+          }
+        }
+      }
+    }
+    // X11 = U11^-1: строка i собирается из уже готовых строк k > i
+    for (int i = iend - 1; i >= ib; i--) {
+      T* row = a + i * lda;
+      T inv_diag = 1 / row[i];
+      std::fill(row_sum.begin(), row_sum.end(), T(0));
+      for (int k = i + 1; k < iend; k++) {
+        if (row[k] != 0) {
+          simd.axpy(row_sum.data() + (k - ib), row[k], a + k * lda + k,
+                    iend - k);
+        }
+      }
+      row[i] = inv_diag;
+      for (int j = i + 1; j < iend; j++) row[j] = -inv_diag * row_sum[j - ib];
+    }
+    // X12 = -X11 * T
+    for (int r = 0; r < kb && rest > 0; r++) {
+      T* row = a + (ib + r) * lda;
+      std::fill(row + iend, row + n, T(0));
+      for (int k = r; k < kb; k++) {
+        if (row[ib + k] != 0) {
+          simd.axpy(row + iend, -row[ib + k], t.data() + (size_t)k * rest,
+                    rest);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief body(begin, end) по частям [0, count), поровну между потоками пула;
+ * при малом объеме работы (count * cost < kParallelWork) - одним вызовом
+ */
+template <typename Body>
+void ForParts(int count, double cost, const Body& body) {
+  const int parts = std::min(count, S21ThreadPool::ThreadCount());
+  if (parts > 1 && count * cost >= kParallelWork) {
+    S21ThreadPool::Instance().ParallelFor(parts, [&](int part) {
+      body((int)((long long)count * part / parts),
+           (int)((long long)count * (part + 1) / parts));
+    });
+  } else {
+    body(0, count);
+  }
+}
+
+/**
+ * @brief acc[0:width] = сумма body(begin, end, part_acc) по частям строк
+ * [0, rows): каждая часть копит свою сумму с нуля, затем суммы
+ * складываются. Для малого объема - один вызов прямо в acc
+ */
+template <typename T, typename Body>
+void ReduceRows(int rows, int width, double cost, T* acc, const Body& body) {
+  std::fill(acc, acc + width, T(0));
+  const int parts = std::min(rows, S21ThreadPool::ThreadCount());
+  if (parts > 1 && rows * cost >= kParallelWork) {
+    std::vector<T> partial((size_t)parts * width, T(0));
+    S21ThreadPool::Instance().ParallelFor(parts, [&](int part) {
+      body((int)((long long)rows * part / parts),
+           (int)((long long)rows * (part + 1) / parts),
+           partial.data() + (size_t)part * width);
+    });
+    for (int part = 0; part < parts; part++) {
+      Simd<T>().add(acc, partial.data() + (size_t)part * width, width);
+    }
+  } else if (rows > 0) {
+    body(0, rows, acc);
+  }
+}
+
+/**
+ * @brief W (p x q, шаг q) = X^T * Y для X (rows x p) и Y (rows x q) по
+ * частям строк
+ */
+template <typename T>
+void TransposedProduct(int rows, int p, int q, const T* x, ptrdiff_t ldx,
+                       const T* y, ptrdiff_t ldy, T* w) {
+  ReduceRows(rows, p * q, (double)p * q, w, [&](int begin, int end, T* acc) {
+    Gemm(p, q, end - begin, T(1), x + begin * ldx, 1, ldx, y + begin * ldy,
+         ldy, 1, T(1), acc, q);
+  });
+}
+
+/**
+ * @brief Раскладывает узкую панель rows x kb (p - ее левый верхний угол) по
+ * одному столбцу: отражение для столбца j (как dlarfg в LAPACK) сразу
+ * применяется к столбцам j + 1 .. kb - 1. На столбец - два прохода по
+ * строкам: масштабирование v вместе с w = v^T * A, затем обновление вместе с
+ * нормой следующего столбца. Ширина не больше kQrLeaf, поэтому строки
+ * обновляются простыми циклами без вызова ядер Simd
+ */
+template <typename T>
+void QrLeafColumns(int rows, int kb, T* p, ptrdiff_t lda, T* tau) {
+  T w[kQrLeaf];
+  // Сумма квадратов столбца 0 под диагональю
+  T sigma = 0;
+  ReduceRows(rows - 1, 1, 1, &sigma, [&](int begin, int end, T* acc) {
+    for (int i = begin; i < end; i++) {
+      T x = p[(i + 1) * lda];
+      acc[0] += x * x;
+    }
+  });
+  for (int j = 0; j < kb; j++) {
+    T* diag = p + j * lda + j;
+    const int below = rows - j - 1, width = kb - j - 1;
+    T alpha = *diag;
+    if (sigma == 0) {
+      tau[j] = 0;
+    } else {
+      T beta = -std::copysign(std::sqrt(alpha * alpha + sigma), alpha);
+      tau[j] = (beta - alpha) / beta;
+      T scale = 1 / (alpha - beta);
+      *diag = beta;
+      // v = x / (alpha - beta), w = v^T * A(:, j + 1:kb) (с v_j = 1)
+      ReduceRows(below, width, width + 1, w, [&](int begin, int end, T* acc) {
+        for (int i = begin; i < end; i++) {
+          T* row = diag + (i + 1) * lda;
+          row[0] *= scale;
+          for (int q = 0; q < width; q++) acc[q] += row[0] * row[q + 1];
+        }
+      });
+      for (int q = 0; q < width; q++) {
+        w[q] += diag[q + 1];
+        diag[q + 1] -= tau[j] * w[q];
+      }
+    }
+    if (width == 0) break;
+    // A(:, j + 1:kb) -= tau * v * w^T и сумма квадратов столбца j + 1 ниже
+    // строки j + 1
+    const T t = tau[j];
+    sigma = 0;
+    ReduceRows(below, 1, width, &sigma, [&](int begin, int end, T* acc) {
+      for (int i = begin; i < end; i++) {
+        T* row = diag + (i + 1) * lda;
+        const T f = t * row[0];
+        for (int q = 0; q < width; q++) row[q + 1] -= f * w[q];
+        if (i > 0) acc[0] += row[1] * row[1];
+      }
+    });
+  }
+}
+
+/**
+ * @brief QrLeafColumns над плотной копией полосы: строки исходной матрицы
+ * лежат с шагом lda, и на каждом проходе по столбцу читались бы разрозненные
+ * строки кэша
+ */
+template <typename T>
+void QrLeaf(int rows, int kb, T* p, ptrdiff_t lda, T* tau) {
+  if (lda == kb) {
+    QrLeafColumns(rows, kb, p, lda, tau);
+    return;
+  }
+  std::vector<T> strip((size_t)rows * kb);
+  for (int i = 0; i < rows; i++) {
+    std::copy(p + i * lda, p + i * lda + kb, strip.data() + (size_t)i * kb);
+  }
+  QrLeafColumns(rows, kb, strip.data(), kb, tau);
+  for (int i = 0; i < rows; i++) {
+    const T* row = strip.data() + (size_t)i * kb;
+    std::copy(row, row + kb, p + i * lda);
+  }
+}
+
+/**
+ * @brief WY-блок панели: явный верхний треугольник V1 (kb x kb, единицы на
+ * диагонали) и верхняя треугольная T (kb x kb), для которых
+ * H_0 * ... * H_{kb-1} = I - V * T * V^T (как dlarft в LAPACK). Столбец j
+ * матрицы T: T(0:j, j) = -tau_j * T(0:j, 0:j) * (V^T * v_j)(0:j)
+ */
+template <typename T>
+void QrBlock(int rows, int kb, const T* p, ptrdiff_t lda, const T* tau,
+             T* v1, T* t) {
+  for (int i = 0; i < kb; i++) {
+    for (int j = 0; j < kb; j++) {
+      v1[i * kb + j] = i == j ? T(1) : i > j ? p[i * lda + j] : T(0);
+    }
+  }
+  // G = V^T * V = V1^T * V1 + V2^T * V2
+  std::vector<T> g((size_t)kb * kb);
+  TransposedProduct(rows - kb, kb, kb, p + kb * lda, lda, p + kb * lda, lda,
+                    g.data());
+  Gemm(kb, kb, kb, T(1), v1, 1, kb, v1, kb, 1, T(1), g.data(), kb);
+  std::fill(t, t + kb * kb, T(0));
+  for (int j = 0; j < kb; j++) {
+    t[j * kb + j] = tau[j];
+    for (int i = 0; i < j; i++) {
+      T sum = 0;
+      for (int q = i; q < j; q++) sum += t[i * kb + q] * g[q * kb + j];
+      t[i * kb + j] = -tau[j] * sum;
+    }
+  }
+}
+
+/**
+ * @brief C (rows x ncols) = (I - V * T * V^T)^T * C при transpose, иначе
+ * (I - V * T * V^T) * C: W = V^T * C по частям строк, W = T^T * W (T * W),
+ * C -= V * W
+ */
+template <typename T>
+void QrApplyBlock(int rows, int kb, const T* p, ptrdiff_t lda, const T* v1,
+                  const T* t, T* c, ptrdiff_t ldc, int ncols, bool transpose) {
+  if (ncols == 0) return;
+  std::vector<T> w((size_t)kb * ncols), tw((size_t)kb * ncols);
+  TransposedProduct(rows - kb, kb, ncols, p + kb * lda, lda, c + kb * ldc,
+                    ldc, w.data());
+  Gemm(kb, ncols, kb, T(1), v1, 1, kb, c, ldc, 1, T(1), w.data(), ncols);
+  Gemm(kb, ncols, kb, T(1), t, transpose ? 1 : kb, transpose ? kb : 1,
+       w.data(), ncols, 1, T(0), tw.data(), ncols);
+  Gemm(kb, ncols, kb, T(-1), v1, kb, 1, tw.data(), ncols, 1, T(1), c, ldc);
+  if (rows > kb) {
+    Gemm(rows - kb, ncols, kb, T(-1), p + kb * lda, lda, 1, tw.data(), ncols,
+         1, T(1), c + kb * ldc, ldc);
+  }
+}
+
+/**
+ * @brief Раскладывает панель rows x kb рекурсивно (как dgeqrt3 в LAPACK):
+ * левая половина раскладывается, ее WY-блок через Gemm применяется к правой
+ * половине, затем раскладывается правая. Поколоночно разбираются только
+ * полосы шириной до kQrLeaf, поэтому высокая панель проходится по памяти
+ * O(log kb) раз за уровень, а не по два раза на каждый столбец
+ */
+template <typename T>
+void QrPanel(int rows, int kb, T* p, ptrdiff_t lda, T* tau) {
+  if (kb <= kQrLeaf) {
+    QrLeaf(rows, kb, p, lda, tau);
+    return;
+  }
+  const int k1 = kb / 2;
+  QrPanel(rows, k1, p, lda, tau);
+  std::vector<T> v1((size_t)k1 * k1), t((size_t)k1 * k1);
+  QrBlock(rows, k1, p, lda, tau, v1.data(), t.data());
+  QrApplyBlock(rows, k1, p, lda, v1.data(), t.data(), p + k1, lda, kb - k1,
+               true);
+  QrPanel(rows - k1, kb - k1, p + k1 * lda + k1, lda, tau + k1);
+}
+
+}  // namespace
+
+template <typename T>
+int LuFactor(int n, T* a, ptrdiff_t lda, int* piv) {
+  const BasicSimdKernels<T>& simd = Simd<T>();
+  // Масштаб столбцов исходной матрицы: ведущий элемент, который меньше
+  // n * eps * max|A(:, j)|, неотличим от нуля ошибок округления
+  std::vector<T> tol(n, T(0));
+  for (int i = 0; i < n; i++) {
+    const T* row = a + i * lda;
+    for (int j = 0; j < n; j++) tol[j] = std::max(tol[j], std::fabs(row[j]));
+  }
+  for (int j = 0; j < n; j++) tol[j] *= n * kEps<T>;
+
+  int sign = 1;
+  bool singular = false;
+  for (int k = 0; k < n; k += kLuBlock) {
+    int kb = std::min(kLuBlock, n - k);
+    if (LuPanel(n, k, kb, a, lda, piv, tol.data(), sign)) singular = true;
+    int rest = n - k - kb;
+    if (rest > 0) {
+      // U12 = L11^-1 * A12 (прямая подстановка по строкам панели)
+      for (int i = k + 1; i < k + kb; i++) {
+        T* row = a + i * lda;
+        for (int p = k; p < i; p++) {
+          if (row[p] != 0) {
+            simd.axpy(row + k + kb, -row[p], a + p * lda + k + kb, rest);
+          }
+        }
+      }
+      // A22 -= L21 * U12
+      Gemm(rest, rest, kb, T(-1), a + (k + kb) * lda + k, lda, 1,
+           a + k * lda + k + kb, lda, 1, T(1), a + (k + kb) * lda + k + kb,
+           lda);
+    }
+  }
+  return singular ? 0 : sign;
+}
+
+template <typename T>
+void LuInvert(int n, T* a, ptrdiff_t lda, const int* piv) {
+  InvertUpper(n, a, lda);
+  // X * L = U^-1: идем блоками столбцов справа налево. Столбцы L текущего
+  // блока переносятся в панель work, а на их месте собираются столбцы X
+  int nb = std::min(kLuBlock, n);
+  std::vector<T> work((size_t)n * nb);
+  int last = (n - 1) / nb * nb;
+  for (int jb = last; jb >= 0; jb -= nb) {
+    int jend = std::min(jb + nb, n);
+    for (int i = jb + 1; i < n; i++) {
+      T* row = a + i * lda;
+      T* w = work.data() + (size_t)i * nb;
+      for (int j = jb; j < jend && j < i; j++) {
+        w[j - jb] = row[j];
+        row[j] = 0;
+      }
+    }
+    // X(:, jb:jend) -= X(:, jend:n) * L(jend:n, jb:jend)
+    if (jend < n) {
+      Gemm(n, jend - jb, n - jend, T(-1), a + jend, lda, 1,
+           work.data() + (size_t)jend * nb, nb, 1, T(1), a + jb, lda);
+    }
+    // Треугольная часть внутри блока, по одному столбцу справа налево
+    std::vector<T> column(nb);
+    for (int j = jend - 2; j >= jb; j--) {
+      int len = jend - j - 1;
+      for (int i = 0; i < len; i++) {
+        column[i] = work[(size_t)(j + 1 + i) * nb + (j - jb)];
+      }
+      for (int i = 0; i < n; i++) {
+        T* row = a + i * lda;
+        row[j] -= Dot(row + j + 1, column.data(), len);
+      }
+    }
+  }
+  // Перестановка столбцов в обратном порядке, построчно (по памяти подряд)
+  for (int i = 0; i < n; i++) {
+    T* row = a + i * lda;
+    for (int j = n - 2; j >= 0; j--) std::swap(row[j], row[piv[j]]);
+  }
+}
+
+template <typename T>
+void LuSolve(int n, int nrhs, const T* a, ptrdiff_t lda, const int* piv,
+             T* b, ptrdiff_t ldb) {
+  if (n == 0 || nrhs == 0) return;
+  const BasicSimdKernels<T>& simd = Simd<T>();
+  for (int j = 0; j < n; j++) {
+    if (piv[j] != j) {
+      std::swap_ranges(b + j * ldb, b + j * ldb + nrhs, b + piv[j] * ldb);
+    }
+  }
+  // L * Y = P * B: блоки сверху вниз, Y(k:k+kb) сразу вычитается из строк
+  // ниже блока
+  for (int k = 0; k < n; k += kLuBlock) {
+    int kend = std::min(k + kLuBlock, n);
+    for (int i = k + 1; i < kend; i++) {
+      const T* row = a + i * lda;
+      for (int p = k; p < i; p++) {
+        if (row[p] != 0) simd.axpy(b + i * ldb, -row[p], b + p * ldb, nrhs);
+      }
+    }
+    if (kend < n) {
+      Gemm(n - kend, nrhs, kend - k, T(-1), a + kend * lda + k, lda, 1,
+           b + k * ldb, ldb, 1, T(1), b + kend * ldb, ldb);
+    }
+  }
+  // U * X = Y
+  UpperSolve(n, nrhs, a, lda, b, ldb);
+}
+
+template <typename T>
+void UpperSolve(int n, int nrhs, const T* a, ptrdiff_t lda, T* b,
+                ptrdiff_t ldb) {
+  if (n == 0 || nrhs == 0) return;
+  const BasicSimdKernels<T>& simd = Simd<T>();
+  // Блоки снизу вверх, X(k:kend) сразу вычитается из строк выше
+  int last = (n - 1) / kLuBlock * kLuBlock;
+  for (int k = last; k >= 0; k -= kLuBlock) {
+    int kend = std::min(k + kLuBlock, n);
+    for (int i = kend - 1; i >= k; i--) {
+      const T* row = a + i * lda;
+      T* bi = b + i * ldb;
+      for (int p = i + 1; p < kend; p++) {
+        if (row[p] != 0) simd.axpy(bi, -row[p], b + p * ldb, nrhs);
+      }
+      simd.scale(bi, T(1) / row[i], nrhs);
+    }
+    if (k > 0) {
+      Gemm(k, nrhs, kend - k, T(-1), a + k, lda, 1, b + k * ldb, ldb, 1,
+           T(1), b, ldb);
+    }
+  }
+}
+
+template <typename T>
+bool MixedPrecisionSolve(int n, int nrhs, const T* a, ptrdiff_t lda,
+                         const T* b, ptrdiff_t ldb, T* x, ptrdiff_t ldx) {
+  // Как ITERMAX в LAPACK: плохо обусловленным системам уточнение не
+  // помогает, и дальше считать нет смысла
+  constexpr int kMaxRefine = 30;
+  if (n == 0 || nrhs == 0) return true;
+  std::vector<float> lu((size_t)n * n);
+  T a_norm = 0;
+  for (int i = 0; i < n; i++) {
+    const T* row = a + i * lda;
+    T sum = 0;
+    for (int j = 0; j < n; j++) {
+      lu[(size_t)i * n + j] = (float)row[j];
+      sum += std::fabs(row[j]);
+    }
+    a_norm = std::max(a_norm, sum);
+  }
+  std::vector<int> piv(n);
+  if (LuFactor(n, lu.data(), n, piv.data()) == 0) return false;
+
+  // Правая часть или невязка в float, решение по float-разложению
+  std::vector<float> rhs((size_t)n * nrhs);
+  std::vector<T> residual((size_t)n * nrhs);
+  auto solve_float = [&](const T* src, ptrdiff_t lds) {
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < nrhs; j++) {
+        rhs[(size_t)i * nrhs + j] = (float)src[i * lds + j];
+      }
+    }
+    LuSolve(n, nrhs, lu.data(), n, piv.data(), rhs.data(), nrhs);
+  };
+  solve_float(b, ldb);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < nrhs; j++) x[i * ldx + j] = rhs[(size_t)i * nrhs + j];
+  }
+
+  const T tol = a_norm * kEps<T> * std::sqrt(T(n));
+  std::vector<T> x_norm(nrhs), r_norm(nrhs);
+  for (int iter = 0; iter <= kMaxRefine; iter++) {
+    // R = B - A * X
+    for (int i = 0; i < n; i++) {
+      std::copy(b + i * ldb, b + i * ldb + nrhs,
+                residual.data() + (size_t)i * nrhs);
+    }
+    Gemm(n, nrhs, n, T(-1), a, lda, 1, x, ldx, 1, T(1), residual.data(),
+         nrhs);
+    std::fill(x_norm.begin(), x_norm.end(), T(0));
+    std::fill(r_norm.begin(), r_norm.end(), T(0));
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < nrhs; j++) {
+        x_norm[j] = std::max(x_norm[j], std::fabs(x[i * ldx + j]));
+        r_norm[j] =
+            std::max(r_norm[j], std::fabs(residual[(size_t)i * nrhs + j]));
+      }
+    }
+    bool converged = true;
+    for (int j = 0; j < nrhs && converged; j++) {
+      converged = r_norm[j] <= x_norm[j] * tol;
+    }
+    if (converged) return true;
+    if (iter == kMaxRefine) break;
+    // X += A^-1 * R по float-разложению
+    solve_float(residual.data(), nrhs);
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < nrhs; j++) {
+        x[i * ldx + j] += rhs[(size_t)i * nrhs + j];
+      }
+    }
+  }
+  return false;
+}
+
+template <typename T>
+bool CholeskyFactor(int n, T* a, ptrdiff_t lda) {
+  T scale = 0;
+  for (int i = 0; i < n; i++) scale = std::max(scale, a[i * lda + i]);
+  const T tol = n * kEps<T> * scale;
+  const int nb = std::min(kCholeskyBlock, n);
+  std::vector<T> inv((size_t)nb * nb), panel((size_t)n * nb);
+  for (int k = 0; k < n; k += kCholeskyBlock) {
+    int kend = std::min(k + kCholeskyBlock, n), kb = kend - k;
+    // L11: строка i собирается из уже готовых строк блока (левосторонний
+    // вариант, скалярные произведения по непрерывным строкам)
+    for (int i = k; i < kend; i++) {
+      T* row = a + i * lda;
+      for (int j = k; j < i; j++) {
+        const T* lj = a + j * lda;
+        row[j] = (row[j] - Dot(row + k, lj + k, j - k)) / lj[j];
+      }
+      T d = row[i] - Dot(row + k, row + k, i - k);
+      if (!(d > tol)) return false;
+      row[i] = std::sqrt(d);
+    }
+    if (kend == n) break;
+    // L21 = A21 * L11^-T одним Gemm: L11^-1 (kb x kb) считается прямой
+    // подстановкой, A21 копируется в панель
+    int rest = n - kend;
+    std::fill(inv.begin(), inv.end(), T(0));
+    for (int j = 0; j < kb; j++) {
+      // Столбец j обратной: L11 * x = e_j, x[i] = 0 при i < j
+      inv[(size_t)j * kb + j] = 1 / a[(k + j) * lda + k + j];
+      for (int i = j + 1; i < kb; i++) {
+        const T* li = a + (k + i) * lda + k;
+        T sum = 0;
+        for (int p = j; p < i; p++) sum += li[p] * inv[(size_t)p * kb + j];
+        inv[(size_t)i * kb + j] = -sum / li[i];
+      }
+    }
+    for (int i = 0; i < rest; i++) {
+      std::copy(a + (kend + i) * lda + k, a + (kend + i) * lda + kend,
+                panel.data() + (size_t)i * kb);
+    }
+    Gemm(rest, kb, kb, T(1), panel.data(), kb, 1, inv.data(), 1, kb, T(0),
+         a + kend * lda + k, lda);
+    // A22 -= L21 * L21^T, только блоки столбцов на диагонали и ниже
+    int blocks = (rest + kCholeskyBlock - 1) / kCholeskyBlock;
+    ForParts(blocks, (double)rest * kCholeskyBlock * kb,
+             [&](int begin, int end) {
+               for (int jblock = begin; jblock < end; jblock++) {
+                 int jb = kend + jblock * kCholeskyBlock;
+                 int jw = std::min(kCholeskyBlock, n - jb);
+                 const T* l_j = a + jb * lda + k;
+                 Gemm(n - jb, jw, kb, T(-1), l_j, lda, 1, l_j, 1, lda, T(1),
+                      a + jb * lda + jb, lda);
+               }
+             });
+  }
+  for (int i = 0; i + 1 < n; i++) {
+    std::fill(a + i * lda + i + 1, a + i * lda + n, T(0));
+  }
+  return true;
+}
+
+template <typename T>
+void CholeskySolve(int n, int nrhs, const T* a, ptrdiff_t lda, T* b,
+                   ptrdiff_t ldb) {
+  if (n == 0 || nrhs == 0) return;
+  const BasicSimdKernels<T>& simd = Simd<T>();
+  // L * Y = B
+  for (int k = 0; k < n; k += kLuBlock) {
+    int kend = std::min(k + kLuBlock, n);
+    for (int i = k; i < kend; i++) {
+      const T* row = a + i * lda;
+      T* bi = b + i * ldb;
+      for (int p = k; p < i; p++) {
+        if (row[p] != 0) simd.axpy(bi, -row[p], b + p * ldb, nrhs);
+      }
+      simd.scale(bi, T(1) / row[i], nrhs);
+    }
+    if (kend < n) {
+      Gemm(n - kend, nrhs, kend - k, T(-1), a + kend * lda + k, lda, 1,
+           b + k * ldb, ldb, 1, T(1), b + kend * ldb, ldb);
+    }
+  }
+  // L^T * X = Y: столбец i матрицы L - строка i матрицы L^T
+  int last = (n - 1) / kLuBlock * kLuBlock;
+  for (int k = last; k >= 0; k -= kLuBlock) {
+    int kend = std::min(k + kLuBlock, n);
+    for (int i = kend - 1; i >= k; i--) {
+      T* bi = b + i * ldb;
+      for (int p = i + 1; p < kend; p++) {
+        T l = a[p * lda + i];
+        if (l != 0) simd.axpy(bi, -l, b + p * ldb, nrhs);
+      }
+      simd.scale(bi, T(1) / a[i * lda + i], nrhs);
+    }
+    if (k > 0) {
+      Gemm(k, nrhs, kend - k, T(-1), a + k * lda, 1, lda, b + k * ldb, ldb, 1,
+           T(1), b, ldb);
+    }
+  }
+}
+
+template <typename T>
+void CholeskyInvert(int n, T* a, ptrdiff_t lda) {
+  if (n == 0) return;
+  // W = (L^T)^-1 в верхнем треугольнике, ниже диагонали - нули
+  TransposeInPlace(n, a, lda);
+  InvertUpper(n, a, lda);
+  // Верхний треугольник W * W^T по блочным строкам сверху вниз: строки W
+  // ниже текущего блока еще не тронуты. W[J, p] = 0 при p < J0, поэтому
+  // блок (I, J) - произведение по столбцам от J0
+  int nb = std::min(kLuBlock, n);
+  std::vector<T> t((size_t)nb * n);
+  for (int ib = 0; ib < n; ib += nb) {
+    int iend = std::min(ib + nb, n), kb = iend - ib, width = n - ib;
+    int blocks = (width + nb - 1) / nb;
+    ForParts(blocks, (double)kb * nb * width, [&](int begin, int end) {
+      for (int jblock = begin; jblock < end; jblock++) {
+        int jb = ib + jblock * nb, jw = std::min(nb, n - jb);
+        Gemm(kb, jw, n - jb, T(1), a + ib * lda + jb, lda, 1,
+             a + jb * lda + jb, 1, lda, T(0), t.data() + (jb - ib), width);
+      }
+    });
+    for (int r = 0; r < kb; r++) {
+      std::copy(t.data() + (size_t)r * width,
+                t.data() + (size_t)r * width + width, a + (ib + r) * lda + ib);
+    }
+  }
+  for (int i = 1; i < n; i++) {
+    for (int j = 0; j < i; j++) a[i * lda + j] = a[j * lda + i];
+  }
+}
+
+template <typename T>
+bool QrFactor(int m, int n, T* a, ptrdiff_t lda, T* tau, int nrhs, T* b,
+              ptrdiff_t ldb) {
+  std::vector<T> v1(kQrBlock * kQrBlock), t(kQrBlock * kQrBlock);
+  for (int k = 0; k < n; k += kQrBlock) {
+    int kend = std::min(k + kQrBlock, n), kb = kend - k, rows = m - k;
+    T* p = a + k * lda + k;
+    QrPanel(rows, kb, p, lda, tau + k);
+    if (kend == n && nrhs == 0) break;
+    QrBlock(rows, kb, p, lda, tau + k, v1.data(), t.data());
+    QrApplyBlock(rows, kb, p, lda, v1.data(), t.data(), p + kb, lda, n - kend,
+                 true);
+    if (nrhs > 0) {
+      QrApplyBlock(rows, kb, p, lda, v1.data(), t.data(), b + k * ldb, ldb,
+                   nrhs, true);
+    }
+  }
+  T scale = 0;
+  for (int j = 0; j < n; j++) {
+    scale = std::max(scale, std::fabs(a[j * lda + j]));
+  }
+  const T tol = std::max(m, n) * kEps<T> * scale;
+  for (int j = 0; j < n; j++) {
+    if (!(std::fabs(a[j * lda + j]) > tol)) return false;
+  }
+  return true;
+}
+
+template <typename T>
+void QrApplyQt(int m, int n, int nrhs, const T* a, ptrdiff_t lda,
+               const T* tau, T* b, ptrdiff_t ldb) {
+  std::vector<T> v1(kQrBlock * kQrBlock), t(kQrBlock * kQrBlock);
+  for (int k = 0; k < n; k += kQrBlock) {
+    int kb = std::min(kQrBlock, n - k), rows = m - k;
+    const T* p = a + k * lda + k;
+    QrBlock(rows, kb, p, lda, tau + k, v1.data(), t.data());
+    QrApplyBlock(rows, kb, p, lda, v1.data(), t.data(), b + k * ldb, ldb,
+                 nrhs, true);
+  }
+}
+
+template <typename T>
+void QrFormQ(int m, int n, const T* a, ptrdiff_t lda, const T* tau, T* q,
+             ptrdiff_t ldq) {
+  for (int i = 0; i < m; i++) {
+    std::fill(q + i * ldq, q + i * ldq + n, T(0));
+    if (i < n) q[i * ldq + i] = 1;
+  }
+  // Блок k меняет только строки k..m-1, а в столбцах левее k эти строки
+  // пока нулевые
+  std::vector<T> v1(kQrBlock * kQrBlock), t(kQrBlock * kQrBlock);
+  int last = n == 0 ? -1 : (n - 1) / kQrBlock * kQrBlock;
+  for (int k = last; k >= 0; k -= kQrBlock) {
+    int kb = std::min(kQrBlock, n - k), rows = m - k;
+    const T* p = a + k * lda + k;
+    QrBlock(rows, kb, p, lda, tau + k, v1.data(), t.data());
+    QrApplyBlock(rows, kb, p, lda, v1.data(), t.data(), q + k * ldq + k, ldq,
+                 n - k, false);
+  }
+}
+
+template <typename T>
+void SingularCofactors(int n, T* a, ptrdiff_t lda, T* c,
+                       ptrdiff_t ldc) {
+  const BasicSimdKernels<T>& simd = Simd<T>();
+  std::vector<int> p(n), q(n);
+  for (int i = 0; i < n; i++) p[i] = q[i] = i;
+  int sign = 1, rank = 0;
+  T tol = 0;
+  for (int k = 0; k < n; k++) {
+    int pi = k, pj = k;
+    T best = -1;
+    for (int i = k; i < n; i++) {
+      const T* row = a + i * lda;
+      for (int j = k; j < n; j++) {
+        if (std::fabs(row[j]) > best) {
+          best = std::fabs(row[j]);
+          pi = i;
+          pj = j;
+        }
+      }
+    }
+    if (k == 0) tol = n * kEps<T> * best;
+    if (best <= tol) break;
+    if (pi != k) {
+      std::swap_ranges(a + k * lda, a + k * lda + n, a + pi * lda);
+      std::swap(p[k], p[pi]);
+      sign = -sign;
+    }
+    if (pj != k) {
+      for (int i = 0; i < n; i++) std::swap(a[i * lda + k], a[i * lda + pj]);
+      std::swap(q[k], q[pj]);
+      sign = -sign;
+    }
+    rank++;
+    const T* pivot_row = a + k * lda;
+    for (int i = k + 1; i < n; i++) {
+      T* row = a + i * lda;
+      T l = row[k] / pivot_row[k];
+      row[k] = l;
+      if (l != 0) simd.axpy(row + k + 1, -l, pivot_row + k + 1, n - k - 1);
+    }
+  }
+  for (int i = 0; i < n; i++) std::fill(c + i * ldc, c + i * ldc + n, T(0));
+  // Матрица уже признана вырожденной, поэтому последний ведущий элемент
+  // считается нулевым даже при формально полном ранге
+  if (std::min(rank, n - 1) == n - 1) {
+    T det11 = sign;
+    for (int i = 0; i < n - 1; i++) det11 *= a[i * lda + i];
+    // U * x = 0 при x[n - 1] = 1, L^T * y = e_n
+    std::vector<T> x(n), y(n);
+    x[n - 1] = y[n - 1] = 1;
+    for (int i = n - 2; i >= 0; i--) {
+      const T* row = a + i * lda;
+      T sum_x = 0, sum_y = 0;
+      for (int j = i + 1; j < n; j++) {
+        sum_x += row[j] * x[j];
+        sum_y += a[j * lda + i] * y[j];
+      }
+      x[i] = -sum_x / row[i];
+      y[i] = -sum_y;
+    }
+    for (int i = 0; i < n; i++) {
+      T* row = c + p[i] * ldc;
+      for (int j = 0; j < n; j++) row[q[j]] = det11 * y[i] * x[j];
+    }
+  }
+}
+
+void PivotsToPermutation(int n, const int* piv, int* perm) {
+  for (int i = 0; i < n; i++) perm[i] = i;
+  for (int j = 0; j < n; j++) std::swap(perm[j], perm[piv[j]]);
+}
+
+#define S21_LINALG_INSTANTIATE(T)                                           \
+  template int LuFactor(int, T*, ptrdiff_t, int*);                          \
+  template void LuInvert(int, T*, ptrdiff_t, const int*);                   \
+  template void LuSolve(int, int, const T*, ptrdiff_t, const int*, T*,      \
+                        ptrdiff_t);                                         \
+  template bool MixedPrecisionSolve(int, int, const T*, ptrdiff_t,          \
+                                    const T*, ptrdiff_t, T*, ptrdiff_t);    \
+  template bool CholeskyFactor(int, T*, ptrdiff_t);                         \
+  template void CholeskySolve(int, int, const T*, ptrdiff_t, T*,            \
+                              ptrdiff_t);                                   \
+  template void CholeskyInvert(int, T*, ptrdiff_t);                         \
+  template void UpperSolve(int, int, const T*, ptrdiff_t, T*, ptrdiff_t);   \
+  template bool QrFactor(int, int, T*, ptrdiff_t, T*, int, T*, ptrdiff_t);  \
+  template void QrApplyQt(int, int, int, const T*, ptrdiff_t, const T*, T*, \
+                          ptrdiff_t);                                       \
+  template void QrFormQ(int, int, const T*, ptrdiff_t, const T*, T*,        \
+                        ptrdiff_t);                                         \
+  template void SingularCofactors(int, T*, ptrdiff_t, T*, ptrdiff_t);
+
+S21_LINALG_INSTANTIATE(float)
+S21_LINALG_INSTANTIATE(double)
+S21_LINALG_INSTANTIATE(long double)
+
+#undef S21_LINALG_INSTANTIATE
+
+}  // namespace s21
@@ -0,0 +1,162 @@
+#ifndef __S21LINALG_H__
+#define __S21LINALG_H__
+
+#include <cstddef>
+
+namespace s21 {
+
+// Функции определены для T = float, double, long double
+
+/**
+ * @brief LU-разложение с частичным выбором ведущего элемента: P * A = L * U
+ * Работает на месте над квадратной row-major матрицей n x n: под диагональю
+ * остается L (с единичной диагональю, она не хранится), на диагонали и выше -
+ * U. Большие матрицы раскладываются блоками, обновление хвоста идет через
+ * Gemm
+ * @param piv Массив длины n: на шаге j строка j была переставлена со строкой
+ * piv[j] (как ipiv в LAPACK)
+ * @return Знак перестановки (1 или -1), 0 - матрица вырождена: ведущий
+ * элемент пренебрежимо мал относительно масштаба своего столбца (порог
+ * n * eps типа T)
+ */
+template <typename T>
+int LuFactor(int n, T* a, ptrdiff_t lda, int* piv);
+
+/**
+ * @brief Обращает матрицу на месте по ее LU-разложению (после LuFactor)
+ * Сначала обращается U, затем решается X * L = U^-1 блоками столбцов через
+ * Gemm, и в конце столбцы переставляются в обратном порядке. Матрица должна
+ * быть невырожденной. Дополнительная память - панель n x 64
+ */
+template <typename T>
+void LuInvert(int n, T* a, ptrdiff_t lda, const int* piv);
+
+/**
+ * @brief Решает A * X = B на месте B по LU-разложению A (после LuFactor)
+ * B - row-major n x nrhs. Строки B переставляются по piv, затем прямая
+ * подстановка с L и обратная с U идут блоками по 64 строки: внутри блока -
+ * построчные axpy по правым частям, остальные строки B обновляются одним Gemm
+ * на блок. Матрица должна быть невырожденной
+ */
+template <typename T>
+void LuSolve(int n, int nrhs, const T* a, ptrdiff_t lda, const int* piv,
+             T* b, ptrdiff_t ldb);
+
+/**
+ * @brief Решает U * X = B на месте B, где U - верхний треугольник a (n x n,
+ * ниже диагонали не читается): блоки по 64 строки снизу вверх, остальные
+ * строки B обновляются одним Gemm на блок
+ */
+template <typename T>
+void UpperSolve(int n, int nrhs, const T* a, ptrdiff_t lda, T* b,
+                ptrdiff_t ldb);
+
+// Как решать систему в S21BasicMatrix::Solve
+enum class SolveMode {
+  kDirect,          // LU и подстановки в типе матрицы
+  kMixedPrecision,  // LU в float, уточнение решения в типе матрицы
+};
+
+/**
+ * @brief Решение A * X = B со смешанной точностью (как dsgesv в LAPACK)
+ * A раскладывается в float (вдвое дешевле по времени и памяти, чем в
+ * double), затем решение уточняется: невязка R = B - A * X считается в T,
+ * поправка - по float-разложению. Итерации останавливаются, когда для
+ * каждого столбца max|R| <= max|X| * ||A||_inf * eps(T) * sqrt(n)
+ * @param x Результат n x nrhs
+ * @return false - float-разложение вырождено или уточнение не сошлось за 30
+ * итераций (плохо обусловленная матрица); тогда решать надо напрямую в T
+ */
+template <typename T>
+bool MixedPrecisionSolve(int n, int nrhs, const T* a, ptrdiff_t lda,
+                         const T* b, ptrdiff_t ldb, T* x, ptrdiff_t ldx);
+
+/**
+ * @brief Разложение Холецкого A = L * L^T на месте
+ * Читается только нижний треугольник симметричной матрицы n x n; на его
+ * месте остается L, выше диагонали - нули. Вдвое дешевле LU: блоки по 192
+ * столбца, панель L21 = A21 * L11^-T - один Gemm, хвост обновляется только
+ * в нижнем треугольнике (Gemm по блокам столбцов в пуле потоков)
+ * @return false - матрица не положительно определена: очередной
+ * диагональный элемент не больше n * eps * max A_ii (содержимое a тогда не
+ * определено)
+ */
+template <typename T>
+bool CholeskyFactor(int n, T* a, ptrdiff_t lda);
+
+/**
+ * @brief Решает A * X = B на месте B по разложению Холецкого (после
+ * CholeskyFactor): L * Y = B, затем L^T * X = Y, блоками как в LuSolve
+ */
+template <typename T>
+void CholeskySolve(int n, int nrhs, const T* a, ptrdiff_t lda, T* b,
+                   ptrdiff_t ldb);
+
+/**
+ * @brief Обращает матрицу по ее разложению Холецкого (после CholeskyFactor)
+ * A^-1 = W * W^T, где W = (L^T)^-1: L транспонируется и обращается как
+ * верхняя треугольная, затем считается только верхний треугольник W * W^T
+ * (Gemm по блокам) и отражается вниз. Вместе с разложением - n^3 операций
+ * против 2 * n^3 у LuFactor + LuInvert. Дополнительная память - панель
+ * 64 x n
+ */
+template <typename T>
+void CholeskyInvert(int n, T* a, ptrdiff_t lda);
+
+/**
+ * @brief QR-разложение Хаусхолдера A = Q * R матрицы m x n (m >= n) на месте
+ * На диагонали и выше остается R, под диагональю - векторы отражений v_j
+ * (v_j[j] = 1 не хранится), tau[j] - их коэффициенты: H_j = I - tau * v * v^T,
+ * Q = H_0 * ... * H_{n-1} (как geqrf в LAPACK). Столбцы обрабатываются
+ * панелями по 32: панель раскладывается рекурсивно (по одному столбцу -
+ * только полосы по 8 столбцов, проходы по строкам делятся между потоками),
+ * затем ее отражения собираются в блок I - V * T * V^T (WY-представление),
+ * и хвост матрицы обновляется тремя Gemm. Суммы по строкам (V^T * C)
+ * считаются по частям строк в пуле потоков, поэтому высокие матрицы
+ * (миллионы строк) тоже считаются параллельно. Дополнительная память -
+ * плотная копия полосы m x 8 и O(32 * (n + nrhs)) на поток
+ * @param b Если nrhs > 0, к B (m x nrhs) по ходу разложения применяется Q^T
+ * @return false - столбцы A линейно зависимы: |R_jj| <= max(m, n) * eps *
+ * max|R_ii|
+ */
+template <typename T>
+bool QrFactor(int m, int n, T* a, ptrdiff_t lda, T* tau, int nrhs = 0,
+              T* b = nullptr, ptrdiff_t ldb = 0);
+
+/**
+ * @brief B (m x nrhs) = Q^T * B по результату QrFactor: те же блочные
+ * отражения, что применяет к B сам QrFactor
+ */
+template <typename T>
+void QrApplyQt(int m, int n, int nrhs, const T* a, ptrdiff_t lda,
+               const T* tau, T* b, ptrdiff_t ldb);
+
+/**
+ * @brief Явные первые n столбцов Q (m x n) по результату QrFactor теми же
+ * блочными отражениями, в обратном порядке
+ */
+template <typename T>
+void QrFormQ(int m, int n, const T* a, ptrdiff_t lda, const T* tau, T* q,
+             ptrdiff_t ldq);
+
+/**
+ * @brief Матрица алгебраических дополнений вырожденной матрицы, O(n^3)
+ * Матрица раскладывается с полным выбором ведущего элемента P * A * Q = L * U.
+ * При ранге n - 1 присоединенная матрица имеет ранг 1:
+ * adj(A) = det(P) * det(Q) * det(U11) * Q * x * y^T * P, где x - ядро U,
+ * y - решение L^T * y = e_n. При ранге меньше n - 1 все дополнения равны 0
+ * @param a Рабочая копия матрицы (портится)
+ * @param c Результат: матрица алгебраических дополнений n x n
+ */
+template <typename T>
+void SingularCofactors(int n, T* a, ptrdiff_t lda, T* c, ptrdiff_t ldc);
+
+/**
+ * @brief Переводит последовательность перестановок piv в перестановку строк:
+ * perm[i] - номер строки исходной матрицы, стоящей в строке i матрицы P * A
+ */
+void PivotsToPermutation(int n, const int* piv, int* perm);
+
+}  // namespace s21
+
+#endif
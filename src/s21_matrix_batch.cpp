@@ -0,0 +1,626 @@
+#include "s21_matrix_batch.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "s21_closed_form.h"
+#include "s21_simd.h"
+#include "s21_thread_pool.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define S21_BATCH_X86 1
+#endif
+
+namespace {
+
+// Начиная с этого объема работы (число матриц x операций на матрицу) пакет
+// делится на части между потоками пула
+constexpr double kBatchParallel = 1 << 18;
+// Матриц в одной части для ядер по плоскостям (кратно kLanes)
+constexpr size_t kLaneChunk = 4096;
+// Элементов в одной части для поэлементных операций над всем буфером
+constexpr size_t kElementChunk = 1 << 16;
+
+#define S21_LANE_INLINE inline __attribute__((always_inline))
+
+//-------------Ядра по плоскостям-------------------
+
+// V - T или векторный тип GCC из элементов T; векторы не возвращаются по
+// значению, чтобы не менять ABI вне target-функций
+template <typename V, typename T>
+S21_LANE_INLINE void Load(const T* p, V& v) {
+  memcpy(&v, p, sizeof(V));
+}
+
+template <typename V, typename T>
+S21_LANE_INLINE void Store(T* p, const V& v) {
+  memcpy(p, &v, sizeof(V));
+}
+
+/**
+ * @brief Определители пакета матриц N x N
+ */
+template <typename T, int N>
+struct DetKernel {
+  using value_type = T;
+  const T* a;
+  size_t stride;
+  T* det;
+
+  template <typename V>
+  S21_LANE_INLINE void run(size_t k) const {
+    V m[N * N], d;
+    for (int e = 0; e < N * N; e++) Load(a + e * stride + k, m[e]);
+    s21::ClosedFormDetAdj<N, false, V>(m, d, nullptr);
+    Store(det + k, d);
+  }
+};
+
+/**
+ * @brief Обратные матрицы пакета N x N: inv = adj(a) / det. В bad
+ * записывается 1 для вырожденных матриц: |det| не больше
+ * N * eps * (произведение максимумов модулей по столбцам), как в
+ * S21FixedMatrix
+ */
+template <typename T, int N>
+struct InverseKernel {
+  using value_type = T;
+  const T* a;
+  T* inv;
+  size_t stride;
+  T* bad;
+
+  template <typename V>
+  S21_LANE_INLINE void run(size_t k) const {
+    V m[N * N], r[N * N], det;
+    for (int e = 0; e < N * N; e++) Load(a + e * stride + k, m[e]);
+    s21::ClosedFormDetAdj<N, true, V>(m, det, r);
+    const V zero = m[0] * 0, one = zero + 1;
+    V scale = one;
+    for (int j = 0; j < N; j++) {
+      V col_max = zero;
+      for (int i = 0; i < N; i++) {
+        V x = m[i * N + j];
+        x = x < 0 ? -x : x;
+        col_max = x > col_max ? x : col_max;
+      }
+      scale *= col_max;
+    }
+    V abs_det = det < 0 ? -det : det;
+    const T eps = N * std::numeric_limits<T>::epsilon();
+    V singular = abs_det <= eps * scale ? one : zero;
+    Store(bad + k, singular);
+    V inv_det = one / det;
+    for (int e = 0; e < N * N; e++) Store(inv + e * stride + k, r[e] * inv_det);
+  }
+};
+
+/**
+ * @brief Пакет произведений (m x p) * (p x n). Умножение и сложение
+ * раздельно, поэтому результат не зависит от уровня SIMD
+ */
+template <typename T>
+struct MulKernel {
+  using value_type = T;
+  const T* a;
+  const T* b;
+  T* c;
+  size_t stride;
+  int m, n, p;
+
+  template <typename V>
+  S21_LANE_INLINE void run(size_t k) const {
+    for (int i = 0; i < m; i++) {
+      for (int j = 0; j < n; j++) {
+        V acc, x, y;
+        Load(a + (size_t)i * p * stride + k, x);
+        Load(b + (size_t)j * stride + k, y);
+        acc = x * y;
+        for (int q = 1; q < p; q++) {
+          Load(a + (size_t)(i * p + q) * stride + k, x);
+          Load(b + (size_t)(q * n + j) * stride + k, y);
+          acc += x * y;
+        }
+        Store(c + (size_t)(i * n + j) * stride + k, acc);
+      }
+    }
+  }
+};
+
+//-------------Запуск по уровням SIMD-------------------
+
+template <typename V, typename F>
+S21_LANE_INLINE void LaneLoop(const F& f, size_t begin, size_t end) {
+  const size_t width = sizeof(V) / sizeof(typename F::value_type);
+  for (size_t k = begin; k < end; k += width) f.template run<V>(k);
+}
+
+template <typename F>
+void LanesScalar(const F& f, size_t begin, size_t end) {
+  LaneLoop<typename F::value_type>(f, begin, end);
+}
+
+#ifdef S21_BATCH_X86
+template <typename F>
+__attribute__((target("sse2"))) void LanesSse2(const F& f, size_t begin,
+                                               size_t end) {
+  LaneLoop<typename s21::ExprVec<typename F::value_type, 16>::type>(f, begin,
+                                                                    end);
+}
+
+template <typename F>
+__attribute__((target("avx2"))) void LanesAvx2(const F& f, size_t begin,
+                                               size_t end) {
+  LaneLoop<typename s21::ExprVec<typename F::value_type, 32>::type>(f, begin,
+                                                                    end);
+}
+
+template <typename F>
+__attribute__((target("avx512f"))) void LanesAvx512(const F& f, size_t begin,
+                                                    size_t end) {
+  LaneLoop<typename s21::ExprVec<typename F::value_type, 64>::type>(f, begin,
+                                                                    end);
+}
+#endif
+
+/**
+ * @brief Делит [0, n) на части по chunk между потоками пула, если объем
+ * работы work достаточно велик, иначе вызывает fn(0, n) в текущем потоке
+ */
+template <typename Fn>
+void ForParts(size_t n, size_t chunk, double work, const Fn& fn) {
+  int threads = S21ThreadPool::ThreadCount();
+  if (threads < 2 || work < kBatchParallel || n <= chunk) {
+    fn(0, n);
+    return;
+  }
+  int parts = (int)((n + chunk - 1) / chunk);
+  S21ThreadPool::Instance().ParallelFor(parts, [&](int part) {
+    size_t begin = (size_t)part * chunk;
+    fn(begin, std::min(n, begin + chunk));
+  });
+}
+
+/**
+ * @brief Запускает ядро f на матрицах [0, stride) векторами активного уровня
+ * SIMD. stride кратен kLanes, поэтому хвоста нет
+ */
+template <typename F>
+void RunLanes(const F& f, size_t stride, double work) {
+  using T = typename F::value_type;
+  ForParts(stride, kLaneChunk, work, [&f](size_t begin, size_t end) {
+#ifdef S21_BATCH_X86
+    if constexpr (std::is_same<T, float>::value ||
+                  std::is_same<T, double>::value) {
+      switch (s21::Simd<T>().level) {
+        case s21::kSimdAvx512:
+          LanesAvx512(f, begin, end);
+          return;
+        case s21::kSimdAvx2:
+          LanesAvx2(f, begin, end);
+          return;
+        case s21::kSimdSse2:
+          LanesSse2(f, begin, end);
+          return;
+        default:
+          break;
+      }
+    }
+#endif
+    LanesScalar(f, begin, end);
+  });
+}
+
+}  // namespace
+
+//-------------Конструкторы-------------------
+
+/**
+ * @brief Пакет из count нулевых матриц rows x cols
+ */
+template <typename T>
+S21BasicMatrixBatch<T>::S21BasicMatrixBatch(int count, int rows, int cols)
+    : count_(count), rows_(rows), cols_(cols) {
+  if (count <= 0 || rows <= 0 || cols <= 0) Matrix::not_exist();
+  allocate_mem();
+  std::fill(data_, data_ + size(), T(0));
+}
+
+/**
+ * @brief Импорт из массива матриц одного размера (AoS -> SoA)
+ */
+template <typename T>
+S21BasicMatrixBatch<T>::S21BasicMatrixBatch(const std::vector<Matrix>& matrices)
+    : S21BasicMatrixBatch(matrices.data(), (int)matrices.size()) {}
+
+template <typename T>
+S21BasicMatrixBatch<T>::S21BasicMatrixBatch(const Matrix* matrices, int count)
+    : S21BasicMatrixBatch(count, count > 0 ? matrices[0].acc_rows() : 0,
+                          count > 0 ? matrices[0].acc_cols() : 0) {
+  for (int b = 0; b < count; b++) {
+    if (matrices[b].acc_rows() != rows_ || matrices[b].acc_cols() != cols_) {
+      Matrix::not_same_size();
+    }
+  }
+  const int elements = rows_ * cols_;
+  ForParts(count_, kLaneChunk, (double)count_ * elements,
+           [&](size_t begin, size_t end) {
+             for (size_t b = begin; b < end; b++) {
+               const T* src = matrices[b].data();
+               for (int e = 0; e < elements; e++) {
+                 data_[e * stride_ + b] = src[e];
+               }
+             }
+           });
+}
+
+template <typename T>
+S21BasicMatrixBatch<T>::S21BasicMatrixBatch(const S21BasicMatrixBatch& other)
+    : count_(other.count_), rows_(other.rows_), cols_(other.cols_) {
+  allocate_mem();
+  s21::Simd<T>().copy(data_, other.data_, size());
+}
+
+template <typename T>
+S21BasicMatrixBatch<T>::S21BasicMatrixBatch(
+    S21BasicMatrixBatch&& other) noexcept
+    : count_(other.count_),
+      rows_(other.rows_),
+      cols_(other.cols_),
+      stride_(other.stride_),
+      data_(other.data_),
+      alloc_(other.alloc_) {
+  other.data_ = nullptr;
+  other.count_ = other.rows_ = other.cols_ = 0;
+  other.stride_ = 0;
+}
+
+template <typename T>
+S21BasicMatrixBatch<T>::~S21BasicMatrixBatch() {
+  release();
+}
+
+template <typename T>
+S21BasicMatrixBatch<T>& S21BasicMatrixBatch<T>::operator=(
+    const S21BasicMatrixBatch& other) {
+  if (this == &other) return *this;
+  if (size() != other.size()) {
+    S21BasicMatrixBatch temp(other);
+    return *this = std::move(temp);
+  }
+  count_ = other.count_;
+  rows_ = other.rows_;
+  cols_ = other.cols_;
+  stride_ = other.stride_;
+  s21::Simd<T>().copy(data_, other.data_, size());
+  return *this;
+}
+
+template <typename T>
+S21BasicMatrixBatch<T>& S21BasicMatrixBatch<T>::operator=(
+    S21BasicMatrixBatch&& other) noexcept {
+  if (this != &other) {
+    release();
+    count_ = other.count_;
+    rows_ = other.rows_;
+    cols_ = other.cols_;
+    stride_ = other.stride_;
+    data_ = other.data_;
+    alloc_ = other.alloc_;
+    other.data_ = nullptr;
+    other.count_ = other.rows_ = other.cols_ = 0;
+    other.stride_ = 0;
+  }
+  return *this;
+}
+
+template <typename T>
+T& S21BasicMatrixBatch<T>::operator()(int index, int i, int j) {
+  if (index < 0 || index >= count_ || i < 0 || i >= rows_ || j < 0 ||
+      j >= cols_) {
+    Matrix::not_range();
+  }
+  return data_[plane_offset(i, j) + index];
+}
+
+//-------------Импорт и экспорт-------------------
+
+/**
+ * @brief Копия матрицы index пакета
+ */
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrixBatch<T>::matrix(int index) const {
+  if (index < 0 || index >= count_) Matrix::not_range();
+  Matrix m(rows_, cols_);
+  T* dst = m.data();
+  for (int e = 0; e < rows_ * cols_; e++) dst[e] = data_[e * stride_ + index];
+  return m;
+}
+
+template <typename T>
+void S21BasicMatrixBatch<T>::set_matrix(int index, const Matrix& m) {
+  if (index < 0 || index >= count_) Matrix::not_range();
+  if (m.acc_rows() != rows_ || m.acc_cols() != cols_) Matrix::not_same_size();
+  const T* src = m.data();
+  for (int e = 0; e < rows_ * cols_; e++) data_[e * stride_ + index] = src[e];
+}
+
+/**
+ * @brief Экспорт в массив матриц (SoA -> AoS)
+ */
+template <typename T>
+std::vector<S21BasicMatrix<T>> S21BasicMatrixBatch<T>::ToMatrices() const {
+  std::vector<Matrix> matrices(count_, Matrix(rows_, cols_));
+  ToMatrices(matrices.data());
+  return matrices;
+}
+
+/**
+ * @brief Экспорт в count() уже созданных матриц; матрицы другого размера
+ * пересоздаются
+ */
+template <typename T>
+void S21BasicMatrixBatch<T>::ToMatrices(Matrix* out) const {
+  for (int b = 0; b < count_; b++) {
+    if (out[b].acc_rows() != rows_ || out[b].acc_cols() != cols_) {
+      out[b] = Matrix(rows_, cols_);
+    }
+  }
+  const int elements = rows_ * cols_;
+  ForParts(count_, kLaneChunk, (double)count_ * elements,
+           [&](size_t begin, size_t end) {
+             for (size_t b = begin; b < end; b++) {
+               T* dst = out[b].data();
+               for (int e = 0; e < elements; e++) {
+                 dst[e] = data_[e * stride_ + b];
+               }
+             }
+           });
+}
+
+//-------------Операции над пакетами-------------------
+
+/**
+ * @brief Все матрицы пакетов попарно равны с точностью S21Tolerance<T>
+ */
+template <typename T>
+bool S21BasicMatrixBatch<T>::EqMatrix(const S21BasicMatrixBatch& other) const {
+  check_same(other);
+  const s21::BasicSimdKernels<T>& simd = s21::Simd<T>();
+  bool equal = true;
+  for (int e = 0; e < rows_ * cols_ && equal; e++) {
+    equal = simd.equal(data_ + e * stride_, other.data_ + e * stride_, count_,
+                       S21Tolerance<T>::value);
+  }
+  return equal;
+}
+
+template <typename T>
+void S21BasicMatrixBatch<T>::SumMatrix(const S21BasicMatrixBatch& other) {
+  check_same(other);
+  const s21::BasicSimdKernels<T>& simd = s21::Simd<T>();
+  ForParts(size(), kElementChunk, size(), [&](size_t begin, size_t end) {
+    simd.add(data_ + begin, other.data_ + begin, end - begin);
+  });
+}
+
+template <typename T>
+void S21BasicMatrixBatch<T>::SubMatrix(const S21BasicMatrixBatch& other) {
+  check_same(other);
+  const s21::BasicSimdKernels<T>& simd = s21::Simd<T>();
+  ForParts(size(), kElementChunk, size(), [&](size_t begin, size_t end) {
+    simd.sub(data_ + begin, other.data_ + begin, end - begin);
+  });
+}
+
+template <typename T>
+void S21BasicMatrixBatch<T>::MulNumber(const T num) {
+  const s21::BasicSimdKernels<T>& simd = s21::Simd<T>();
+  ForParts(size(), kElementChunk, size(), [&](size_t begin, size_t end) {
+    simd.scale(data_ + begin, num, end - begin);
+  });
+}
+
+/**
+ * @brief Пакет произведений: матрица i результата = (*this)[i] * other[i]
+ * @param other Пакет того же числа матриц, cols() x k
+ */
+template <typename T>
+S21BasicMatrixBatch<T> S21BasicMatrixBatch<T>::MulMatrix(
+    const S21BasicMatrixBatch& other) const {
+  if (count_ != other.count_) Matrix::not_same_size();
+  if (cols_ != other.rows_) Matrix::not_equal();
+  S21BasicMatrixBatch res(count_, rows_, other.cols_);
+  MulKernel<T> kernel{data_,   other.data_, res.data_, stride_,
+                      rows_,   other.cols_, cols_};
+  RunLanes(kernel, stride_, (double)count_ * rows_ * cols_ * other.cols_);
+  return res;
+}
+
+/**
+ * @brief Пакет транспонированных матриц: плоскости переставляются целиком
+ */
+template <typename T>
+S21BasicMatrixBatch<T> S21BasicMatrixBatch<T>::Transpose() const {
+  S21BasicMatrixBatch res(count_, cols_, rows_);
+  const s21::BasicSimdKernels<T>& simd = s21::Simd<T>();
+  for (int i = 0; i < rows_; i++) {
+    for (int j = 0; j < cols_; j++) {
+      simd.copy(res.plane(j, i), plane(i, j), stride_);
+    }
+  }
+  return res;
+}
+
+/**
+ * @brief Определители всех матриц пакета. До 4x4 - явные формулы по
+ * плоскостям, больше - LU-разложение каждой матрицы (S21Matrix::Determinant)
+ */
+template <typename T>
+std::vector<T> S21BasicMatrixBatch<T>::Determinant() const {
+  if (rows_ != cols_) Matrix::not_square();
+  std::vector<T> det(stride_);
+  const double work = (double)count_ * rows_ * rows_ * rows_;
+  switch (rows_) {
+    case 1:
+      RunLanes(DetKernel<T, 1>{data_, stride_, det.data()}, stride_, work);
+      break;
+    case 2:
+      RunLanes(DetKernel<T, 2>{data_, stride_, det.data()}, stride_, work);
+      break;
+    case 3:
+      RunLanes(DetKernel<T, 3>{data_, stride_, det.data()}, stride_, work);
+      break;
+    case 4:
+      RunLanes(DetKernel<T, 4>{data_, stride_, det.data()}, stride_, work);
+      break;
+    default:
+      ForParts(count_, kLaneChunk, work, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; b++) {
+          det[b] = matrix((int)b).Determinant();
+        }
+      });
+  }
+  det.resize(count_);
+  return det;
+}
+
+/**
+ * @brief Пакет обратных матриц. До 4x4 - присоединенная матрица, деленная
+ * на определитель, по плоскостям; больше - S21Matrix::InverseMatrix для
+ * каждой матрицы. Исключение, если хотя бы одна матрица вырождена
+ */
+template <typename T>
+S21BasicMatrixBatch<T> S21BasicMatrixBatch<T>::InverseMatrix() const {
+  if (rows_ != cols_) Matrix::not_square();
+  S21BasicMatrixBatch res(count_, rows_, cols_);
+  std::vector<T> bad(stride_);
+  const double work = (double)count_ * rows_ * rows_ * rows_;
+  switch (rows_) {
+    case 1:
+      RunLanes(InverseKernel<T, 1>{data_, res.data_, stride_, bad.data()},
+               stride_, work);
+      break;
+    case 2:
+      RunLanes(InverseKernel<T, 2>{data_, res.data_, stride_, bad.data()},
+               stride_, work);
+      break;
+    case 3:
+      RunLanes(InverseKernel<T, 3>{data_, res.data_, stride_, bad.data()},
+               stride_, work);
+      break;
+    case 4:
+      RunLanes(InverseKernel<T, 4>{data_, res.data_, stride_, bad.data()},
+               stride_, work);
+      break;
+    default:
+      ForParts(count_, kLaneChunk, work, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; b++) {
+          res.set_matrix((int)b, matrix((int)b).InverseMatrix());
+        }
+      });
+  }
+  if (std::any_of(bad.begin(), bad.begin() + count_,
+                  [](T flag) { return flag != 0; })) {
+    Matrix::null_determinant();
+  }
+  // Дополнение плоскостей (матрицы из нулей) снова обнуляется
+  for (int e = 0; e < rows_ * cols_; e++) {
+    std::fill(res.data_ + e * stride_ + count_, res.data_ + (e + 1) * stride_,
+              T(0));
+  }
+  return res;
+}
+
+//-------------Перегрузки-------------------
+
+template <typename T>
+bool S21BasicMatrixBatch<T>::operator==(
+    const S21BasicMatrixBatch& other) const {
+  return EqMatrix(other);
+}
+
+template <typename T>
+S21BasicMatrixBatch<T> S21BasicMatrixBatch<T>::operator+(
+    const S21BasicMatrixBatch& other) const {
+  S21BasicMatrixBatch res(*this);
+  res.SumMatrix(other);
+  return res;
+}
+
+template <typename T>
+S21BasicMatrixBatch<T> S21BasicMatrixBatch<T>::operator-(
+    const S21BasicMatrixBatch& other) const {
+  S21BasicMatrixBatch res(*this);
+  res.SubMatrix(other);
+  return res;
+}
+
+template <typename T>
+S21BasicMatrixBatch<T> S21BasicMatrixBatch<T>::operator*(
+    const S21BasicMatrixBatch& other) const {
+  return MulMatrix(other);
+}
+
+template <typename T>
+S21BasicMatrixBatch<T> S21BasicMatrixBatch<T>::operator*(T num) const {
+  S21BasicMatrixBatch res(*this);
+  res.MulNumber(num);
+  return res;
+}
+
+template <typename T>
+S21BasicMatrixBatch<T>& S21BasicMatrixBatch<T>::operator+=(
+    const S21BasicMatrixBatch& other) {
+  SumMatrix(other);
+  return *this;
+}
+
+template <typename T>
+S21BasicMatrixBatch<T>& S21BasicMatrixBatch<T>::operator-=(
+    const S21BasicMatrixBatch& other) {
+  SubMatrix(other);
+  return *this;
+}
+
+template <typename T>
+S21BasicMatrixBatch<T>& S21BasicMatrixBatch<T>::operator*=(T num) {
+  MulNumber(num);
+  return *this;
+}
+
+//-------------Память-------------------
+
+/**
+ * @brief Один выровненный буфер на все плоскости, у текущего аллокатора
+ * потока (см. s21_allocator.h)
+ */
+template <typename T>
+void S21BasicMatrixBatch<T>::allocate_mem() {
+  stride_ = ((size_t)count_ + kLanes - 1) / kLanes * kLanes;
+  alloc_ = S21Allocator::Current();
+  data_ = static_cast<T*>(alloc_->Allocate(size() * sizeof(T)));
+}
+
+template <typename T>
+void S21BasicMatrixBatch<T>::release() {
+  if (data_) {
+    alloc_->Deallocate(data_, size() * sizeof(T));
+    data_ = nullptr;
+  }
+}
+
+template <typename T>
+void S21BasicMatrixBatch<T>::check_same(
+    const S21BasicMatrixBatch& other) const {
+  if (count_ != other.count_ || rows_ != other.rows_ ||
+      cols_ != other.cols_) {
+    Matrix::not_same_size();
+  }
+}
+
+template class S21BasicMatrixBatch<float>;
+template class S21BasicMatrixBatch<double>;
+template class S21BasicMatrixBatch<long double>;
@@ -0,0 +1,103 @@
+#ifndef __S21MATRIXBATCH_H__
+#define __S21MATRIXBATCH_H__
+
+#include <cstddef>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+/**
+ * @brief Пакет из count матриц одного размера rows x cols в раскладке
+ * "структура массивов" (SoA): элемент (i, j) всех матриц пакета лежит подряд
+ * в своей плоскости plane(i, j). Операции идут сразу по плоскостям, поэтому
+ * вектор SIMD обрабатывает несколько матриц за раз, а большие пакеты
+ * делятся на части между потоками пула. Рассчитан на множество маленьких
+ * матриц (2x2, 3x3, 4x4): для них определитель и обратная матрица считаются
+ * явными формулами, матрицы больше 4x4 считаются по одной через
+ * LU-разложение. Плоскости дополнены до kLanes матриц (хвост не входит в
+ * результат). Определен для T = float, double, long double
+ */
+template <typename T>
+class S21BasicMatrixBatch {
+ public:
+  using value_type = T;
+  using Matrix = S21BasicMatrix<T>;
+
+  S21BasicMatrixBatch(int count, int rows, int cols);
+  // Импорт: все матрицы должны быть одного размера
+  explicit S21BasicMatrixBatch(const std::vector<Matrix>& matrices);
+  S21BasicMatrixBatch(const Matrix* matrices, int count);
+  S21BasicMatrixBatch(const S21BasicMatrixBatch& other);
+  S21BasicMatrixBatch(S21BasicMatrixBatch&& other) noexcept;
+  ~S21BasicMatrixBatch();
+
+  S21BasicMatrixBatch& operator=(const S21BasicMatrixBatch& other);
+  S21BasicMatrixBatch& operator=(S21BasicMatrixBatch&& other) noexcept;
+
+  // Accessors:
+  int count() const { return count_; }
+  int rows() const { return rows_; }
+  int cols() const { return cols_; }
+  // Плоскость элемента (i, j): count значений подряд, по одному на матрицу
+  T* plane(int i, int j) { return data_ + plane_offset(i, j); }
+  const T* plane(int i, int j) const { return data_ + plane_offset(i, j); }
+  // Элемент (i, j) матрицы index
+  T& operator()(int index, int i, int j);
+
+  // Import/export:
+  Matrix matrix(int index) const;
+  void set_matrix(int index, const Matrix& m);
+  std::vector<Matrix> ToMatrices() const;
+  void ToMatrices(Matrix* out) const;
+
+  // Operations (для каждой матрицы пакета):
+  bool EqMatrix(const S21BasicMatrixBatch& other) const;
+  void SumMatrix(const S21BasicMatrixBatch& other);
+  void SubMatrix(const S21BasicMatrixBatch& other);
+  void MulNumber(const T num);
+  // Пакет произведений: i-я матрица результата = (*this)[i] * other[i]
+  S21BasicMatrixBatch MulMatrix(const S21BasicMatrixBatch& other) const;
+  S21BasicMatrixBatch Transpose() const;
+  // Определители всех матриц пакета
+  std::vector<T> Determinant() const;
+  // Исключение, если хотя бы одна матрица вырождена
+  S21BasicMatrixBatch InverseMatrix() const;
+
+  // Overloads:
+  bool operator==(const S21BasicMatrixBatch& other) const;
+  S21BasicMatrixBatch operator+(const S21BasicMatrixBatch& other) const;
+  S21BasicMatrixBatch operator-(const S21BasicMatrixBatch& other) const;
+  S21BasicMatrixBatch operator*(const S21BasicMatrixBatch& other) const;
+  S21BasicMatrixBatch operator*(T num) const;
+  S21BasicMatrixBatch& operator+=(const S21BasicMatrixBatch& other);
+  S21BasicMatrixBatch& operator-=(const S21BasicMatrixBatch& other);
+  S21BasicMatrixBatch& operator*=(T num);
+
+  // Выравнивание числа матриц в плоскости: наибольшее число элементов в
+  // векторе (16 float в AVX-512)
+  static constexpr int kLanes = 16;
+
+ private:
+  size_t plane_offset(int i, int j) const {
+    return (size_t)(i * cols_ + j) * stride_;
+  }
+  size_t size() const { return (size_t)rows_ * cols_ * stride_; }
+  void allocate_mem();
+  void release();
+  void check_same(const S21BasicMatrixBatch& other) const;
+
+  int count_, rows_, cols_;
+  size_t stride_;  // длина плоскости: count_, округленное вверх до kLanes
+  T* data_;
+  S21Allocator* alloc_;
+};
+
+using S21MatrixBatch = S21BasicMatrixBatch<double>;
+using S21MatrixBatchF = S21BasicMatrixBatch<float>;
+using S21MatrixBatchLD = S21BasicMatrixBatch<long double>;
+
+extern template class S21BasicMatrixBatch<float>;
+extern template class S21BasicMatrixBatch<double>;
+extern template class S21BasicMatrixBatch<long double>;
+
+#endif
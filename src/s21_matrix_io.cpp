@@ -0,0 +1,575 @@
+#include "s21_matrix_io.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include "s21_thread_pool.h"
+
+namespace s21 {
+namespace {
+
+constexpr char kMagic[8] = {'S', '2', '1', 'M', 'A', 'T', 'R', 'X'};
+
+constexpr Endian kNativeEndian =
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ ? Endian::kLittle : Endian::kBig;
+
+// Тип элемента T в файле; long double определяется по разрядности мантиссы
+template <typename T>
+constexpr DType DTypeOf() {
+  if (std::is_same<T, float>::value) return DType::kFloat32;
+  if (std::numeric_limits<T>::digits == 53) return DType::kFloat64;
+  return std::numeric_limits<T>::digits == 64 ? DType::kFloat80
+                                              : DType::kFloat128;
+}
+
+// Байт на элемент типа dtype (0 - неизвестный тип). long double x87 хранится
+// с выравниванием платформы
+size_t ElemSize(DType dtype) {
+  switch (dtype) {
+    case DType::kFloat32:
+      return 4;
+    case DType::kFloat64:
+      return 8;
+    case DType::kFloat80:
+      return DTypeOf<long double>() == DType::kFloat80 ? sizeof(long double)
+                                                       : 16;
+    case DType::kFloat128:
+      return 16;
+  }
+  return 0;
+}
+
+[[noreturn]] void ThrowErrno(const char* what, const std::string& path) {
+  throw std::system_error(errno, std::generic_category(),
+                          std::string(what) + " " + path);
+}
+
+[[noreturn]] void BadFile(const std::string& path, const char* reason) {
+  throw std::runtime_error("Неверный файл матрицы " + path + ": " + reason);
+}
+
+/**
+ * @brief Дескриптор файла, закрываемый в деструкторе
+ */
+class File {
+ public:
+  File(const std::string& path, int flags) {
+    fd_ = ::open(path.c_str(), flags, 0644);
+    if (fd_ < 0) ThrowErrno("Не удалось открыть", path);
+  }
+  ~File() { ::close(fd_); }
+  File(const File&) = delete;
+  File& operator=(const File&) = delete;
+  int fd() const { return fd_; }
+
+ private:
+  int fd_;
+};
+
+// Полная запись и чтение с повтором после частичных операций и EINTR
+void WriteAll(int fd, const void* data, size_t bytes, const std::string& path) {
+  const char* p = static_cast<const char*>(data);
+  while (bytes > 0) {
+    ssize_t n = ::write(fd, p, bytes);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) ThrowErrno("Ошибка записи", path);
+    p += n;
+    bytes -= n;
+  }
+}
+
+void ReadAll(int fd, void* data, size_t bytes, off_t offset,
+             const std::string& path) {
+  char* p = static_cast<char*>(data);
+  while (bytes > 0) {
+    ssize_t n = ::pread(fd, p, bytes, offset);
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0) ThrowErrno("Ошибка чтения", path);
+    if (n == 0) BadFile(path, "файл короче, чем указано в заголовке");
+    p += n;
+    bytes -= n;
+    offset += n;
+  }
+}
+
+// Обратить порядок байт в count элементах по size байт
+void SwapBytes(void* data, size_t size, size_t count) {
+  unsigned char* p = static_cast<unsigned char*>(data);
+  for (size_t k = 0; k < count; k++, p += size) std::reverse(p, p + size);
+}
+
+template <typename U>
+void SwapField(U& value) {
+  SwapBytes(&value, sizeof(U), 1);
+}
+
+/**
+ * @brief Чтение и проверка заголовка открытого файла; поля приводятся к
+ * порядку байт платформы (endian остается порядком байт данных)
+ */
+MatrixFileHeader ReadHeader(const File& file, const std::string& path) {
+  struct stat st;
+  if (::fstat(file.fd(), &st) != 0) ThrowErrno("Ошибка чтения", path);
+  MatrixFileHeader h;
+  if ((size_t)st.st_size < sizeof(h)) BadFile(path, "нет заголовка");
+  ReadAll(file.fd(), &h, sizeof(h), 0, path);
+  if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) {
+    BadFile(path, "неизвестная сигнатура");
+  }
+  if (h.endian != Endian::kLittle && h.endian != Endian::kBig) {
+    BadFile(path, "неизвестный порядок байт");
+  }
+  if (h.endian != kNativeEndian) {
+    SwapField(h.version);
+    SwapField(h.rows);
+    SwapField(h.cols);
+    SwapField(h.alignment);
+    SwapField(h.data_offset);
+    SwapField(h.data_bytes);
+  }
+  if (h.version != kMatrixFileVersion) BadFile(path, "неизвестная версия");
+  if (ElemSize(h.dtype) == 0 || ElemSize(h.dtype) != h.elem_size) {
+    BadFile(path, "неизвестный тип элемента");
+  }
+  if (h.rows == 0 || h.cols == 0 || h.rows > INT_MAX || h.cols > INT_MAX ||
+      h.rows * h.cols > std::numeric_limits<uint64_t>::max() / h.elem_size ||
+      h.data_bytes != h.rows * h.cols * h.elem_size) {
+    BadFile(path, "неверный размер матрицы");
+  }
+  if (h.alignment == 0 || (h.alignment & (h.alignment - 1)) != 0 ||
+      h.data_offset < sizeof(h) || h.data_offset % h.alignment != 0) {
+    BadFile(path, "неверное смещение данных");
+  }
+  if ((uint64_t)st.st_size < h.data_offset + h.data_bytes) {
+    BadFile(path, "файл короче, чем указано в заголовке");
+  }
+  return h;
+}
+
+/**
+ * @brief Приведение count элементов файла (тип dtype, порядок байт endian) к
+ * T. Порядок байт меняется только у 4- и 8-байтовых типов: long double
+ * переносим лишь между платформами с тем же форматом
+ */
+template <typename T>
+void ConvertElements(unsigned char* src, const MatrixFileHeader& h, T* dst,
+                     size_t count, const std::string& path) {
+  if (h.endian != kNativeEndian) {
+    if (h.elem_size != 4 && h.elem_size != 8) {
+      BadFile(path, "порядок байт long double не поддерживается");
+    }
+    SwapBytes(src, h.elem_size, count);
+  }
+  if (h.dtype == DTypeOf<T>()) {
+    if ((void*)src != (void*)dst) std::memcpy(dst, src, count * sizeof(T));
+  } else if (h.dtype == DType::kFloat32) {
+    const float* s = reinterpret_cast<const float*>(src);
+    for (size_t k = 0; k < count; k++) dst[k] = (T)s[k];
+  } else if (h.dtype == DType::kFloat64) {
+    const double* s = reinterpret_cast<const double*>(src);
+    for (size_t k = 0; k < count; k++) dst[k] = (T)s[k];
+  } else if (h.dtype == DTypeOf<long double>()) {
+    const long double* s = reinterpret_cast<const long double*>(src);
+    for (size_t k = 0; k < count; k++) dst[k] = (T)s[k];
+  } else {
+    BadFile(path, "тип элемента не поддерживается на этой платформе");
+  }
+}
+
+template <typename T>
+S21BasicMatrix<T> LoadOpened(const File& file, const MatrixFileHeader& h,
+                             const std::string& path) {
+  S21BasicMatrix<T> res((int)h.rows, (int)h.cols);
+  const size_t count = h.rows * h.cols;
+  if (h.dtype == DTypeOf<T>()) {
+    // Данные читаются прямо в буфер матрицы
+    unsigned char* raw = reinterpret_cast<unsigned char*>(res.data());
+    ReadAll(file.fd(), raw, h.data_bytes, h.data_offset, path);
+    ConvertElements(raw, h, res.data(), count, path);
+  } else {
+    std::vector<unsigned char> raw(h.data_bytes);
+    ReadAll(file.fd(), raw.data(), h.data_bytes, h.data_offset, path);
+    ConvertElements(raw.data(), h, res.data(), count, path);
+  }
+  return res;
+}
+
+/**
+ * @brief Владелец отображения файла: матрица возвращает ему буфер в
+ * деструкторе, и он снимает отображение и удаляет себя
+ */
+class MappedFile : public S21Allocator {
+ public:
+  // Отображение length байт файла с начала; nullptr при ошибке mmap
+  void* Map(int fd, size_t length, bool read_only) {
+    base_ = ::mmap(nullptr, length,
+                   read_only ? PROT_READ : PROT_READ | PROT_WRITE,
+                   read_only ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+    length_ = length;
+    return base_ == MAP_FAILED ? nullptr : base_;
+  }
+
+  void* Allocate(size_t) override { throw std::bad_alloc(); }
+  void Deallocate(void*, size_t) override {
+    ::munmap(base_, length_);
+    delete this;
+  }
+
+ private:
+  void* base_ = nullptr;
+  size_t length_ = 0;
+};
+
+}  // namespace
+
+template <typename T>
+void SaveMatrix(const S21BasicMatrix<T>& m, const std::string& path,
+                size_t alignment) {
+  if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+    throw std::invalid_argument("Выравнивание должно быть степенью двойки");
+  }
+  alignment = std::max(alignment, kMatrixAlign);
+  MatrixFileHeader h = {};
+  std::memcpy(h.magic, kMagic, sizeof(kMagic));
+  h.version = kMatrixFileVersion;
+  h.dtype = DTypeOf<T>();
+  h.elem_size = sizeof(T);
+  h.endian = kNativeEndian;
+  h.rows = m.acc_rows();
+  h.cols = m.acc_cols();
+  h.alignment = (uint32_t)alignment;
+  h.data_offset = (sizeof(h) + alignment - 1) / alignment * alignment;
+  h.data_bytes = h.rows * h.cols * sizeof(T);
+  File file(path, O_WRONLY | O_CREAT | O_TRUNC);
+  std::vector<char> head(h.data_offset, 0);
+  std::memcpy(head.data(), &h, sizeof(h));
+  WriteAll(file.fd(), head.data(), head.size(), path);
+  WriteAll(file.fd(), m.data(), h.data_bytes, path);
+}
+
+MatrixFileHeader ReadMatrixHeader(const std::string& path) {
+  File file(path, O_RDONLY);
+  return ReadHeader(file, path);
+}
+
+template <typename T>
+S21BasicMatrix<T> LoadMatrix(const std::string& path) {
+  File file(path, O_RDONLY);
+  return LoadOpened<T>(file, ReadHeader(file, path), path);
+}
+
+template <typename T>
+S21BasicMatrix<T> MapMatrix(const std::string& path, MapMode mode) {
+  File file(path, O_RDONLY);
+  MatrixFileHeader h = ReadHeader(file, path);
+  if (h.dtype != DTypeOf<T>() || h.endian != kNativeEndian ||
+      h.data_offset % kMatrixAlign != 0) {
+    return LoadOpened<T>(file, h, path);
+  }
+  MappedFile* owner = new MappedFile();
+  void* base = owner->Map(file.fd(), h.data_offset + h.data_bytes,
+                          mode == MapMode::kReadOnly);
+  if (!base) {
+    int error = errno;
+    delete owner;
+    errno = error;
+    ThrowErrno("Не удалось отобразить", path);
+  }
+  T* data = reinterpret_cast<T*>(static_cast<char*>(base) + h.data_offset);
+  return S21BasicMatrix<T>((int)h.rows, (int)h.cols, data, owner,
+                           mode == MapMode::kReadOnly);
+}
+
+//-------------Текстовый формат-------------------
+
+namespace {
+
+// Наибольшая длина кратчайшей записи числа T: цифры мантиссы, знак, точка
+// и экспонента ("e-" и до 4 цифр)
+template <typename T>
+constexpr size_t kMaxNumberChars = std::numeric_limits<T>::max_digits10 + 8;
+
+/**
+ * @brief Вызывает body(p) для частей [0, parts): в пуле, если частей
+ * больше одной
+ */
+template <typename Fn>
+void ForChunks(int parts, const Fn& body) {
+  if (parts == 1) {
+    body(0);
+  } else {
+    S21ThreadPool::Instance().ParallelFor(parts, body);
+  }
+}
+
+// Частей для объема bytes: по kTextChunk, одна без потоков пула
+int ChunkCount(size_t bytes) {
+  if (S21ThreadPool::ThreadCount() < 2) return 1;
+  return (int)std::max<size_t>(1, bytes / kTextChunk);
+}
+
+/**
+ * @brief Текст строк [begin, end) матрицы: элементы через delimiter, в
+ * конце строки '\n'
+ */
+template <typename T>
+std::string FormatRows(const S21BasicMatrix<T>& m, int begin, int end,
+                       char delimiter) {
+  const int cols = m.acc_cols();
+  std::string text((size_t)(end - begin) * cols * (kMaxNumberChars<T> + 1),
+                   '\0');
+  char* out = text.data();
+  char* const limit = text.data() + text.size();
+  for (int i = begin; i < end; i++) {
+    const T* row = m.data() + (size_t)i * cols;
+    for (int j = 0; j < cols; j++) {
+      out = std::to_chars(out, limit, row[j]).ptr;
+      *out++ = j + 1 < cols ? delimiter : '\n';
+    }
+  }
+  text.resize(out - text.data());
+  return text;
+}
+
+/**
+ * @brief Текст матрицы частями по строкам; части форматируются параллельно
+ */
+template <typename T>
+std::vector<std::string> FormatParts(const S21BasicMatrix<T>& m,
+                                     char delimiter) {
+  const int rows = m.acc_rows();
+  const size_t bytes = (size_t)rows * m.acc_cols() * kMaxNumberChars<T> / 2;
+  const int parts = std::min(rows, ChunkCount(bytes));
+  std::vector<std::string> text(parts);
+  ForChunks(parts, [&](int p) {
+    text[p] = FormatRows(m, (int)((size_t)rows * p / parts),
+                         (int)((size_t)rows * (p + 1) / parts), delimiter);
+  });
+  return text;
+}
+
+/**
+ * @brief Результат разбора части текста: элементы ее непустых строк подряд
+ */
+template <typename T>
+struct ParsedChunk {
+  std::vector<T> values;
+  int rows = 0;
+  int cols = -1;          // элементов в первой непустой строке части
+  size_t first_line = 0;  // номер этой строки в части (с 1)
+  size_t lines = 0;       // строк текста в части (с пустыми)
+  size_t error_line = 0;  // номер строки ошибки в части, 0 - нет
+  const char* error = nullptr;
+};
+
+inline bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+/**
+ * @brief Разбор строк текста [begin, end). Числа читаются std::from_chars
+ * (допускается ведущий '+'), разделители проверяются строго: после числа
+ * идет пробел, delimiter или конец строки
+ */
+template <typename T>
+void ParseChunk(const char* begin, const char* end, char delimiter,
+                ParsedChunk<T>& chunk) {
+  const bool csv = delimiter != ' ';
+  const char* p = begin;
+  auto fail = [&chunk](const char* reason) {
+    chunk.error_line = chunk.lines;
+    chunk.error = reason;
+  };
+  while (p < end) {
+    const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+    if (!eol) eol = end;
+    chunk.lines++;
+    int fields = 0;
+    while (true) {
+      while (p < eol && IsSpace(*p)) p++;
+      if (p == eol) {
+        if (csv && fields > 0) return fail("пустой элемент в конце строки");
+        break;
+      }
+      if (*p == '+') p++;
+      T value;
+      auto [next, ec] = std::from_chars(p, eol, value);
+      if (ec != std::errc() || next == p) return fail("неверное число");
+      chunk.values.push_back(value);
+      fields++;
+      p = next;
+      while (p < eol && IsSpace(*p)) p++;
+      if (p == eol) break;
+      if (csv) {
+        if (*p != delimiter) return fail("ожидался разделитель");
+        p++;
+      } else if (!IsSpace(p[-1])) {
+        return fail("неверное число");
+      }
+    }
+    if (fields > 0) {
+      if (chunk.cols < 0) {
+        chunk.cols = fields;
+        chunk.first_line = chunk.lines;
+      }
+      if (fields != chunk.cols) return fail("другое число элементов в строке");
+      chunk.rows++;
+    }
+    p = eol + 1;
+  }
+}
+
+}  // namespace
+
+template <typename T>
+std::string FormatMatrix(const S21BasicMatrix<T>& m, char delimiter) {
+  std::vector<std::string> parts = FormatParts(m, delimiter);
+  if (parts.size() == 1) return std::move(parts[0]);
+  size_t bytes = 0;
+  for (const std::string& part : parts) bytes += part.size();
+  std::string text;
+  text.reserve(bytes);
+  for (const std::string& part : parts) text += part;
+  return text;
+}
+
+template <typename T>
+void WriteMatrixText(const S21BasicMatrix<T>& m, std::ostream& out,
+                     char delimiter) {
+  for (const std::string& part : FormatParts(m, delimiter)) {
+    out.write(part.data(), part.size());
+  }
+}
+
+template <typename T>
+void SaveMatrixText(const S21BasicMatrix<T>& m, const std::string& path,
+                    char delimiter) {
+  File file(path, O_WRONLY | O_CREAT | O_TRUNC);
+  for (const std::string& part : FormatParts(m, delimiter)) {
+    WriteAll(file.fd(), part.data(), part.size(), path);
+  }
+}
+
+/**
+ * @brief Текст делится на части по kTextChunk байт по границам строк, части
+ * разбираются параллельно в свои массивы, затем копируются в матрицу
+ */
+template <typename T>
+S21BasicMatrix<T> ParseMatrix(std::string_view text, char delimiter) {
+  const char* const begin = text.data();
+  const char* const end = begin + text.size();
+  const int parts = ChunkCount(text.size());
+  std::vector<const char*> bounds(parts + 1, end);
+  bounds[0] = begin;
+  for (int p = 1; p < parts; p++) {
+    const char* at = std::max(bounds[p - 1], begin + text.size() * p / parts);
+    const char* eol = static_cast<const char*>(memchr(at, '\n', end - at));
+    bounds[p] = eol ? eol + 1 : end;
+  }
+  std::vector<ParsedChunk<T>> chunks(parts);
+  ForChunks(parts, [&](int p) {
+    ParseChunk(bounds[p], bounds[p + 1], delimiter, chunks[p]);
+  });
+  size_t line = 0;
+  int rows = 0, cols = -1;
+  for (const ParsedChunk<T>& chunk : chunks) {
+    size_t error_line = chunk.error_line;
+    const char* error = chunk.error;
+    if (chunk.cols >= 0 && cols >= 0 && chunk.cols != cols &&
+        (!error || chunk.first_line < error_line)) {
+      error_line = chunk.first_line;
+      error = "другое число элементов в строке";
+    }
+    if (error) {
+      throw std::runtime_error("Ошибка разбора матрицы в строке " +
+                               std::to_string(line + error_line) + ": " +
+                               error);
+    }
+    if (chunk.cols >= 0) cols = chunk.cols;
+    rows += chunk.rows;
+    line += chunk.lines;
+  }
+  if (rows == 0) throw std::runtime_error("Ошибка разбора матрицы: нет строк");
+  S21BasicMatrix<T> res(rows, cols);
+  std::vector<size_t> offset(parts, 0);
+  for (int p = 1; p < parts; p++) {
+    offset[p] = offset[p - 1] + chunks[p - 1].values.size();
+  }
+  ForChunks(parts, [&](int p) {
+    std::copy(chunks[p].values.begin(), chunks[p].values.end(),
+              res.data() + offset[p]);
+  });
+  return res;
+}
+
+template <typename T>
+S21BasicMatrix<T> LoadMatrixText(const std::string& path, char delimiter) {
+  File file(path, O_RDONLY);
+  struct stat st;
+  if (::fstat(file.fd(), &st) != 0) ThrowErrno("Ошибка чтения", path);
+  std::string text(st.st_size, '\0');
+  ReadAll(file.fd(), text.data(), text.size(), 0, path);
+  return ParseMatrix<T>(text, delimiter);
+}
+
+/**
+ * @brief Каждая строка текста разбирается ParseChunk в один массив, который
+ * переиспользуется между строками
+ */
+template <typename T>
+void ReadMatrixText(S21BasicMatrix<T>& m, std::istream& in, char delimiter) {
+  const size_t count = (size_t)m.acc_rows() * m.acc_cols();
+  T* dst = m.data();
+  size_t filled = 0, line = 0;
+  std::string text;
+  ParsedChunk<T> chunk;
+  while (filled < count) {
+    if (!std::getline(in, text)) {
+      throw std::runtime_error("Ошибка разбора матрицы: прочитано " +
+                               std::to_string(filled) + " элементов из " +
+                               std::to_string(count));
+    }
+    line++;
+    chunk.values.clear();
+    chunk.cols = -1;
+    ParseChunk(text.data(), text.data() + text.size(), delimiter, chunk);
+    if (chunk.error) {
+      throw std::runtime_error("Ошибка разбора матрицы в строке " +
+                               std::to_string(line) + ": " + chunk.error);
+    }
+    size_t take = std::min(chunk.values.size(), count - filled);
+    std::copy_n(chunk.values.begin(), take, dst + filled);
+    filled += take;
+  }
+}
+
+#define S21_IO_INSTANTIATE(T)                                              \
+  template void SaveMatrix<T>(const S21BasicMatrix<T>&, const std::string&, \
+                              size_t);                                      \
+  template S21BasicMatrix<T> LoadMatrix<T>(const std::string&);             \
+  template S21BasicMatrix<T> MapMatrix<T>(const std::string&, MapMode);     \
+  template std::string FormatMatrix<T>(const S21BasicMatrix<T>&, char);     \
+  template void WriteMatrixText<T>(const S21BasicMatrix<T>&, std::ostream&, \
+                                   char);                                   \
+  template void SaveMatrixText<T>(const S21BasicMatrix<T>&,                 \
+                                  const std::string&, char);                \
+  template S21BasicMatrix<T> ParseMatrix<T>(std::string_view, char);        \
+  template S21BasicMatrix<T> LoadMatrixText<T>(const std::string&, char);   \
+  template void ReadMatrixText<T>(S21BasicMatrix<T>&, std::istream&, char);
+
+S21_IO_INSTANTIATE(float)
+S21_IO_INSTANTIATE(double)
+S21_IO_INSTANTIATE(long double)
+
+}  // namespace s21
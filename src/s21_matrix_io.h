@@ -0,0 +1,129 @@
+#ifndef __S21MATRIXIO_H__
+#define __S21MATRIXIO_H__
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "s21_matrix_oop.h"
+
+namespace s21 {
+
+// Версия двоичного формата, которую пишет SaveMatrix
+constexpr uint32_t kMatrixFileVersion = 1;
+
+// Тип элемента в файле
+enum class DType : uint8_t {
+  kFloat32 = 1,
+  kFloat64 = 2,
+  kFloat80 = 3,   // x87 extended (long double на x86), 16 байт на элемент
+  kFloat128 = 4,  // IEEE binary128 (long double на части платформ)
+};
+
+enum class Endian : uint8_t { kLittle = 1, kBig = 2 };
+
+/**
+ * @brief Заголовок двоичного файла матрицы (64 байта)
+ * За заголовком до data_offset идут нули, затем rows * cols элементов
+ * row-major без пропусков. data_offset кратен alignment (не меньше
+ * kMatrixAlign), поэтому данные отображенного в память файла выровнены так
+ * же, как буфер обычной матрицы. Поля заголовка и элементы записаны в
+ * порядке байт endian (однобайтовые поля от него не зависят)
+ */
+struct MatrixFileHeader {
+  char magic[8];  // "S21MATRX"
+  uint32_t version;
+  DType dtype;
+  uint8_t elem_size;  // байт на элемент
+  Endian endian;
+  uint8_t reserved0;
+  uint64_t rows, cols;
+  uint32_t alignment;
+  uint32_t reserved1;
+  uint64_t data_offset;  // смещение первого элемента от начала файла
+  uint64_t data_bytes;   // rows * cols * elem_size
+  uint8_t reserved2[8];
+};
+static_assert(sizeof(MatrixFileHeader) == 64, "заголовок файла - 64 байта");
+
+// Как использовать страницы файла в MapMatrix
+enum class MapMode {
+  // Общее отображение только для чтения. Изменения файла другими
+  // процессами видны, пока матрица не меняется: при первой записи в нее
+  // (или присваивании) элементы копируются в обычный буфер, а отображение
+  // снимается
+  kReadOnly,
+  // Частное отображение: страницы копируются при первой записи, файл не
+  // меняется
+  kCopyOnWrite,
+};
+
+// Записать матрицу в файл path в порядке байт и типе элемента платформы.
+// alignment - степень двойки, выравнивание данных в файле (например, 4096,
+// чтобы данные начинались с границы страницы)
+template <typename T>
+void SaveMatrix(const S21BasicMatrix<T>& m, const std::string& path,
+                size_t alignment = kMatrixAlign);
+
+// Проверенный заголовок файла (поля в порядке байт платформы)
+MatrixFileHeader ReadMatrixHeader(const std::string& path);
+
+// Прочитать файл в новый буфер одним вызовом read. Тип элемента и порядок
+// байт файла приводятся к T
+template <typename T>
+S21BasicMatrix<T> LoadMatrix(const std::string& path);
+
+// Матрица прямо на страницах файла (mmap): загрузка не читает данные,
+// страницы подгружаются при первом обращении и освобождаются вместе с
+// матрицей (и ее копиями переноса). Если файл нельзя использовать как буфер
+// T (другой тип элемента или порядок байт, данные не выровнены на
+// kMatrixAlign), он читается как в LoadMatrix
+template <typename T>
+S21BasicMatrix<T> MapMatrix(const std::string& path,
+                            MapMode mode = MapMode::kCopyOnWrite);
+
+//-------------Текстовый формат-------------------
+
+// Текст матрицы: строка текста на строку матрицы, элементы разделены
+// пробелами и табуляцией (delimiter = ' ') или запятой (CSV, delimiter =
+// ','; пробелы вокруг запятой допускаются). Пустые строки пропускаются,
+// окончания строк "\n" или "\r\n". Числа пишутся кратчайшей записью, которая
+// читается обратно в то же значение (std::to_chars), поэтому запись и
+// чтение сохраняют значения точно. Большие матрицы форматируются и
+// разбираются параллельно частями по kTextChunk байт
+
+constexpr size_t kTextChunk = size_t(1) << 20;
+
+template <typename T>
+std::string FormatMatrix(const S21BasicMatrix<T>& m, char delimiter = ' ');
+template <typename T>
+void WriteMatrixText(const S21BasicMatrix<T>& m, std::ostream& out,
+                     char delimiter = ' ');
+template <typename T>
+void SaveMatrixText(const S21BasicMatrix<T>& m, const std::string& path,
+                    char delimiter = ' ');
+
+// Размер матрицы определяется по тексту: число непустых строк и число
+// элементов в первой из них. Ошибка разбора или строка другой длины -
+// std::runtime_error с номером строки текста
+template <typename T>
+S21BasicMatrix<T> ParseMatrix(std::string_view text, char delimiter = ' ');
+template <typename T>
+S21BasicMatrix<T> LoadMatrixText(const std::string& path,
+                                 char delimiter = ' ');
+
+// Заполнить матрицу m заданного размера из потока (например, std::cin):
+// строки текста читаются целиком и разбираются как в ParseMatrix, элементы
+// идут в матрицу построчно при любом разбиении на строки текста. Поток
+// читается до строки, на которой набралось rows * cols элементов; лишние
+// элементы этой строки отбрасываются. Конец потока раньше или ошибка
+// разбора - std::runtime_error
+template <typename T>
+void ReadMatrixText(S21BasicMatrix<T>& m, std::istream& in,
+                    char delimiter = ' ');
+
+}  // namespace s21
+
+#endif
@@ -1,25 +1,112 @@
 #include "s21_matrix_oop.h"
 
+#include <cstdint>
+#include <cstring>
+
+#include "s21_gemm.h"
+#include "s21_linalg.h"
+#include "s21_matrix_io.h"
+#include "s21_simd.h"
+#include "s21_strassen.h"
+#include "s21_transpose.h"
+
+namespace {
+
+inline uint64_t Rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+/**
+ * @brief Контрольная сумма байтов элементов матрицы (раунды xxHash64 по
+ * словам в четыре независимые цепочки), O(rows * cols). По ней сохраненное
+ * разложение сверяется с матрицей перед использованием
+ */
+template <typename T>
+uint64_t Checksum(const T* data, int rows, int cols, int ld) {
+  constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+  constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+  uint64_t h[4] = {kPrime1 + kPrime2, kPrime2, 0, 0 - kPrime1};
+  auto round = [](uint64_t acc, uint64_t w) {
+    return Rotl(acc + w * kPrime2, 31) * kPrime1;
+  };
+  const size_t bytes = (size_t)cols * sizeof(T);
+  for (int m = 0; m < rows; m++) {
+    const char* p = reinterpret_cast<const char*>(data + (size_t)m * ld);
+    size_t k = 0;
+    for (; k + 32 <= bytes; k += 32) {
+      uint64_t w[4];
+      memcpy(w, p + k, sizeof(w));
+      for (int j = 0; j < 4; j++) h[j] = round(h[j], w[j]);
+    }
+    for (; k < bytes; k += 8) {
+      uint64_t w = 0;
+      memcpy(&w, p + k, std::min<size_t>(8, bytes - k));
+      h[0] = round(h[0], w);
+    }
+  }
+  return Rotl(h[0], 1) + Rotl(h[1], 7) + Rotl(h[2], 12) + Rotl(h[3], 18);
+}
+
+/**
+ * @brief Применяет поэлементное ядро к паре матриц одинакового размера:
+ * одним вызовом по всему буферу, если строки идут без зазоров, иначе
+ * построчно
+ */
+template <typename T, typename Kernel>
+void apply_rows(int rows, int cols, T* dst, int ld_dst, const T* src,
+                int ld_src, Kernel kernel) {
+  if (ld_dst == cols && ld_src == cols) {
+    kernel(dst, src, (size_t)rows * cols);
+  } else {
+    for (int m = 0; m < rows; m++) {
+      kernel(dst + (size_t)m * ld_dst, src + (size_t)m * ld_src, cols);
+    }
+  }
+}
+
+}  // namespace
+
+/**
+ * @brief Сохраненное разложение (см. factors_): копия матрицы, разложенная на
+ * месте LuFactor, CholeskyFactor или QrFactor, и его вспомогательные данные
+ */
+template <typename T>
+struct S21BasicMatrix<T>::Factors {
+  enum Kind { kLu, kCholesky, kQr };
+  Factors(Kind k, const S21BasicMatrix& m)
+      : kind(k),
+        checksum(Checksum(m.matrix_, m.rows_, m.cols_, m.ld_)),
+        a(m) {}
+  Kind kind;
+  uint64_t checksum;  // Checksum исходной матрицы
+  S21BasicMatrix a;
+  std::vector<int> piv;  // LU: перестановки строк
+  std::vector<T> tau;    // QR: коэффициенты отражений
+  int sign = 0;          // LU: знак перестановки, 0 - матрица вырождена
+};
+
+template <typename T>
+void S21BasicMatrix<T>::FactorsDeleter::operator()(Factors* f) const {
+  delete f;
+}
+
 //-------------Конструкторы-------------------
 
 /**
  * @brief Базовый конструктор
  */
-S21Matrix::S21Matrix() : S21Matrix(3, 3) {}
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix() : S21BasicMatrix(3, 3) {}
 
 /**
  * @brief Параметризованный конструктор
  * @param rows Количество строк в новой матрице
  * @param cols Количество столбцов в новой матрице
  */
-S21Matrix::S21Matrix(int rows, int cols) : rows_(rows), cols_(cols) {
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(int rows, int cols)
+    : rows_(rows), cols_(cols), ld_(cols) {
   if (rows <= 0 || cols <= 0) not_exist();
   allocate_mem();
-  for (int r = 0; r < rows_; r++) {
-    for (int c = 0; c < cols_; c++) {
-      matrix_[r][c] = 0;
-    }
-  }
+  std::fill(matrix_, matrix_ + (size_t)rows_ * ld_, T(0));
 }
 
 /**
@@ -27,8 +114,9 @@ S21Matrix::S21Matrix(int rows, int cols) : rows_(rows), cols_(cols) {
  * @param other Матрица, на основе которой будет производится копирование в
  * текущий объект
  */
-S21Matrix::S21Matrix(const S21Matrix& other)
-    : rows_(other.rows_), cols_(other.cols_) {
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(const S21BasicMatrix& other)
+    : rows_(other.rows_), cols_(other.cols_), ld_(other.cols_) {
   allocate_mem();
   copy_matrix(other);
 }
@@ -38,24 +126,58 @@ S21Matrix::S21Matrix(const S21Matrix& other)
  * @param other Матрица, на основе которой будет производится копирование в
  * текущий объект. Далее эта матрица удалится
  */
-S21Matrix::S21Matrix(S21Matrix&& other)
-    : rows_(other.rows_), cols_(other.cols_), matrix_(other.matrix_) {
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(S21BasicMatrix&& other) noexcept
+    : rows_(other.rows_),
+      cols_(other.cols_),
+      ld_(other.ld_),
+      matrix_(other.matrix_),
+      alloc_(other.alloc_),
+      read_only_(other.read_only_),
+      factors_(std::move(other.factors_)) {
   other.matrix_ = nullptr;
-  other.rows_ = other.cols_ = 0;
+  other.rows_ = other.cols_ = other.ld_ = 0;
+}
+
+/**
+ * @brief Конструктор на чужом буфере (например, отображенном в память файле)
+ * @param data Буфер rows x cols, row-major, выровнен на kMatrixAlign
+ * @param owner Аллокатор, которому буфер возвращается в деструкторе
+ * @param read_only Буфер нельзя менять: при первой записи (operator(),
+ * data(), изменяющие методы, присваивание) элементы копируются в буфер
+ * текущего аллокатора, а этот возвращается owner
+ */
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(int rows, int cols, T* data,
+                                  S21Allocator* owner, bool read_only)
+    : rows_(rows),
+      cols_(cols),
+      ld_(cols),
+      matrix_(data),
+      alloc_(owner),
+      read_only_(read_only) {
+  if (rows <= 0 || cols <= 0) not_exist();
 }
 
+/**
+ * @brief Конструктор копирования элементов вида (блока, строки,
+ * транспонированной матрицы)
+ */
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(ConstView view)
+    : S21BasicMatrix(view.ToMatrix()) {}
+
 /**
  * @brief Деструктор текущей матрицы
  */
-S21Matrix::~S21Matrix() {
+template <typename T>
+S21BasicMatrix<T>::~S21BasicMatrix() {
   if (matrix_) {
-    for (int i = 0; i < rows_; i++) {
-      delete[] matrix_[i];
-    }
-    delete[] matrix_;
+    alloc_->Deallocate(matrix_, (size_t)rows_ * ld_ * sizeof(T));
     matrix_ = nullptr;
     rows_ = 0;
     cols_ = 0;
+    ld_ = 0;
   }
 }
 
@@ -63,13 +185,15 @@ S21Matrix::~S21Matrix() {
  * @brief accessor: Взятие значения строк (из private)
  * @return Количество строк в матрице
  */
-int S21Matrix::acc_rows() { return rows_; }
+template <typename T>
+int S21BasicMatrix<T>::acc_rows() const { return rows_; }
 
 /**
  * @brief accessor: Взятие значения столбцов(из private)
  * @return Количество столбцов в матрице
  */
-int S21Matrix::acc_cols() { return cols_; }
+template <typename T>
+int S21BasicMatrix<T>::acc_cols() const { return cols_; }
 
 /**
  * @brief mutator: Изменение количества строк и столбцов в текущей матрице
@@ -78,19 +202,15 @@ int S21Matrix::acc_cols() { return cols_; }
  * @param cols Количество столбцов в новой матрице, в которую будет "мутировать"
  * текущая
  */
-void S21Matrix::mutator(int rows, int cols) {
+template <typename T>
+void S21BasicMatrix<T>::mutator(int rows, int cols) {
   if (rows <= 0 && cols <= 0) not_exist();
-  S21Matrix temp(rows, cols);
-  for (int m = 0; m < rows; m++) {
-    for (int n = 0; n < cols; n++) {
-      if (m < rows_ && n < cols_) {
-        temp.matrix_[m][n] = this->matrix_[m][n];
-      } else {
-        temp.matrix_[m][n] = 0;
-      }
-    }
+  S21BasicMatrix temp(rows, cols);
+  int copy_rows = std::min(rows, rows_), copy_cols = std::min(cols, cols_);
+  for (int m = 0; m < copy_rows; m++) {
+    std::copy(row_ptr(m), row_ptr(m) + copy_cols, temp.row_ptr(m));
   }
-  *this = temp;
+  *this = std::move(temp);
 }
 
 //-------------Операции над матрицами-------------------
@@ -100,12 +220,17 @@ void S21Matrix::mutator(int rows, int cols) {
  * @param other Другая матрица, с которой сравнивается текущая
  * @return 1 - YES (матрицы равны), 0 - NO (матрицы не равны)
  */
-bool S21Matrix::EqMatrix(const S21Matrix& other) {
+template <typename T>
+bool S21BasicMatrix<T>::EqMatrix(const S21BasicMatrix& other) {
   if (rows_ != other.rows_ || cols_ != other.cols_) not_same_size();
+  const s21::BasicSimdKernels<T>& simd = s21::Simd<T>();
+  const T eps = S21Tolerance<T>::value;
   int code = YES;
-  for (int m = 0; m < rows_ && code != NO; m++) {
-    for (int n = 0; n < cols_ && code != NO; n++) {
-      if (fabs(this->matrix_[m][n] - other.matrix_[m][n]) > SCI_NOT) code = NO;
+  if (ld_ == cols_ && other.ld_ == other.cols_) {
+    code = simd.equal(matrix_, other.matrix_, (size_t)rows_ * cols_, eps);
+  } else {
+    for (int m = 0; m < rows_ && code != NO; m++) {
+      code = simd.equal(row_ptr(m), other.row_ptr(m), cols_, eps);
     }
   }
   return code;
@@ -115,13 +240,12 @@ bool S21Matrix::EqMatrix(const S21Matrix& other) {
  * @brief Прибавляет вторую матрицу к текущей
  * @param other Вторая матрица - слагаемое
  */
-void S21Matrix::SumMatrix(const S21Matrix& other) {
+template <typename T>
+void S21BasicMatrix<T>::SumMatrix(const S21BasicMatrix& other) {
   if (rows_ != other.rows_ || cols_ != other.cols_) not_same_size();
-  for (int m = 0; m < rows_; m++) {
-    for (int n = 0; n < cols_; n++) {
-      matrix_[m][n] += other.matrix_[m][n];
-    }
-  }
+  begin_write();
+  apply_rows(rows_, cols_, matrix_, ld_, other.matrix_, other.ld_,
+             s21::Simd<T>().add);
 }
 
 /**
@@ -129,153 +253,226 @@ void S21Matrix::SumMatrix(const S21Matrix& other) {
  * @param other Матрица - вычитаемая
  *
  */
-void S21Matrix::SubMatrix(const S21Matrix& other) {
+template <typename T>
+void S21BasicMatrix<T>::SubMatrix(const S21BasicMatrix& other) {
   if (rows_ != other.rows_ || cols_ != other.cols_) not_same_size();
-  for (int m = 0; m < rows_; m++) {
-    for (int n = 0; n < cols_; n++) {
-      matrix_[m][n] -= other.matrix_[m][n];
-    }
-  }
+  begin_write();
+  apply_rows(rows_, cols_, matrix_, ld_, other.matrix_, other.ld_,
+             s21::Simd<T>().sub);
 }
 
 /**
  * @brief Умножает текущую матрицу на число
  * @param num Вещественное число - второй множитель
  */
-void S21Matrix::MulNumber(const double num) {
-  for (int m = 0; m < rows_; m++) {
-    for (int n = 0; n < cols_; n++) {
-      matrix_[m][n] *= num;
-    }
+template <typename T>
+void S21BasicMatrix<T>::MulNumber(const T num) {
+  const s21::BasicSimdKernels<T>& simd = s21::Simd<T>();
+  begin_write();
+  if (ld_ == cols_) {
+    simd.scale(matrix_, num, (size_t)rows_ * cols_);
+  } else {
+    for (int m = 0; m < rows_; m++) simd.scale(row_ptr(m), num, cols_);
   }
 }
 
 /**
- * @brief Умножает текущую матрицу на вторую
+ * @brief Умножает текущую матрицу на вторую (см. operator*): результат
+ * другого размера, поэтому он считается в новый буфер, который забирает
+ * текущая матрица
  * @param other Вторая матрица - множитель
  */
-void S21Matrix::MulMatrix(const S21Matrix& other) {
-  if (cols_ != other.rows_) not_equal();
-  S21Matrix res(rows_, other.cols_);
-  for (int m = 0; m < rows_; m++) {
-    for (int n = 0; n < other.cols_; n++) {
-      for (int k = 0; k < cols_; k++) {
-        res.matrix_[m][n] += matrix_[m][k] * other.matrix_[k][n];
-      }
-    }
-  }
-  *this = res;
+template <typename T>
+void S21BasicMatrix<T>::MulMatrix(const S21BasicMatrix& other) {
+  *this = *this * other;
+}
+
+/**
+ * @brief y = A * x, где A - текущая матрица (s21::Gemv: векторные ядра,
+ * высокие матрицы - в пуле потоков)
+ * @param x Вектор из cols_ элементов
+ * @param y Результат из rows_ элементов, память выделяет вызывающий
+ */
+template <typename T>
+void S21BasicMatrix<T>::MulVector(const T* x, T* y) const {
+  s21::Gemv(rows_, cols_, matrix_, ld_, x, y);
+}
+
+template <typename T>
+std::vector<T> S21BasicMatrix<T>::MulVector(const std::vector<T>& x) const {
+  if ((int)x.size() != cols_) not_equal();
+  std::vector<T> y(rows_);
+  MulVector(x.data(), y.data());
+  return y;
+}
+
+/**
+ * @brief y = x^T * A, где A - текущая матрица (s21::Gevm)
+ * @param x Вектор из rows_ элементов
+ * @param y Результат из cols_ элементов, память выделяет вызывающий
+ */
+template <typename T>
+void S21BasicMatrix<T>::VectorMul(const T* x, T* y) const {
+  s21::Gevm(rows_, cols_, x, matrix_, ld_, y);
+}
+
+template <typename T>
+std::vector<T> S21BasicMatrix<T>::VectorMul(const std::vector<T>& x) const {
+  if ((int)x.size() != rows_) not_equal();
+  std::vector<T> y(cols_);
+  VectorMul(x.data(), y.data());
+  return y;
+}
+
+/**
+ * @brief Сравнение с видом (см. EqMatrix)
+ */
+template <typename T>
+bool S21BasicMatrix<T>::EqMatrix(ConstView other) {
+  return std::as_const(*this).view().EqMatrix(other);
+}
+
+/**
+ * @brief Прибавляет к текущей матрице вид того же размера
+ */
+template <typename T>
+void S21BasicMatrix<T>::SumMatrix(ConstView other) {
+  view().SumMatrix(other);
+}
+
+/**
+ * @brief Вычитает из текущей матрицы вид того же размера
+ */
+template <typename T>
+void S21BasicMatrix<T>::SubMatrix(ConstView other) {
+  view().SubMatrix(other);
+}
+
+/**
+ * @brief Умножает текущую матрицу на вид: Gemm читает вид по его шагам, без
+ * копирования (в том числе транспонированный)
+ */
+template <typename T>
+void S21BasicMatrix<T>::MulMatrix(ConstView other) {
+  *this = std::as_const(*this).view().MulMatrix(other);
 }
 
 /**
- * @brief Создает новую транспонированную матрицу из текущей
+ * @brief Создает новую транспонированную матрицу из текущей (блочный обход,
+ * см. s21_transpose.h)
  * @return Итоговая транспонированная матрица
  */
-S21Matrix S21Matrix::Transpose() {
-  S21Matrix temp(cols_, rows_);
-  for (int m = 0; m < temp.rows_; m++) {
-    for (int n = 0; n < temp.cols_; n++) {
-      temp.matrix_[m][n] = matrix_[n][m];
-    }
-  }
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::Transpose() {
+  S21BasicMatrix temp(cols_, rows_);
+  s21::Transpose(rows_, cols_, matrix_, ld_, temp.matrix_, temp.ld_);
   return temp;
 }
 
 /**
- * @brief Вычисляет определитель текущей матрицы
+ * @brief Транспонирует текущую квадратную матрицу на месте, без выделения
+ * памяти
+ */
+template <typename T>
+void S21BasicMatrix<T>::TransposeInPlace() {
+  if (rows_ != cols_) not_square();
+  begin_write();
+  s21::TransposeInPlace(rows_, matrix_, ld_);
+}
+
+/**
+ * @brief Вычисляет определитель текущей матрицы через LU-разложение с
+ * частичным выбором ведущего элемента (O(n^3) при первом вызове, O(n) по
+ * сохраненному разложению; сохраненное разложение Холецкого тоже подходит)
  * @return Вещественное число - определитель
  */
-double S21Matrix::Determinant() {
+template <typename T>
+T S21BasicMatrix<T>::Determinant() {
   if (rows_ != cols_) not_square();
-  int is_nul_det = 1;
-  double result = 1;
-  for (int m = 0; m < rows_ && is_nul_det == 1; m++) {
-    if (matrix_[m][0] != 0) is_nul_det = 0;
+  const Factors* cached = valid_factors();
+  if (cached && cached->kind == Factors::kCholesky) {
+    return DeterminantSPD();
   }
-  if (!is_nul_det && rows_ > 2) {
-    S21Matrix copy(*this);
-    copy.TriangMatrix(result);
-    if (result != 0) {
-      for (int mult = 0; mult < copy.rows_; mult++) {
-        result *= copy.matrix_[mult][mult];
-      }
-    }
-  } else if (!is_nul_det && rows_ == 2) {
-    result = matrix_[0][0] * matrix_[1][1] - matrix_[1][0] * matrix_[0][1];
-  } else if (!is_nul_det && rows_ == 1) {
-    result = matrix_[0][0];
-  } else
-    result = 0;
-  if (result == 0) result = fabs(result);
+  const Factors& f = lu_factors();
+  T result = f.sign;
+  for (int g = 0; g < rows_ && result != 0; g++) {
+    result *= f.a.row_ptr(g)[g];
+  }
+  if (result == 0) result = std::fabs(result);
   return result;
 }
 
 /**
- * @brief Зануляет нижнюю левую половину от главной диагонали
- * @param result Результирующее значение детерминанта
+ * @brief LU-разложение текущей матрицы на месте: P * A = L * U
+ * После вызова под главной диагональю лежит L (единичная диагональ не
+ * хранится), на диагонали и выше - U
+ * @param perm Перестановка строк: perm[i] - номер строки исходной матрицы,
+ * оказавшейся в строке i
+ * @return Знак перестановки (1 или -1), 0 - матрица вырождена
  */
-void S21Matrix::TriangMatrix(double& result) {
-  for (int g = 0; g < (rows_ - 1) && result != 0; g++) {
-    if (!FinfDiagNullElem(g)) {
-      for (int r = g + 1; r < rows_; r++) {
-        double k = matrix_[r][g] / matrix_[g][g];
-        if (k != 0) {
-          for (int c = g; c < cols_; c++) {
-            matrix_[r][c] -= matrix_[g][c] * k;
-          }
-        }
-      }
-    } else
-      result = 0;
-  }
+template <typename T>
+int S21BasicMatrix<T>::LUInPlace(std::vector<int>& perm) {
+  if (rows_ != cols_) not_square();
+  begin_write();
+  std::vector<int> piv(rows_);
+  int sign = s21::LuFactor(rows_, matrix_, ld_, piv.data());
+  perm.resize(rows_);
+  s21::PivotsToPermutation(rows_, piv.data(), perm.data());
+  return sign;
 }
 
 /**
- * @brief Ищет нулевой элемент на главной диагонали
- * Если нашел, то пытается поменять строчку на строку,
- * где нет нулевого элемента со сменой знака
- * @param g столбец, по которому смотрим на главную диагональ
- * @return 0 - ОК (если не было 0 на главной диагонали или замена прошла
- * успешно), 1 - ERROR (не нашли строку ненулевую, не с чем поменять местами)
- */
-bool S21Matrix::FinfDiagNullElem(int g) {
-  bool code = OK;
-  if (matrix_[g][g] == 0) {
-    int flag = 1;
-    for (int r = g + 1; r < rows_; r++) {
-      if (matrix_[r][g] != 0) {
-        flag = 0;
-        S21Matrix temp(*this);
-        for (int c = 0; c < cols_; c++) {
-          temp.matrix_[g][c] = (-1) * matrix_[r][c];
-          matrix_[r][c] = matrix_[g][c];
-          matrix_[g][c] = temp.matrix_[g][c];
-        }
-      }
-    }
-    if (flag) code = ERROR;
+ * @brief LU-разложение с явными множителями: P * A = L * U
+ * @param l Нижняя треугольная матрица с единичной диагональю
+ * @param u Верхняя треугольная матрица
+ * @param perm Перестановка строк (см. LUInPlace)
+ * @return Знак перестановки (1 или -1), 0 - матрица вырождена
+ */
+template <typename T>
+int S21BasicMatrix<T>::LU(S21BasicMatrix& l, S21BasicMatrix& u,
+                          std::vector<int>& perm) {
+  u = *this;
+  int sign = u.LUInPlace(perm);
+  l = S21BasicMatrix(rows_, cols_);
+  for (int m = 0; m < rows_; m++) {
+    T* lower = l.row_ptr(m);
+    T* upper = u.row_ptr(m);
+    std::copy(upper, upper + m, lower);
+    std::fill(upper, upper + m, T(0));
+    lower[m] = 1;
   }
-  return code;
+  return sign;
 }
 
 /**
  * @brief Вычисляет матрицу алгебраических дополнений текущей матрицы и
- * возвращает ее
+ * возвращает ее. Для невырожденной матрицы используется тождество
+ * adj(A) = det(A) * A^-1, т.е. дополнения равны det(A) * (A^-1)^T; для
+ * вырожденной - разложение с полным выбором ведущего элемента (см.
+ * s21::SingularCofactors). Оба пути O(n^3); LU-разложение берется
+ * сохраненное, если есть
  */
-S21Matrix S21Matrix::CalcComplements() {
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::CalcComplements() {
   if (rows_ != cols_) not_square();
-  S21Matrix result(*this);
-  if (rows_ > 1) {
-    S21Matrix mini_matrix(rows_ - 1, cols_ - 1);
-    for (int r = 0; r < result.rows_; r++) {
-      for (int c = 0; c < result.cols_; c++) {
-        mini_matrix = CreateMiniMatrix(r, c);
-        result.matrix_[r][c] = mini_matrix.Determinant();
-        result.matrix_[r][c] *= pow(-1, r + c);
-      }
+  S21BasicMatrix result(*this);
+  if (rows_ == 1) {
+    result.matrix_[0] = 1;
+  } else {
+    const Factors& f = lu_factors();
+    if (f.sign != 0) {
+      result.copy_matrix(f.a);
+      T det = f.sign;
+      for (int g = 0; g < rows_; g++) det *= result.row_ptr(g)[g];
+      s21::LuInvert(rows_, result.matrix_, result.ld_, f.piv.data());
+      result.TransposeInPlace();
+      result.MulNumber(det);
+    } else {
+      S21BasicMatrix work(*this);
+      s21::SingularCofactors(rows_, work.matrix_, work.ld_, result.matrix_,
+                             result.ld_);
     }
-  } else if (rows_ == 1)
-    result.matrix_[0][0] = 1;
+  }
   return result;
 }
 
@@ -285,44 +482,289 @@ S21Matrix S21Matrix::CalcComplements() {
  * @param r Вычеркиваемая строка текущей матрицы
  * @param c Вычеркиваемый столбец текущей матрицы
  */
-S21Matrix S21Matrix::CreateMiniMatrix(int r, int c) {
-  S21Matrix mini(rows_ - 1, cols_ - 1);
-  int min_r = -1, min_c = -1;
-  for (int rowM = 0; rowM < rows_; rowM++) {
-    if (rowM != r) {
-      min_r++;
-      for (int columnM = 0; columnM < cols_; columnM++) {
-        if (columnM != c) {
-          min_c++;
-          mini.matrix_[min_r][min_c] = matrix_[rowM][columnM];
-        }
-      }
-      min_c = -1;
-    }
-  }
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::CreateMiniMatrix(int r, int c) {
+  S21BasicMatrix mini(rows_ - 1, cols_ - 1);
+  const S21BasicMatrix& self = *this;
+  // Четыре блока вокруг вычеркнутых строки и столбца копируются построчно
+  const int below = rows_ - 1 - r, right = cols_ - 1 - c;
+  mini.Block(0, 0, r, c).Assign(self.view().Block(0, 0, r, c));
+  mini.Block(0, c, r, right).Assign(self.view().Block(0, c + 1, r, right));
+  mini.Block(r, 0, below, c).Assign(self.view().Block(r + 1, 0, below, c));
+  mini.Block(r, c, below, right)
+      .Assign(self.view().Block(r + 1, c + 1, below, right));
   return mini;
 }
 
 /**
  * @brief Вычисляет и возвращает обратную матрицу на основе текущей
+ * Обращение идет на месте в копии LU-разложения, O(n^3). Разложение
+ * сохраняется, поэтому Determinant до или после InverseMatrix не раскладывает
+ * матрицу заново; при сохраненном разложении Холецкого - InverseMatrixSPD
  */
-S21Matrix S21Matrix::InverseMatrix() {
-  double det = Determinant();
-  if (det == 0) null_determinant();
-  S21Matrix res(rows_, cols_);
-  if (rows_ > 1) {
-    S21Matrix calc_comp(rows_, cols_), trans(cols_, rows_);
-    calc_comp = CalcComplements();
-    trans = calc_comp.Transpose();
-    trans.MulNumber(1 / det);
-    res = trans;
-  } else if (rows_ == 1) {
-    res.mutator(1, 1);
-    res.matrix_[0][0] = 1 / matrix_[0][0];
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::InverseMatrix() {
+  if (rows_ != cols_) not_square();
+  const Factors* cached = valid_factors();
+  if (cached && cached->kind == Factors::kCholesky) {
+    return InverseMatrixSPD();
   }
+  const Factors& f = lu_factors();
+  if (f.sign == 0) null_determinant();
+  S21BasicMatrix res(f.a);
+  s21::LuInvert(rows_, res.matrix_, res.ld_, f.piv.data());
   return res;
 }
 
+/**
+ * @brief Решение системы A * X = B, где A - текущая матрица
+ * Прямой режим: LU-разложение копии A (сохраняется для следующих вызовов) и
+ * блочные подстановки для всех столбцов B сразу. Режим смешанной точности
+ * раскладывает A в float и уточняет решение в T; если уточнение не сходится
+ * (A плохо обусловлена), система решается прямым режимом. При уже
+ * сохраненном LU-разложении (или разложении Холецкого) решение идет по нему
+ * в любом режиме
+ * @param b Правые части n x k
+ * @return Решение X n x k
+ */
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::Solve(const S21BasicMatrix& b,
+                                           s21::SolveMode mode) {
+  if (rows_ != cols_) not_square();
+  if (rows_ != b.rows_) not_equal();
+  const Factors* cached = valid_factors();
+  if (cached && cached->kind == Factors::kCholesky) return SolveSPD(b);
+  S21BasicMatrix x(b.rows_, b.cols_);
+  if (mode == s21::SolveMode::kMixedPrecision &&
+      !std::is_same<T, float>::value &&
+      (!cached || cached->kind != Factors::kLu) &&
+      s21::MixedPrecisionSolve(rows_, b.cols_, matrix_, ld_, b.matrix_, b.ld_,
+                               x.matrix_, x.ld_)) {
+    return x;
+  }
+  const Factors& f = lu_factors();
+  if (f.sign == 0) null_determinant();
+  x = b;
+  s21::LuSolve(rows_, b.cols_, f.a.matrix_, f.a.ld_, f.piv.data(), x.matrix_,
+               x.ld_);
+  return x;
+}
+
+/**
+ * @brief Разложение Холецкого текущей матрицы на месте: A = L * L^T
+ * После вызова в матрице лежит L (выше диагонали - нули). Симметричность
+ * не проверяется, читается нижний треугольник
+ * @return true - разложение получено, false - матрица не положительно
+ * определена (содержимое матрицы не определено)
+ */
+template <typename T>
+bool S21BasicMatrix<T>::CholeskyInPlace() {
+  if (rows_ != cols_) not_square();
+  begin_write();
+  return s21::CholeskyFactor(rows_, matrix_, ld_);
+}
+
+/**
+ * @brief Разложение Холецкого с явным множителем: A = L * L^T
+ * @param l Нижняя треугольная матрица с положительной диагональю
+ * @return false - матрица не положительно определена (l не изменяется)
+ */
+template <typename T>
+bool S21BasicMatrix<T>::Cholesky(S21BasicMatrix& l) {
+  S21BasicMatrix factor(*this);
+  if (!factor.CholeskyInPlace()) return false;
+  l = std::move(factor);
+  return true;
+}
+
+/**
+ * @brief Сохраненное LU-разложение (LuFactor над копией матрицы); если
+ * сохранено другое разложение или ничего, раскладывает заново
+ */
+template <typename T>
+const typename S21BasicMatrix<T>::Factors& S21BasicMatrix<T>::lu_factors() {
+  const Factors* cached = valid_factors();
+  if (!cached || cached->kind != Factors::kLu) {
+    drop_factors();
+    FactorsPtr f(new Factors(Factors::kLu, *this));
+    f->piv.resize(rows_);
+    f->sign = s21::LuFactor(rows_, f->a.matrix_, f->a.ld_, f->piv.data());
+    factors_ = std::move(f);
+  }
+  return *factors_;
+}
+
+/**
+ * @brief Сохраненное разложение Холецкого для SPD-операций
+ * Несимметричная (с точностью S21Tolerance относительно наибольшего
+ * диагонального элемента) или не положительно определенная матрица -
+ * исключение (такое разложение не сохраняется)
+ */
+template <typename T>
+const typename S21BasicMatrix<T>::Factors&
+S21BasicMatrix<T>::cholesky_factors() {
+  if (rows_ != cols_) not_square();
+  const Factors* cached = valid_factors();
+  if (cached && cached->kind == Factors::kCholesky) return *cached;
+  drop_factors();
+  T scale = 1;
+  for (int i = 0; i < rows_; i++) {
+    scale = std::max(scale, std::fabs(row_ptr(i)[i]));
+  }
+  const T eps = S21Tolerance<T>::value * scale;
+  for (int i = 1; i < rows_; i++) {
+    const T* row = row_ptr(i);
+    for (int j = 0; j < i; j++) {
+      if (std::fabs(row[j] - row_ptr(j)[i]) > eps) not_positive_definite();
+    }
+  }
+  FactorsPtr f(new Factors(Factors::kCholesky, *this));
+  if (!s21::CholeskyFactor(rows_, f->a.matrix_, f->a.ld_)) {
+    not_positive_definite();
+  }
+  factors_ = std::move(f);
+  return *factors_;
+}
+
+/**
+ * @brief Сохраненное QR-разложение (QrFactor над копией матрицы). Меньше
+ * строк, чем столбцов, или линейно зависимые столбцы - исключение
+ */
+template <typename T>
+const typename S21BasicMatrix<T>::Factors& S21BasicMatrix<T>::qr_factors() {
+  if (rows_ < cols_) not_full_rank();
+  const Factors* cached = valid_factors();
+  if (cached && cached->kind == Factors::kQr) return *cached;
+  drop_factors();
+  FactorsPtr f(new Factors(Factors::kQr, *this));
+  f->tau.resize(cols_);
+  if (!s21::QrFactor(rows_, cols_, f->a.matrix_, f->a.ld_, f->tau.data())) {
+    not_full_rank();
+  }
+  factors_ = std::move(f);
+  return *factors_;
+}
+
+/**
+ * @brief Сбрасывает сохраненное разложение: матрица изменена или может быть
+ * изменена через выданную ссылку
+ */
+template <typename T>
+void S21BasicMatrix<T>::drop_factors() {
+  factors_.reset();
+}
+
+/**
+ * @brief Сохраненное разложение, если контрольная сумма матрицы не
+ * изменилась с его вычисления (запись через ссылку или вид, выданные до
+ * разложения, меняет сумму), иначе сбрасывает его и возвращает nullptr
+ */
+template <typename T>
+const typename S21BasicMatrix<T>::Factors* S21BasicMatrix<T>::valid_factors() {
+  if (factors_ &&
+      factors_->checksum != Checksum(matrix_, rows_, cols_, ld_)) {
+    drop_factors();
+  }
+  return factors_.get();
+}
+
+/**
+ * @brief Вызывается перед записью в буфер: сбрасывает разложение, буфер
+ * только для чтения заменяет копией (старый возвращается владельцу)
+ */
+template <typename T>
+void S21BasicMatrix<T>::begin_write() {
+  drop_factors();
+  if (read_only_) {
+    S21BasicMatrix copy(*this);
+    *this = std::move(copy);
+  }
+}
+
+/**
+ * @brief Определитель SPD матрицы: произведение квадратов диагонали L
+ */
+template <typename T>
+T S21BasicMatrix<T>::DeterminantSPD() {
+  const Factors& f = cholesky_factors();
+  T result = 1;
+  for (int i = 0; i < rows_; i++) {
+    T d = f.a.row_ptr(i)[i];
+    result *= d * d;
+  }
+  return result;
+}
+
+/**
+ * @brief Обратная SPD матрица по разложению Холецкого (см. CholeskyInvert)
+ */
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::InverseMatrixSPD() {
+  S21BasicMatrix res(cholesky_factors().a);
+  s21::CholeskyInvert(rows_, res.matrix_, res.ld_);
+  return res;
+}
+
+/**
+ * @brief Решение A * X = B для SPD матрицы A по разложению Холецкого
+ * @param b Правые части n x k
+ * @return Решение X n x k
+ */
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::SolveSPD(const S21BasicMatrix& b) {
+  if (rows_ != cols_) not_square();
+  if (rows_ != b.rows_) not_equal();
+  const Factors& f = cholesky_factors();
+  S21BasicMatrix x(b);
+  s21::CholeskySolve(rows_, b.cols_, f.a.matrix_, f.a.ld_, x.matrix_, x.ld_);
+  return x;
+}
+
+/**
+ * @brief Тонкое QR-разложение A = Q * R (блочные отражения Хаусхолдера, см.
+ * QrFactor). Нужно rows_ >= cols_ и линейно независимые столбцы
+ * @param q Матрица rows_ x cols_ с ортонормированными столбцами
+ * @param r Верхняя треугольная матрица cols_ x cols_
+ */
+template <typename T>
+void S21BasicMatrix<T>::QR(S21BasicMatrix& q, S21BasicMatrix& r) {
+  const Factors& f = qr_factors();
+  S21BasicMatrix upper(cols_, cols_), thin(rows_, cols_);
+  for (int m = 0; m < cols_; m++) {
+    std::copy(f.a.row_ptr(m) + m, f.a.row_ptr(m) + cols_,
+              upper.row_ptr(m) + m);
+  }
+  s21::QrFormQ(rows_, cols_, f.a.matrix_, f.a.ld_, f.tau.data(),
+               thin.matrix_, thin.ld_);
+  q = std::move(thin);
+  r = std::move(upper);
+}
+
+/**
+ * @brief Решение по методу наименьших квадратов: Q^T применяется к B
+ * отражениями QR-разложения копии A (сохраняется, повторные вызовы с другими
+ * B не раскладывают A заново), затем R * X = (Q^T * B)(0:cols_) решается
+ * обратной подстановкой. Нормальные уравнения A^T * A не строятся, поэтому
+ * обусловленность не возводится в квадрат
+ * @param b Правые части rows_ x k
+ * @return Решение X cols_ x k
+ */
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::LeastSquares(const S21BasicMatrix& b) {
+  if (rows_ != b.rows_) not_equal();
+  const Factors& f = qr_factors();
+  S21BasicMatrix rhs(b);
+  s21::QrApplyQt(rows_, cols_, b.cols_, f.a.matrix_, f.a.ld_, f.tau.data(),
+                 rhs.matrix_, rhs.ld_);
+  s21::UpperSolve(cols_, b.cols_, f.a.matrix_, f.a.ld_, rhs.matrix_,
+                  rhs.ld_);
+  S21BasicMatrix x(cols_, b.cols_);
+  for (int m = 0; m < cols_; m++) {
+    std::copy(rhs.row_ptr(m), rhs.row_ptr(m) + b.cols_, x.row_ptr(m));
+  }
+  return x;
+}
+
 //-------------Перегрузки-------------------
 
 /**
@@ -330,99 +772,111 @@ S21Matrix S21Matrix::InverseMatrix() {
  * @param other Ссылка на сравниваемую матрицу
  * @return 1 - матрицы равны, 0 - матрицы не равны
  */
-bool S21Matrix::operator==(const S21Matrix& other) {
+template <typename T>
+bool S21BasicMatrix<T>::operator==(const S21BasicMatrix& other) {
   return this->EqMatrix(other);
 }
 
 /**
  * @brief Перегрузка (=) присвоение матрице значений другой матрицы
+ * Если число элементов совпадает, данные копируются в уже выделенный буфер,
+ * иначе новый буфер выделяется до освобождения старого (при нехватке памяти
+ * текущая матрица не меняется)
  * @param other Матрица, значение которой хотим присвоить
- * @return Матрица, которой присвоили значение
+ * @return Ссылка на матрицу, которой присвоили значение
  */
-S21Matrix S21Matrix::operator=(const S21Matrix& other) {
-  this->~S21Matrix();
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator=(const S21BasicMatrix& other) {
+  if (this == &other) return *this;
+  if ((size_t)rows_ * ld_ != (size_t)other.rows_ * other.cols_ ||
+      read_only_) {
+    S21BasicMatrix temp(other);
+    return *this = std::move(temp);
+  }
   rows_ = other.rows_;
   cols_ = other.cols_;
-  allocate_mem();
+  ld_ = other.cols_;
   copy_matrix(other);
   return *this;
 }
 
 /**
- * @brief Перегрузка (+) cложение двух матриц
- * @param other Прибавляемая матрица, второе слагаемое
- * @return Матрица, содержащая результат суммы
- */
-S21Matrix S21Matrix::operator+(const S21Matrix& other) {
-  S21Matrix res(*this);
-  res.SumMatrix(other);
-  return res;
-}
-
-/**
- * @brief Перегрузка (-) вычитание одной матрицы из другой
- * @param other Вычитаемая матрица
- * @return Матрица, содержащая результат разности
+ * @brief Перегрузка (=) перенос: текущая матрица забирает буфер другой,
+ * другая остается пустой (0 x 0)
+ * @param other Матрица, буфер которой забираем
+ * @return Ссылка на матрицу, которой присвоили значение
  */
-S21Matrix S21Matrix::operator-(const S21Matrix& other) {
-  S21Matrix res(*this);
-  res.SubMatrix(other);
-  return res;
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator=(
+    S21BasicMatrix&& other) noexcept {
+  if (this != &other) {
+    if (matrix_) alloc_->Deallocate(matrix_, (size_t)rows_ * ld_ * sizeof(T));
+    rows_ = other.rows_;
+    cols_ = other.cols_;
+    ld_ = other.ld_;
+    matrix_ = other.matrix_;
+    alloc_ = other.alloc_;
+    read_only_ = other.read_only_;
+    factors_ = std::move(other.factors_);
+    other.matrix_ = nullptr;
+    other.rows_ = other.cols_ = other.ld_ = 0;
+  }
+  return *this;
 }
 
 /**
- * @brief Перегрузка (*) Присвоение умножения (MulMatrix) (объект на объект)
+ * @brief Перегрузка (*) Произведение матриц (объект на объект): блочный GEMM
+ * (см. s21_gemm.h) прямо в буфер результата; по Штрассену–Винограду, если
+ * задан StrassenCrossover (см. s21_strassen.h). Множитель-столбец (N x 1) или
+ * строка (1 x N) считается ядрами Gemv / Gevm
  * @param other Второй множитель
  * @return Матрица, содержащая результат произведения матриц
  */
-S21Matrix S21Matrix::operator*(const S21Matrix& other) {
-  S21Matrix res(*this);
-  res.MulMatrix(other);
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::operator*(const S21BasicMatrix& other) {
+  if (cols_ != other.rows_) not_equal();
+  S21BasicMatrix res(rows_, other.cols_);
+  s21::StrassenGemm(rows_, other.cols_, cols_, matrix_, ld_, other.matrix_,
+                    other.ld_, res.matrix_, res.ld_);
   return res;
 }
 
 /**
- * @brief Перегрузка (*), дружественные операторы. Присвоение умножения
- * (MulNumber) (объект на число)
- * @param other Матрица - первый множитель
- * @param num Число - второй множитель
- * @return Матрица, содержащая результат произведения матрицы на число
+ * @brief Перегрузка (+=) Присвоение сложения (SumMatrix)
+ * @param other Вторая матрица - слагаемое
+ * @return Ссылка на текущую матрицу, уже содержащую результат сложения
  */
-S21Matrix operator*(const S21Matrix& other, double num) {
-  S21Matrix res(other);
-  res.MulNumber(num);
-  return res;
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator+=(const S21BasicMatrix& other) {
+  SumMatrix(other);
+  return *this;
 }
 
 /**
- * @brief Перегрузка (*), дружественные операторы. Присвоение умножения
- * (MulNumber) (число на объект)
- * @param num Число - первый множитель
- * @param other Матрица - второй множитель
- * @return Матрица, содержащая результат произведения числа на матрицу
+ * @brief Перегрузка (-=) Присвоение разности (SubMatrix)
+ * @param other Вторая матрица - вычитаемое
+ * @return Ссылка на текущую матрицу, уже содержащую результат разности
  */
-S21Matrix operator*(double num, const S21Matrix& other) {
-  S21Matrix res(other);
-  res.MulNumber(num);
-  return res;
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator-=(const S21BasicMatrix& other) {
+  SubMatrix(other);
+  return *this;
 }
 
 /**
- * @brief Перегрузка (+=) Присвоение сложения (SumMatrix)
- * @param other Вторая матрица - слагаемое
- * @return Ссылка на текущую матрицу, уже содержащую результат сложения
+ * @brief Перегрузка (+=) с видом справа (SumMatrix)
  */
-S21Matrix& S21Matrix::operator+=(const S21Matrix& other) {
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator+=(ConstView other) {
   SumMatrix(other);
   return *this;
 }
 
 /**
- * @brief Перегрузка (-=) Присвоение разности (SubMatrix)
- * @param other Вторая матрица - вычитаемое
- * @return Ссылка на текущую матрицу, уже содержащую результат разности
+ * @brief Перегрузка (-=) с видом справа (SubMatrix)
  */
-S21Matrix& S21Matrix::operator-=(const S21Matrix& other) {
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator-=(ConstView other) {
   SubMatrix(other);
   return *this;
 }
@@ -432,7 +886,8 @@ S21Matrix& S21Matrix::operator-=(const S21Matrix& other) {
  * @param other Вещественной число - второй множитель
  * @return Ссылка на текущую матрицу, уже содержащую результат произведения
  */
-S21Matrix& S21Matrix::operator*=(double num) {
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator*=(T num) {
   MulNumber(num);
   return *this;
 }
@@ -442,7 +897,8 @@ S21Matrix& S21Matrix::operator*=(double num) {
  * @param other Вторая матрица - множитель
  * @return Ссылка на текущую матрицу, уже содержащую результат произведения
  */
-S21Matrix& S21Matrix::operator*=(const S21Matrix& other) {
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator*=(const S21BasicMatrix& other) {
   MulMatrix(other);
   return *this;
 }
@@ -454,42 +910,43 @@ S21Matrix& S21Matrix::operator*=(const S21Matrix& other) {
  * @param cols Требуемый столбец в матрице
  * @return Число, содержащееся в матрице по искомой строке и столбцу
  */
-double& S21Matrix::operator()(int rows, int cols) {
+template <typename T>
+T& S21BasicMatrix<T>::operator()(int rows, int cols) {
   if (rows >= rows_ || cols >= cols_ || rows < 0 || cols < 0) not_range();
-  return matrix_[rows][cols];
+  begin_write();
+  return row_ptr(rows)[cols];
 }
 
 /**
- * @brief Выделение памяти на матрицу
+ * @brief Выделение памяти на матрицу единым непрерывным блоком (построчно,
+ * row-major) размером rows_ x ld_, выровненным под векторные загрузки.
+ * Буфер берется у текущего аллокатора потока (пул по умолчанию или арена
+ * S21ArenaScope, см. s21_allocator.h)
  */
-void S21Matrix::allocate_mem() {
-  matrix_ = new double*[rows_];
-  for (int i = 0; i < rows_; i++) {
-    matrix_[i] = new double[cols_];
-  }
+template <typename T>
+void S21BasicMatrix<T>::allocate_mem() {
+  alloc_ = S21Allocator::Current();
+  read_only_ = false;
+  matrix_ = static_cast<T*>(alloc_->Allocate((size_t)rows_ * ld_ * sizeof(T)));
 }
 
 /**
- * @brief Заполнение матрицы с консоли
+ * @brief Заполнение матрицы с консоли: строки ввода разбираются целиком
+ * (s21::ReadMatrixText, std::from_chars), а не по одному числу из потока
  */
-void S21Matrix::fill_matrix() {
-  for (int m = 0; m < rows_; m++) {
-    for (int n = 0; n < cols_; n++) {
-      cin >> this->matrix_[m][n];
-    }
-  }
+template <typename T>
+void S21BasicMatrix<T>::fill_matrix() {
+  s21::ReadMatrixText(*this, cin);
 }
 
 /**
- * @brief Вывод-печать матрицы в консоль
+ * @brief Вывод-печать матрицы в консоль: текст формируется целиком
+ * (s21::WriteMatrixText, точная кратчайшая запись чисел) и выводится без
+ * сброса буфера после каждой строки
  */
-void S21Matrix::print_matrix() {
-  for (int m = 0; m < rows_; m++) {
-    for (int n = 0; n < cols_; n++) {
-      cout << this->matrix_[m][n] << " ";
-    }
-    cout << endl;
-  }
+template <typename T>
+void S21BasicMatrix<T>::print_matrix() {
+  s21::WriteMatrixText(*this, cout);
 }
 
 /**
@@ -498,10 +955,12 @@ void S21Matrix::print_matrix() {
  * @param fill_start Число, с которого начинем заполнять матрицу
  * @param step Шаг заполнения матрицы (плюсуемое значение)
  */
-void S21Matrix::sequent_filling(double fill_start, double step) {
+template <typename T>
+void S21BasicMatrix<T>::sequent_filling(T fill_start, T step) {
+  begin_write();
   for (int m = 0; m < rows_; m++) {
     for (int n = 0; n < cols_; n++) {
-      this->matrix_[m][n] =
+      row_ptr(m)[n] =
           fill_start;  //тут надо как-то дописать саму передаваемую матрицу
       fill_start += step;
     }
@@ -512,35 +971,55 @@ void S21Matrix::sequent_filling(double fill_start, double step) {
  * @brief Копирует в новую матрицу, старую матрицу
  * @param old Старая матрица, которую копируем
  */
-void S21Matrix::copy_matrix(const S21Matrix& old) {
-  for (int m = 0; m < this->rows_; m++) {
-    for (int n = 0; n < this->cols_; n++) {
-      this->matrix_[m][n] = old.matrix_[m][n];
-    }
-  }
+template <typename T>
+void S21BasicMatrix<T>::copy_matrix(const S21BasicMatrix& old) {
+  begin_write();
+  apply_rows(rows_, cols_, matrix_, ld_, old.matrix_, old.ld_,
+             s21::Simd<T>().copy);
 }
 
-void S21Matrix::not_square() {
+template <typename T>
+void S21BasicMatrix<T>::not_square() {
   throw std::invalid_argument("Матрица не является квадратной");
 }
 
-void S21Matrix::not_exist() {
+template <typename T>
+void S21BasicMatrix<T>::not_exist() {
   throw std::invalid_argument("Матрица не существует");
 }
 
-void S21Matrix::not_same_size() {
+template <typename T>
+void S21BasicMatrix<T>::not_same_size() {
   throw std::invalid_argument("Матрицы должны иметь одинаковую размерность");
 }
 
-void S21Matrix::not_range() {
+template <typename T>
+void S21BasicMatrix<T>::not_range() {
   throw std::out_of_range("Индекс за пределами матрицы");
 }
 
-void S21Matrix::not_equal() {
+template <typename T>
+void S21BasicMatrix<T>::not_equal() {
   throw std::invalid_argument(
       "Число столбцов первой матрицы не равно числу строк второй матрицы");
 }
 
-void S21Matrix::null_determinant() {
+template <typename T>
+void S21BasicMatrix<T>::null_determinant() {
   throw std::invalid_argument("Определитель матрицы равен 0");
-}
\ No newline at end of file
+}
+
+template <typename T>
+void S21BasicMatrix<T>::not_positive_definite() {
+  throw std::invalid_argument(
+      "Матрица не является симметричной положительно определенной");
+}
+
+template <typename T>
+void S21BasicMatrix<T>::not_full_rank() {
+  throw std::invalid_argument("Столбцы матрицы линейно зависимы");
+}
+
+template class S21BasicMatrix<float>;
+template class S21BasicMatrix<double>;
+template class S21BasicMatrix<long double>;
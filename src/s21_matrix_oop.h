@@ -1,8 +1,19 @@
 #ifndef __S21MATRIX_H__
 #define __S21MATRIX_H__
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <memory>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <vector>
+
+#include "s21_allocator.h"
+#include "s21_expr.h"
+#include "s21_linalg.h"
+#include "s21_matrix_view.h"
 
 using std::cin;
 using std::cout;
@@ -13,65 +24,483 @@ using std::endl;
 enum code_type { OK, ERROR };  // OK - 0, ERROR - 1
 enum code_check { NO, YES };   // NO - 0, YES - 1
 
-class S21Matrix {
+/**
+ * @brief Точность сравнения матриц (EqMatrix) для типа элемента: примерно
+ * половина десятичных разрядов мантиссы. Для double это SCI_NOT
+ */
+template <typename T>
+struct S21Tolerance;
+template <>
+struct S21Tolerance<float> {
+  static constexpr float value = 1e-4f;
+};
+template <>
+struct S21Tolerance<double> {
+  static constexpr double value = SCI_NOT;
+};
+template <>
+struct S21Tolerance<long double> {
+  static constexpr long double value = 1e-9L;
+};
+
+/**
+ * @brief Матрица с элементами типа T (float, double или long double)
+ * Все операции определены для каждого из трех типов; поэлементные ядра,
+ * GEMM и транспонирование специализированы под тип (для float вектор вмещает
+ * вдвое больше элементов). S21Matrix - матрица double
+ */
+template <typename T>
+class S21BasicMatrix {
  private:
   int rows_, cols_;
-  double** matrix_;
+  int ld_;  // шаг между строками (leading dimension) в элементах
+  T* matrix_;
+  S21Allocator* alloc_;  // аллокатор, выделивший matrix_
+  // matrix_ только для чтения (отображение MapMode::kReadOnly): перед первой
+  // записью матрица переносится в буфер текущего аллокатора
+  bool read_only_ = false;
+
+  T* row_ptr(int r) { return matrix_ + (size_t)r * ld_; }
+  const T* row_ptr(int r) const { return matrix_ + (size_t)r * ld_; }
+
+  // Последнее разложение матрицы (LU, Холецкого или QR): Determinant,
+  // InverseMatrix, CalcComplements, Solve, SPD-методы, QR и LeastSquares
+  // берут его отсюда, если матрица с тех пор не менялась. Сбрасывается
+  // изменяющими методами и присваиванием, а также выдачей доступа на запись
+  // (operator(), data(), view(), Block, Row, Col). Запись через ссылку или
+  // вид, полученные раньше, ловит контрольная сумма элементов: она
+  // сохраняется с разложением и сверяется перед каждым его использованием
+  struct Factors;
+  // Удаление в s21_matrix_oop.cpp, где Factors определен (шаблонные
+  // конструкторы в этом заголовке тоже уничтожают factors_)
+  struct FactorsDeleter {
+    void operator()(Factors* f) const;
+  };
+  using FactorsPtr = std::unique_ptr<Factors, FactorsDeleter>;
+  FactorsPtr factors_;
+  void drop_factors();
+  const Factors* valid_factors();
+  // Подготовка к записи в matrix_: сброс разложения и копия буфера только
+  // для чтения. Виды, выданные до первой записи, указывают на старый буфер
+  void begin_write();
+  const Factors& lu_factors();
+  const Factors& cholesky_factors();
+  const Factors& qr_factors();
 
  public:
-  S21Matrix();
-  S21Matrix(int rows, int cols);
-  S21Matrix(const S21Matrix& other);
-  S21Matrix(S21Matrix&& other);
-  ~S21Matrix();
+  using value_type = T;
+  using View = S21BasicMatrixView<T>;
+  using ConstView = S21BasicMatrixView<const T>;
+
+  S21BasicMatrix();
+  S21BasicMatrix(int rows, int cols);
+  S21BasicMatrix(const S21BasicMatrix& other);
+  S21BasicMatrix(S21BasicMatrix&& other) noexcept;
+  // Матрица на готовом буфере data из rows x cols элементов (выровнен на
+  // kMatrixAlign): в деструкторе буфер возвращается owner->Deallocate.
+  // read_only - буфер нельзя менять, он копируется при первой записи
+  S21BasicMatrix(int rows, int cols, T* data, S21Allocator* owner,
+                 bool read_only = false);
+  template <typename E>
+  S21BasicMatrix(const s21::S21Expr<E>& expr);
+  // Копия элементов вида
+  explicit S21BasicMatrix(ConstView view);
+  ~S21BasicMatrix();
 
   // Accessors:
-  int acc_rows();
-  int acc_cols();
+  int acc_rows() const;
+  int acc_cols() const;
+  // Непрерывный row-major буфер rows x cols
+  T* data() {
+    begin_write();
+    return matrix_;
+  }
+  const T* data() const { return matrix_; }
+  // Лист шаблона выражений, ссылающийся на буфер матрицы (см. s21_expr.h)
+  s21::ExprLeaf<T> expr_leaf() const {
+    return s21::ExprLeaf<T>(matrix_, rows_, cols_);
+  }
+
+  // Виды на буфер матрицы (s21_matrix_view.h): действительны, пока матрица
+  // жива и не меняет размер
+  View view() {
+    begin_write();
+    return View(matrix_, rows_, cols_, ld_);
+  }
+  ConstView view() const { return ConstView(matrix_, rows_, cols_, ld_); }
+  operator ConstView() const { return view(); }
+  View Block(int r, int c, int rows, int cols) {
+    return view().Block(r, c, rows, cols);
+  }
+  View Row(int r) { return view().Row(r); }
+  View Col(int c) { return view().Col(c); }
 
   // Mutator:
   void mutator(int rows, int cols);
 
   // Operations:
-  bool EqMatrix(const S21Matrix& other);
-  void SumMatrix(const S21Matrix& other);
-  void SubMatrix(const S21Matrix& other);
-  void MulNumber(const double num);
-  void MulMatrix(const S21Matrix& other);
-  S21Matrix Transpose();
-  double Determinant();
-  void TriangMatrix(double& result);
-  bool FinfDiagNullElem(int g);
-  S21Matrix CalcComplements();
-  S21Matrix CreateMiniMatrix(int r, int c);
-  S21Matrix InverseMatrix();
+  bool EqMatrix(const S21BasicMatrix& other);
+  void SumMatrix(const S21BasicMatrix& other);
+  void SubMatrix(const S21BasicMatrix& other);
+  void MulNumber(const T num);
+  void MulMatrix(const S21BasicMatrix& other);
+  // y = A * x (x длины cols, y длины rows) и y = x^T * A (x длины rows,
+  // y длины cols) без выделения памяти: y перезаписывается
+  void MulVector(const T* x, T* y) const;
+  std::vector<T> MulVector(const std::vector<T>& x) const;
+  void VectorMul(const T* x, T* y) const;
+  std::vector<T> VectorMul(const std::vector<T>& x) const;
+  // Те же операции с видом (блоком, строкой, транспонированной матрицей)
+  bool EqMatrix(ConstView other);
+  void SumMatrix(ConstView other);
+  void SubMatrix(ConstView other);
+  void MulMatrix(ConstView other);
+  S21BasicMatrix Transpose();
+  void TransposeInPlace();
+  T Determinant();
+  S21BasicMatrix CalcComplements();
+  S21BasicMatrix CreateMiniMatrix(int r, int c);
+  S21BasicMatrix InverseMatrix();
+
+  // Linear systems:
+  // Решение A * X = B для одной или нескольких правых частей (столбцы B) по
+  // LU-разложению, без обращения A
+  S21BasicMatrix Solve(const S21BasicMatrix& b,
+                       s21::SolveMode mode = s21::SolveMode::kDirect);
+
+  // Symmetric positive-definite matrices (через разложение Холецкого, вдвое
+  // меньше операций, чем у LU; не SPD матрица - исключение):
+  T DeterminantSPD();
+  S21BasicMatrix InverseMatrixSPD();
+  S21BasicMatrix SolveSPD(const S21BasicMatrix& b);
+  // Переопределенные системы (rows_ >= cols_): X, минимизирующий
+  // ||A * X - B|| для каждого столбца B, через QR-разложение
+  S21BasicMatrix LeastSquares(const S21BasicMatrix& b);
+
+  // Factorizations:
+  int LUInPlace(std::vector<int>& perm);
+  int LU(S21BasicMatrix& l, S21BasicMatrix& u, std::vector<int>& perm);
+  bool CholeskyInPlace();
+  bool Cholesky(S21BasicMatrix& l);
+  void QR(S21BasicMatrix& q, S21BasicMatrix& r);
 
   // Overloads:
-  S21Matrix operator=(const S21Matrix& other);
-  bool operator==(const S21Matrix& other);
-  S21Matrix operator+(const S21Matrix& other);
-  S21Matrix operator-(const S21Matrix& other);
-  S21Matrix operator*(const S21Matrix& other);
-  friend S21Matrix operator*(const S21Matrix& other, double num);
-  friend S21Matrix operator*(double num, const S21Matrix& other);
-  S21Matrix& operator+=(const S21Matrix& other);
-  S21Matrix& operator-=(const S21Matrix& other);
-  S21Matrix& operator*=(double num);
-  S21Matrix& operator*=(const S21Matrix& other);
-  double& operator()(int rows, int cols);
+  S21BasicMatrix& operator=(const S21BasicMatrix& other);
+  S21BasicMatrix& operator=(S21BasicMatrix&& other) noexcept;
+  template <typename E>
+  S21BasicMatrix& operator=(const s21::S21Expr<E>& expr);
+  bool operator==(const S21BasicMatrix& other);
+  S21BasicMatrix operator*(const S21BasicMatrix& other);
+  S21BasicMatrix& operator+=(const S21BasicMatrix& other);
+  S21BasicMatrix& operator-=(const S21BasicMatrix& other);
+  S21BasicMatrix& operator+=(ConstView other);
+  S21BasicMatrix& operator-=(ConstView other);
+  template <typename E>
+  S21BasicMatrix& operator+=(const s21::S21Expr<E>& expr);
+  template <typename E>
+  S21BasicMatrix& operator-=(const s21::S21Expr<E>& expr);
+  S21BasicMatrix& operator*=(T num);
+  S21BasicMatrix& operator*=(const S21BasicMatrix& other);
+  T& operator()(int rows, int cols);
 
   // Additional Methods:
   void allocate_mem();
   void fill_matrix();
   void print_matrix();
-  void sequent_filling(double fill_start, double step);
-  void copy_matrix(const S21Matrix& old);
-  void not_square();
-  void not_exist();
-  void not_same_size();
-  void not_range();
-  void not_equal();
-  void null_determinant();
+  void sequent_filling(T fill_start, T step);
+  void copy_matrix(const S21BasicMatrix& old);
+  static void not_square();
+  static void not_exist();
+  static void not_same_size();
+  static void not_range();
+  static void not_equal();
+  static void null_determinant();
+  static void not_positive_definite();
+  static void not_full_rank();
+};
+
+using S21Matrix = S21BasicMatrix<double>;
+using S21MatrixF = S21BasicMatrix<float>;
+using S21MatrixLD = S21BasicMatrix<long double>;
+
+// Нешаблонные члены собраны в s21_matrix_oop.cpp для трех типов
+extern template class S21BasicMatrix<float>;
+extern template class S21BasicMatrix<double>;
+extern template class S21BasicMatrix<long double>;
+
+//-------------Шаблоны выражений-------------------
+
+/**
+ * @brief Конструктор из выражения: матрица вычисляется одним проходом
+ * @param expr Результат операторов +, - и умножения на число
+ */
+template <typename T>
+template <typename E>
+S21BasicMatrix<T>::S21BasicMatrix(const s21::S21Expr<E>& expr)
+    : rows_(expr.rows()), cols_(expr.cols()), ld_(expr.cols()) {
+  allocate_mem();
+  s21::EvalExpr(matrix_, expr.node(), (size_t)rows_ * ld_);
+}
+
+/**
+ * @brief Перегрузка (=) присвоение выражения. При совпадении числа элементов
+ * результат пишется в текущий буфер (в том числе когда текущая матрица сама
+ * входит в выражение, например a = a + b)
+ * @param expr Присваиваемое выражение
+ * @return Ссылка на матрицу, которой присвоили значение
+ */
+template <typename T>
+template <typename E>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator=(
+    const s21::S21Expr<E>& expr) {
+  if ((size_t)rows_ * ld_ != (size_t)expr.rows() * expr.cols() ||
+      read_only_) {
+    return *this = S21BasicMatrix(expr);
+  }
+  drop_factors();
+  rows_ = expr.rows();
+  cols_ = ld_ = expr.cols();
+  s21::EvalExpr(matrix_, expr.node(), (size_t)rows_ * ld_);
+  return *this;
+}
+
+/**
+ * @brief Перегрузка (+=) с выражением справа: прибавляется без вычисления
+ * выражения во временную матрицу
+ */
+template <typename T>
+template <typename E>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator+=(
+    const s21::S21Expr<E>& expr) {
+  if (rows_ != expr.rows() || cols_ != expr.cols()) not_same_size();
+  // Выражение может читать старый буфер только для чтения
+  if (read_only_) return *this = S21BasicMatrix(*this + expr);
+  drop_factors();
+  s21::EvalExpr(matrix_,
+                s21::ExprBinary<s21::ExprLeaf<T>, E, s21::ExprAdd>(
+                    expr_leaf(), expr.node()),
+                (size_t)rows_ * ld_);
+  return *this;
+}
+
+/**
+ * @brief Перегрузка (-=) с выражением справа
+ */
+template <typename T>
+template <typename E>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator-=(
+    const s21::S21Expr<E>& expr) {
+  if (rows_ != expr.rows() || cols_ != expr.cols()) not_same_size();
+  if (read_only_) return *this = S21BasicMatrix(*this - expr);
+  drop_factors();
+  s21::EvalExpr(matrix_,
+                s21::ExprBinary<s21::ExprLeaf<T>, E, s21::ExprSub>(
+                    expr_leaf(), expr.node()),
+                (size_t)rows_ * ld_);
+  return *this;
+}
+
+namespace s21 {
+namespace expr_detail {
+
+/**
+ * @brief Лист, владеющий временной матрицей-операндом (a + Make(), a * b * 2):
+ * матрица переносится в узел и живет, пока живо выражение. Копии узла делят
+ * одну матрицу
+ */
+template <typename T>
+class ExprOwned {
+ public:
+  using value_type = T;
+  explicit ExprOwned(S21BasicMatrix<T>&& m)
+      : m_(std::make_shared<S21BasicMatrix<T>>(std::move(m))),
+        leaf_(m_->expr_leaf()) {}
+  int rows() const { return leaf_.rows(); }
+  int cols() const { return leaf_.cols(); }
+  template <typename V>
+  void load(size_t k, V& v) const {
+    leaf_.load(k, v);
+  }
+
+ private:
+  std::shared_ptr<const S21BasicMatrix<T>> m_;
+  ExprLeaf<T> leaf_;
 };
 
+template <typename T>
+ExprLeaf<T> AsNode(const S21BasicMatrix<T>& m) {
+  return m.expr_leaf();
+}
+template <typename T>
+ExprOwned<T> AsNode(S21BasicMatrix<T>&& m) {
+  return ExprOwned<T>(std::move(m));
+}
+template <typename E>
+const E& AsNode(const S21Expr<E>& e) {
+  return e.node();
+}
+
+// Операнды поэлементных операторов: матрица или невычисленное выражение.
+// value_type - тип элемента операнда
+template <typename A>
+struct IsOperand : std::false_type {
+  using value_type = void;
+};
+template <typename T>
+struct IsOperand<S21BasicMatrix<T>> : std::true_type {
+  using value_type = T;
+};
+template <typename E>
+struct IsOperand<S21Expr<E>> : std::true_type {
+  using value_type = typename E::value_type;
+};
+
+template <typename A>
+using Operand = IsOperand<std::decay_t<A>>;
+
+// Оба операнда - матрицы или выражения с одним типом элемента (смешивать
+// float и double в одном выражении нельзя)
+template <typename A, typename B>
+using EnableOperands = std::enable_if_t<
+    Operand<A>::value && Operand<B>::value &&
+        std::is_same<typename Operand<A>::value_type,
+                     typename Operand<B>::value_type>::value,
+    int>;
+
+template <typename A>
+using OperandValue = typename Operand<A>::value_type;
+
+template <typename Op, typename A, typename B>
+auto MakeBinary(A&& a, B&& b) {
+  auto l = AsNode(std::forward<A>(a));
+  auto r = AsNode(std::forward<B>(b));
+  if (l.rows() != r.rows() || l.cols() != r.cols()) S21Matrix::not_same_size();
+  return S21Expr<ExprBinary<decltype(l), decltype(r), Op>>(
+      ExprBinary<decltype(l), decltype(r), Op>(l, r));
+}
+
+template <typename A>
+auto MakeScale(A&& a, OperandValue<A> num) {
+  auto e = AsNode(std::forward<A>(a));
+  return S21Expr<ExprScale<decltype(e)>>(ExprScale<decltype(e)>(e, num));
+}
+
+}  // namespace expr_detail
+}  // namespace s21
+
+/**
+ * @brief Перегрузка (+) cложение двух матриц (или выражений)
+ * @return Невычисленное выражение, размеры проверяются сразу. Временная
+ * матрица-операнд переносится в выражение
+ */
+template <typename A, typename B, s21::expr_detail::EnableOperands<A, B> = 0>
+auto operator+(A&& a, B&& b) {
+  return s21::expr_detail::MakeBinary<s21::ExprAdd>(std::forward<A>(a),
+                                                    std::forward<B>(b));
+}
+
+/**
+ * @brief Перегрузка (-) вычитание двух матриц (или выражений)
+ * @return Невычисленное выражение, размеры проверяются сразу
+ */
+template <typename A, typename B, s21::expr_detail::EnableOperands<A, B> = 0>
+auto operator-(A&& a, B&& b) {
+  return s21::expr_detail::MakeBinary<s21::ExprSub>(std::forward<A>(a),
+                                                    std::forward<B>(b));
+}
+
+/**
+ * @brief Перегрузка (*) умножение матрицы (или выражения) на число
+ */
+template <typename A, s21::expr_detail::EnableOperands<A, A> = 0>
+auto operator*(A&& a, s21::expr_detail::OperandValue<A> num) {
+  return s21::expr_detail::MakeScale(std::forward<A>(a), num);
+}
+
+/**
+ * @brief Перегрузка (*) умножение числа на матрицу (или выражение)
+ */
+template <typename A, s21::expr_detail::EnableOperands<A, A> = 0>
+auto operator*(s21::expr_detail::OperandValue<A> num, A&& a) {
+  return s21::expr_detail::MakeScale(std::forward<A>(a), num);
+}
+
+//-------------Читающие методы выражения-------------------
+
+/**
+ * @brief Элемент выражения (rows, cols): считается только он
+ */
+template <typename E>
+typename E::value_type s21::S21Expr<E>::operator()(int rows, int cols) const {
+  if (rows >= this->rows() || cols >= this->cols() || rows < 0 || cols < 0) {
+    Matrix::not_range();
+  }
+  value_type v;
+  node_.load((size_t)rows * this->cols() + cols, v);
+  return v;
+}
+
+/**
+ * @brief Выражение, вычисленное в матрицу
+ */
+template <typename E>
+S21BasicMatrix<typename E::value_type> s21::S21Expr<E>::eval() const {
+  return Matrix(*this);
+}
+
+template <typename E>
+bool s21::S21Expr<E>::EqMatrix(const Matrix& other) const {
+  return eval().EqMatrix(other);
+}
+
+template <typename E>
+S21BasicMatrix<typename E::value_type> s21::S21Expr<E>::Transpose() const {
+  return eval().Transpose();
+}
+
+template <typename E>
+typename E::value_type s21::S21Expr<E>::Determinant() const {
+  return eval().Determinant();
+}
+
+template <typename E>
+S21BasicMatrix<typename E::value_type> s21::S21Expr<E>::CalcComplements()
+    const {
+  return eval().CalcComplements();
+}
+
+template <typename E>
+S21BasicMatrix<typename E::value_type> s21::S21Expr<E>::CreateMiniMatrix(
+    int r, int c) const {
+  return eval().CreateMiniMatrix(r, c);
+}
+
+template <typename E>
+S21BasicMatrix<typename E::value_type> s21::S21Expr<E>::InverseMatrix()
+    const {
+  return eval().InverseMatrix();
+}
+
+/**
+ * @brief Перегрузка (*) произведение выражения на матрицу: выражение
+ * вычисляется, затем MulMatrix
+ */
+template <typename E>
+S21BasicMatrix<typename E::value_type> operator*(
+    const s21::S21Expr<E>& expr,
+    const S21BasicMatrix<typename E::value_type>& other) {
+  S21BasicMatrix<typename E::value_type> res(expr);
+  res.MulMatrix(other);
+  return res;
+}
+
+/**
+ * @brief Перегрузка (==) выражения с матрицей
+ */
+template <typename E>
+bool operator==(const s21::S21Expr<E>& expr,
+                const S21BasicMatrix<typename E::value_type>& other) {
+  return S21BasicMatrix<typename E::value_type>(expr).EqMatrix(other);
+}
+
 #endif
\ No newline at end of file
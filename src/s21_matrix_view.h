@@ -0,0 +1,238 @@
+#ifndef __S21MATRIXVIEW_H__
+#define __S21MATRIXVIEW_H__
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include "s21_gemm.h"
+#include "s21_simd.h"
+#include "s21_transpose.h"
+
+template <typename T>
+class S21BasicMatrix;
+template <typename T>
+struct S21Tolerance;
+
+/**
+ * @brief Вид на элементы матрицы без владения памятью
+ * Элемент (i, j) вида лежит по адресу data() + i * row_stride() +
+ * j * col_stride(), поэтому блок, строка, столбец, транспонированная
+ * матрица и прореженные строки/столбцы - это тот же буфер с другими
+ * смещением, размером и шагами. Вид действителен, пока жив и не изменил
+ * размер буфер, на который он указывает. T - тип элемента (float, double,
+ * long double); вид на const T только читает. Операции чтения возвращают
+ * новые матрицы, поэлементные операции изменяют элементы на месте; области
+ * операндов не должны частично пересекаться
+ */
+template <typename T>
+class S21BasicMatrixView {
+ public:
+  using value_type = std::remove_const_t<T>;
+  using Matrix = S21BasicMatrix<value_type>;
+  using ConstView = S21BasicMatrixView<const value_type>;
+
+  S21BasicMatrixView(T* data, int rows, int cols, ptrdiff_t row_stride,
+                     ptrdiff_t col_stride = 1)
+      : data_(data),
+        rows_(rows),
+        cols_(cols),
+        row_stride_(row_stride),
+        col_stride_(col_stride) {}
+  // Вид только для чтения из изменяемого
+  template <typename U, std::enable_if_t<std::is_same<const U, T>::value &&
+                                             !std::is_const<U>::value,
+                                         int> = 0>
+  S21BasicMatrixView(const S21BasicMatrixView<U>& other)
+      : S21BasicMatrixView(other.data(), other.rows(), other.cols(),
+                           other.row_stride(), other.col_stride()) {}
+
+  // Accessors:
+  T* data() const { return data_; }
+  int rows() const { return rows_; }
+  int cols() const { return cols_; }
+  ptrdiff_t row_stride() const { return row_stride_; }
+  ptrdiff_t col_stride() const { return col_stride_; }
+  T& operator()(int i, int j) const {
+    if (i < 0 || i >= rows_ || j < 0 || j >= cols_) Matrix::not_range();
+    return at(i, j);
+  }
+
+  // Slicing (виды на тот же буфер):
+  S21BasicMatrixView Block(int r, int c, int rows, int cols) const {
+    if (r < 0 || c < 0 || rows < 0 || cols < 0 || r + rows > rows_ ||
+        c + cols > cols_) {
+      Matrix::not_range();
+    }
+    return S21BasicMatrixView(data_ + r * row_stride_ + c * col_stride_, rows,
+                              cols, row_stride_, col_stride_);
+  }
+  S21BasicMatrixView Row(int r) const { return Block(r, 0, 1, cols_); }
+  S21BasicMatrixView Col(int c) const { return Block(0, c, rows_, 1); }
+  S21BasicMatrixView Transposed() const {
+    return S21BasicMatrixView(data_, cols_, rows_, col_stride_, row_stride_);
+  }
+  // Каждая row_step-я строка и col_step-й столбец, начиная с первых
+  S21BasicMatrixView Strided(int row_step, int col_step) const {
+    if (row_step <= 0 || col_step <= 0) {
+      throw std::invalid_argument("Шаг вида должен быть положительным");
+    }
+    return S21BasicMatrixView(data_, (rows_ + row_step - 1) / row_step,
+                              (cols_ + col_step - 1) / col_step,
+                              row_stride_ * row_step, col_stride_ * col_step);
+  }
+
+  // Read-only operations:
+  Matrix ToMatrix() const;
+  bool EqMatrix(ConstView other) const;
+  Matrix Transpose() const { return Transposed().ToMatrix(); }
+  value_type Determinant() const { return ToMatrix().Determinant(); }
+  Matrix InverseMatrix() const { return ToMatrix().InverseMatrix(); }
+  // Произведение без копирования операндов: Gemm читает виды по их шагам
+  Matrix MulMatrix(ConstView other) const;
+  bool operator==(ConstView other) const { return EqMatrix(other); }
+  Matrix operator*(ConstView other) const { return MulMatrix(other); }
+
+  // In-place element-wise operations (только для вида на изменяемые
+  // элементы):
+  void Assign(ConstView other) const {
+    check_same(other);
+    apply(other, s21::Simd<value_type>().copy,
+          [](value_type& d, value_type s) { d = s; });
+  }
+  void SumMatrix(ConstView other) const {
+    check_same(other);
+    apply(other, s21::Simd<value_type>().add,
+          [](value_type& d, value_type s) { d += s; });
+  }
+  void SubMatrix(ConstView other) const {
+    check_same(other);
+    apply(other, s21::Simd<value_type>().sub,
+          [](value_type& d, value_type s) { d -= s; });
+  }
+  void MulNumber(value_type num) const {
+    for (int i = 0; i < rows_; i++) {
+      if (col_stride_ == 1) {
+        s21::Simd<value_type>().scale(data_ + i * row_stride_, num, cols_);
+      } else {
+        for (int j = 0; j < cols_; j++) at(i, j) *= num;
+      }
+    }
+  }
+  void Fill(value_type value) const {
+    for (int i = 0; i < rows_; i++) {
+      for (int j = 0; j < cols_; j++) at(i, j) = value;
+    }
+  }
+  const S21BasicMatrixView& operator+=(ConstView other) const {
+    SumMatrix(other);
+    return *this;
+  }
+  const S21BasicMatrixView& operator-=(ConstView other) const {
+    SubMatrix(other);
+    return *this;
+  }
+  const S21BasicMatrixView& operator*=(value_type num) const {
+    MulNumber(num);
+    return *this;
+  }
+
+ private:
+  T& at(int i, int j) const {
+    return data_[i * row_stride_ + j * col_stride_];
+  }
+  void check_same(const ConstView& other) const {
+    if (rows_ != other.rows() || cols_ != other.cols()) {
+      Matrix::not_same_size();
+    }
+  }
+  // Построчно ядром kernel, если строки обоих видов непрерывны, иначе
+  // поэлементно
+  template <typename Kernel, typename Scalar>
+  void apply(const ConstView& other, Kernel kernel, Scalar scalar) const {
+    static_assert(!std::is_const<T>::value, "вид только для чтения");
+    const bool rows_contiguous = col_stride_ == 1 && other.col_stride() == 1;
+    for (int i = 0; i < rows_; i++) {
+      const value_type* src = other.data() + i * other.row_stride();
+      if (rows_contiguous) {
+        kernel(data_ + i * row_stride_, src, cols_);
+      } else {
+        for (int j = 0; j < cols_; j++) {
+          scalar(at(i, j), src[j * other.col_stride()]);
+        }
+      }
+    }
+  }
+
+  T* data_;
+  int rows_, cols_;
+  ptrdiff_t row_stride_, col_stride_;
+};
+
+using S21MatrixView = S21BasicMatrixView<double>;
+using S21MatrixViewF = S21BasicMatrixView<float>;
+using S21MatrixViewLD = S21BasicMatrixView<long double>;
+using S21ConstMatrixView = S21BasicMatrixView<const double>;
+using S21ConstMatrixViewF = S21BasicMatrixView<const float>;
+using S21ConstMatrixViewLD = S21BasicMatrixView<const long double>;
+
+/**
+ * @brief Копия вида в новую матрицу: построчно для непрерывных строк,
+ * транспонированием для непрерывных столбцов
+ */
+template <typename T>
+typename S21BasicMatrixView<T>::Matrix S21BasicMatrixView<T>::ToMatrix()
+    const {
+  Matrix res(rows_, cols_);
+  value_type* dst = res.data();
+  if (col_stride_ == 1) {
+    for (int i = 0; i < rows_; i++) {
+      s21::Simd<value_type>().copy(dst + (size_t)i * cols_,
+                                   data_ + i * row_stride_, cols_);
+    }
+  } else if (row_stride_ == 1) {
+    s21::Transpose<value_type>(cols_, rows_, data_, col_stride_, dst, cols_);
+  } else {
+    for (int i = 0; i < rows_; i++) {
+      for (int j = 0; j < cols_; j++) dst[(size_t)i * cols_ + j] = at(i, j);
+    }
+  }
+  return res;
+}
+
+/**
+ * @brief Сравнение с точностью S21Tolerance, как у матриц
+ */
+template <typename T>
+bool S21BasicMatrixView<T>::EqMatrix(ConstView other) const {
+  check_same(other);
+  const value_type eps = S21Tolerance<value_type>::value;
+  for (int i = 0; i < rows_; i++) {
+    const value_type* a = data_ + i * row_stride_;
+    const value_type* b = other.data() + i * other.row_stride();
+    if (col_stride_ == 1 && other.col_stride() == 1) {
+      if (!s21::Simd<value_type>().equal(a, b, cols_, eps)) return false;
+    } else {
+      for (int j = 0; j < cols_; j++) {
+        value_type d = a[j * col_stride_] - b[j * other.col_stride()];
+        if (d > eps || d < -eps) return false;
+      }
+    }
+  }
+  return true;
+}
+
+template <typename T>
+typename S21BasicMatrixView<T>::Matrix S21BasicMatrixView<T>::MulMatrix(
+    ConstView other) const {
+  if (cols_ != other.rows()) Matrix::not_equal();
+  Matrix res(rows_, other.cols());
+  if (cols_ == 0) return res;
+  s21::Gemm<value_type>(rows_, other.cols(), cols_, value_type(1), data_,
+                        row_stride_, col_stride_, other.data(),
+                        other.row_stride(), other.col_stride(),
+                        value_type(0), res.data(), other.cols());
+  return res;
+}
+
+#endif
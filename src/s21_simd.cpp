@@ -0,0 +1,695 @@
+#include "s21_simd.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define S21_X86 1
+#include <immintrin.h>
+#endif
+
+namespace s21 {
+
+namespace {
+
+//-------------Скалярные ядра (любой тип)-------------------
+
+template <typename T>
+void AddScalar(T* dst, const T* src, size_t n) {
+  for (size_t i = 0; i < n; i++) dst[i] += src[i];
+}
+
+template <typename T>
+void SubScalar(T* dst, const T* src, size_t n) {
+  for (size_t i = 0; i < n; i++) dst[i] -= src[i];
+}
+
+template <typename T>
+void ScaleScalar(T* dst, T num, size_t n) {
+  for (size_t i = 0; i < n; i++) dst[i] *= num;
+}
+
+template <typename T>
+void CopyScalar(T* dst, const T* src, size_t n) {
+  for (size_t i = 0; i < n; i++) dst[i] = src[i];
+}
+
+template <typename T>
+void AxpyScalar(T* dst, T num, const T* src, size_t n) {
+  for (size_t i = 0; i < n; i++) dst[i] += num * src[i];
+}
+
+template <typename T>
+bool EqualScalar(const T* a, const T* b, size_t n, T eps) {
+  bool equal = true;
+  for (size_t i = 0; i < n && equal; i++) {
+    if (std::fabs(a[i] - b[i]) > eps) equal = false;
+  }
+  return equal;
+}
+
+template <typename T>
+void TransposeScalar(const T* src, ptrdiff_t lds, T* dst, ptrdiff_t ldd,
+                     int rows, int cols) {
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) dst[j * ldd + i] = src[i * lds + j];
+  }
+}
+
+/**
+ * @brief Обходит блок тайлами tile x tile, полные тайлы отдает ядру,
+ * края дотранспонирует скалярно
+ */
+template <int tile, typename T, typename TileKernel>
+void TransposeTiles(const T* src, ptrdiff_t lds, T* dst, ptrdiff_t ldd,
+                    int rows, int cols, TileKernel kernel) {
+  int full_rows = rows / tile * tile, full_cols = cols / tile * tile;
+  for (int i = 0; i < full_rows; i += tile) {
+    for (int j = 0; j < full_cols; j += tile) {
+      kernel(src + i * lds + j, lds, dst + j * ldd + i, ldd);
+    }
+  }
+  TransposeScalar(src + full_cols, lds, dst + full_cols * ldd, ldd, rows,
+                  cols - full_cols);
+  TransposeScalar(src + full_rows * lds, lds, dst + full_rows, ldd,
+                  rows - full_rows, full_cols);
+}
+
+#ifdef S21_X86
+
+//-------------SSE2 (2 x double)-------------------
+
+__attribute__((target("sse2"))) void AddSse2(double* dst, const double* src,
+                                             size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128d d0 = _mm_loadu_pd(dst + i), d1 = _mm_loadu_pd(dst + i + 2);
+    d0 = _mm_add_pd(d0, _mm_loadu_pd(src + i));
+    d1 = _mm_add_pd(d1, _mm_loadu_pd(src + i + 2));
+    _mm_storeu_pd(dst + i, d0);
+    _mm_storeu_pd(dst + i + 2, d1);
+  }
+  AddScalar(dst + i, src + i, n - i);
+}
+
+__attribute__((target("sse2"))) void SubSse2(double* dst, const double* src,
+                                             size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128d d0 = _mm_loadu_pd(dst + i), d1 = _mm_loadu_pd(dst + i + 2);
+    d0 = _mm_sub_pd(d0, _mm_loadu_pd(src + i));
+    d1 = _mm_sub_pd(d1, _mm_loadu_pd(src + i + 2));
+    _mm_storeu_pd(dst + i, d0);
+    _mm_storeu_pd(dst + i + 2, d1);
+  }
+  SubScalar(dst + i, src + i, n - i);
+}
+
+__attribute__((target("sse2"))) void ScaleSse2(double* dst, double num,
+                                               size_t n) {
+  __m128d k = _mm_set1_pd(num);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_pd(dst + i, _mm_mul_pd(_mm_loadu_pd(dst + i), k));
+    _mm_storeu_pd(dst + i + 2, _mm_mul_pd(_mm_loadu_pd(dst + i + 2), k));
+  }
+  ScaleScalar(dst + i, num, n - i);
+}
+
+__attribute__((target("sse2"))) void CopySse2(double* dst, const double* src,
+                                              size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_pd(dst + i, _mm_loadu_pd(src + i));
+    _mm_storeu_pd(dst + i + 2, _mm_loadu_pd(src + i + 2));
+  }
+  CopyScalar(dst + i, src + i, n - i);
+}
+
+__attribute__((target("sse2"))) void AxpySse2(double* dst, double num,
+                                              const double* src, size_t n) {
+  __m128d k = _mm_set1_pd(num);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128d d0 = _mm_loadu_pd(dst + i), d1 = _mm_loadu_pd(dst + i + 2);
+    d0 = _mm_add_pd(d0, _mm_mul_pd(k, _mm_loadu_pd(src + i)));
+    d1 = _mm_add_pd(d1, _mm_mul_pd(k, _mm_loadu_pd(src + i + 2)));
+    _mm_storeu_pd(dst + i, d0);
+    _mm_storeu_pd(dst + i + 2, d1);
+  }
+  AxpyScalar(dst + i, num, src + i, n - i);
+}
+
+__attribute__((target("sse2"))) bool EqualSse2(const double* a,
+                                               const double* b, size_t n,
+                                               double eps) {
+  const __m128d sign = _mm_set1_pd(-0.0), tol = _mm_set1_pd(eps);
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    __m128d diff = _mm_sub_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i));
+    // cmpgt ложно для NaN, как и сравнение в скалярном цикле
+    if (_mm_movemask_pd(_mm_cmpgt_pd(_mm_andnot_pd(sign, diff), tol))) {
+      return false;
+    }
+  }
+  return EqualScalar(a + i, b + i, n - i, eps);
+}
+
+__attribute__((target("sse2"))) void TransposeSse2(const double* src,
+                                                   ptrdiff_t lds, double* dst,
+                                                   ptrdiff_t ldd, int rows,
+                                                   int cols) {
+  auto tile = [](const double* s, ptrdiff_t ls, double* d, ptrdiff_t ld)
+      __attribute__((target("sse2"))) {
+    __m128d r0 = _mm_loadu_pd(s), r1 = _mm_loadu_pd(s + ls);
+    _mm_storeu_pd(d, _mm_unpacklo_pd(r0, r1));
+    _mm_storeu_pd(d + ld, _mm_unpackhi_pd(r0, r1));
+  };
+  TransposeTiles<2>(src, lds, dst, ldd, rows, cols, tile);
+}
+
+//-------------AVX2 (4 x double)-------------------
+
+__attribute__((target("avx2"))) void AddAvx2(double* dst, const double* src,
+                                             size_t n) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256d d0 = _mm256_loadu_pd(dst + i), d1 = _mm256_loadu_pd(dst + i + 4);
+    d0 = _mm256_add_pd(d0, _mm256_loadu_pd(src + i));
+    d1 = _mm256_add_pd(d1, _mm256_loadu_pd(src + i + 4));
+    _mm256_storeu_pd(dst + i, d0);
+    _mm256_storeu_pd(dst + i + 4, d1);
+  }
+  AddScalar(dst + i, src + i, n - i);
+}
+
+__attribute__((target("avx2"))) void SubAvx2(double* dst, const double* src,
+                                             size_t n) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256d d0 = _mm256_loadu_pd(dst + i), d1 = _mm256_loadu_pd(dst + i + 4);
+    d0 = _mm256_sub_pd(d0, _mm256_loadu_pd(src + i));
+    d1 = _mm256_sub_pd(d1, _mm256_loadu_pd(src + i + 4));
+    _mm256_storeu_pd(dst + i, d0);
+    _mm256_storeu_pd(dst + i + 4, d1);
+  }
+  SubScalar(dst + i, src + i, n - i);
+}
+
+__attribute__((target("avx2"))) void ScaleAvx2(double* dst, double num,
+                                               size_t n) {
+  __m256d k = _mm256_set1_pd(num);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_pd(dst + i, _mm256_mul_pd(_mm256_loadu_pd(dst + i), k));
+    _mm256_storeu_pd(dst + i + 4,
+                     _mm256_mul_pd(_mm256_loadu_pd(dst + i + 4), k));
+  }
+  ScaleScalar(dst + i, num, n - i);
+}
+
+__attribute__((target("avx2"))) void CopyAvx2(double* dst, const double* src,
+                                              size_t n) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_pd(dst + i, _mm256_loadu_pd(src + i));
+    _mm256_storeu_pd(dst + i + 4, _mm256_loadu_pd(src + i + 4));
+  }
+  CopyScalar(dst + i, src + i, n - i);
+}
+
+__attribute__((target("avx2"))) void AxpyAvx2(double* dst, double num,
+                                              const double* src, size_t n) {
+  __m256d k = _mm256_set1_pd(num);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256d d0 = _mm256_loadu_pd(dst + i), d1 = _mm256_loadu_pd(dst + i + 4);
+    d0 = _mm256_add_pd(d0, _mm256_mul_pd(k, _mm256_loadu_pd(src + i)));
+    d1 = _mm256_add_pd(d1, _mm256_mul_pd(k, _mm256_loadu_pd(src + i + 4)));
+    _mm256_storeu_pd(dst + i, d0);
+    _mm256_storeu_pd(dst + i + 4, d1);
+  }
+  AxpyScalar(dst + i, num, src + i, n - i);
+}
+
+__attribute__((target("avx2"))) bool EqualAvx2(const double* a,
+                                               const double* b, size_t n,
+                                               double eps) {
+  const __m256d sign = _mm256_set1_pd(-0.0), tol = _mm256_set1_pd(eps);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d diff =
+        _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+    __m256d gt = _mm256_cmp_pd(_mm256_andnot_pd(sign, diff), tol, _CMP_GT_OQ);
+    if (_mm256_movemask_pd(gt)) return false;
+  }
+  return EqualScalar(a + i, b + i, n - i, eps);
+}
+
+__attribute__((target("avx2"))) void TransposeAvx2(const double* src,
+                                                   ptrdiff_t lds, double* dst,
+                                                   ptrdiff_t ldd, int rows,
+                                                   int cols) {
+  auto tile = [](const double* s, ptrdiff_t ls, double* d, ptrdiff_t ld)
+      __attribute__((target("avx2"))) {
+    __m256d r0 = _mm256_loadu_pd(s), r1 = _mm256_loadu_pd(s + ls);
+    __m256d r2 = _mm256_loadu_pd(s + 2 * ls), r3 = _mm256_loadu_pd(s + 3 * ls);
+    __m256d t0 = _mm256_unpacklo_pd(r0, r1), t1 = _mm256_unpackhi_pd(r0, r1);
+    __m256d t2 = _mm256_unpacklo_pd(r2, r3), t3 = _mm256_unpackhi_pd(r2, r3);
+    _mm256_storeu_pd(d, _mm256_permute2f128_pd(t0, t2, 0x20));
+    _mm256_storeu_pd(d + ld, _mm256_permute2f128_pd(t1, t3, 0x20));
+    _mm256_storeu_pd(d + 2 * ld, _mm256_permute2f128_pd(t0, t2, 0x31));
+    _mm256_storeu_pd(d + 3 * ld, _mm256_permute2f128_pd(t1, t3, 0x31));
+  };
+  TransposeTiles<4>(src, lds, dst, ldd, rows, cols, tile);
+}
+
+//-------------AVX-512 (8 x double)-------------------
+
+__attribute__((target("avx512f"))) void AddAvx512(double* dst,
+                                                  const double* src,
+                                                  size_t n) {
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m512d d0 = _mm512_loadu_pd(dst + i), d1 = _mm512_loadu_pd(dst + i + 8);
+    d0 = _mm512_add_pd(d0, _mm512_loadu_pd(src + i));
+    d1 = _mm512_add_pd(d1, _mm512_loadu_pd(src + i + 8));
+    _mm512_storeu_pd(dst + i, d0);
+    _mm512_storeu_pd(dst + i + 8, d1);
+  }
+  AddScalar(dst + i, src + i, n - i);
+}
+
+__attribute__((target("avx512f"))) void SubAvx512(double* dst,
+                                                  const double* src,
+                                                  size_t n) {
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m512d d0 = _mm512_loadu_pd(dst + i), d1 = _mm512_loadu_pd(dst + i + 8);
+    d0 = _mm512_sub_pd(d0, _mm512_loadu_pd(src + i));
+    d1 = _mm512_sub_pd(d1, _mm512_loadu_pd(src + i + 8));
+    _mm512_storeu_pd(dst + i, d0);
+    _mm512_storeu_pd(dst + i + 8, d1);
+  }
+  SubScalar(dst + i, src + i, n - i);
+}
+
+__attribute__((target("avx512f"))) void ScaleAvx512(double* dst, double num,
+                                                    size_t n) {
+  __m512d k = _mm512_set1_pd(num);
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    _mm512_storeu_pd(dst + i, _mm512_mul_pd(_mm512_loadu_pd(dst + i), k));
+    _mm512_storeu_pd(dst + i + 8,
+                     _mm512_mul_pd(_mm512_loadu_pd(dst + i + 8), k));
+  }
+  ScaleScalar(dst + i, num, n - i);
+}
+
+__attribute__((target("avx512f"))) void CopyAvx512(double* dst,
+                                                   const double* src,
+                                                   size_t n) {
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    _mm512_storeu_pd(dst + i, _mm512_loadu_pd(src + i));
+    _mm512_storeu_pd(dst + i + 8, _mm512_loadu_pd(src + i + 8));
+  }
+  CopyScalar(dst + i, src + i, n - i);
+}
+
+__attribute__((target("avx512f"))) void AxpyAvx512(double* dst, double num,
+                                                   const double* src,
+                                                   size_t n) {
+  __m512d k = _mm512_set1_pd(num);
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m512d d0 = _mm512_loadu_pd(dst + i), d1 = _mm512_loadu_pd(dst + i + 8);
+    d0 = _mm512_add_pd(d0, _mm512_mul_pd(k, _mm512_loadu_pd(src + i)));
+    d1 = _mm512_add_pd(d1, _mm512_mul_pd(k, _mm512_loadu_pd(src + i + 8)));
+    _mm512_storeu_pd(dst + i, d0);
+    _mm512_storeu_pd(dst + i + 8, d1);
+  }
+  AxpyScalar(dst + i, num, src + i, n - i);
+}
+
+__attribute__((target("avx512f"))) bool EqualAvx512(const double* a,
+                                                    const double* b, size_t n,
+                                                    double eps) {
+  const __m512d tol = _mm512_set1_pd(eps);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512d diff =
+        _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i));
+    if (_mm512_cmp_pd_mask(_mm512_abs_pd(diff), tol, _CMP_GT_OQ)) return false;
+  }
+  return EqualScalar(a + i, b + i, n - i, eps);
+}
+
+__attribute__((target("avx512f"))) void TransposeAvx512(
+    const double* src, ptrdiff_t lds, double* dst, ptrdiff_t ldd, int rows,
+    int cols) {
+  auto tile = [](const double* s, ptrdiff_t ls, double* d, ptrdiff_t ld)
+      __attribute__((target("avx512f"))) {
+    // Формы maskz с полной маской: у обычных внутри _mm512_undefined_pd,
+    // на котором GCC 12 выдает ложное -Wuninitialized
+    const __mmask8 all = 0xFF;
+    __m512d t[8], u[8];
+    // Пары строк: t[2k] - четные элементы, t[2k + 1] - нечетные
+    for (int k = 0; k < 4; k++) {
+      __m512d r0 = _mm512_loadu_pd(s + 2 * k * ls);
+      __m512d r1 = _mm512_loadu_pd(s + (2 * k + 1) * ls);
+      t[2 * k] = _mm512_maskz_unpacklo_pd(all, r0, r1);
+      t[2 * k + 1] = _mm512_maskz_unpackhi_pd(all, r0, r1);
+    }
+    // Четверки строк: собираем 128-битные половины столбцов
+    for (int h = 0; h < 2; h++) {
+      const __m512d* th = t + 4 * h;
+      u[4 * h] = _mm512_maskz_shuffle_f64x2(all, th[0], th[2], 0x88);
+      u[4 * h + 1] = _mm512_maskz_shuffle_f64x2(all, th[1], th[3], 0x88);
+      u[4 * h + 2] = _mm512_maskz_shuffle_f64x2(all, th[0], th[2], 0xDD);
+      u[4 * h + 3] = _mm512_maskz_shuffle_f64x2(all, th[1], th[3], 0xDD);
+    }
+    for (int c = 0; c < 4; c++) {
+      __m512d lo = _mm512_maskz_shuffle_f64x2(all, u[c], u[4 + c], 0x88);
+      __m512d hi = _mm512_maskz_shuffle_f64x2(all, u[c], u[4 + c], 0xDD);
+      _mm512_storeu_pd(d + c * ld, lo);
+      _mm512_storeu_pd(d + (c + 4) * ld, hi);
+    }
+  };
+  TransposeTiles<8>(src, lds, dst, ldd, rows, cols, tile);
+}
+
+//-------------float (4/8/16 x float)-------------------
+
+// Векторные типы GCC для float: один шаблон цикла на операцию, набор
+// инструкций задает функция-обертка уровня, в которую цикл встраивается
+typedef float SimdVec4f __attribute__((vector_size(16)));
+typedef float SimdVec8f __attribute__((vector_size(32)));
+typedef float SimdVec16f __attribute__((vector_size(64)));
+
+#define S21_VEC_INLINE inline __attribute__((always_inline))
+
+// Без возврата вектора по значению: это меняло бы ABI вне target-функций
+template <typename V>
+S21_VEC_INLINE void VecLoad(const float* p, V& v) {
+  memcpy(&v, p, sizeof(V));
+}
+
+template <typename V>
+S21_VEC_INLINE void VecStore(float* p, const V& v) {
+  memcpy(p, &v, sizeof(V));
+}
+
+template <typename V>
+constexpr size_t kLanes = sizeof(V) / sizeof(float);
+
+template <typename V>
+S21_VEC_INLINE void AddVec(float* dst, const float* src, size_t n) {
+  size_t i = 0;
+  for (; i + kLanes<V> <= n; i += kLanes<V>) {
+    V d, s;
+    VecLoad(dst + i, d);
+    VecLoad(src + i, s);
+    VecStore(dst + i, d + s);
+  }
+  AddScalar(dst + i, src + i, n - i);
+}
+
+template <typename V>
+S21_VEC_INLINE void SubVec(float* dst, const float* src, size_t n) {
+  size_t i = 0;
+  for (; i + kLanes<V> <= n; i += kLanes<V>) {
+    V d, s;
+    VecLoad(dst + i, d);
+    VecLoad(src + i, s);
+    VecStore(dst + i, d - s);
+  }
+  SubScalar(dst + i, src + i, n - i);
+}
+
+template <typename V>
+S21_VEC_INLINE void ScaleVec(float* dst, float num, size_t n) {
+  size_t i = 0;
+  for (; i + kLanes<V> <= n; i += kLanes<V>) {
+    V d;
+    VecLoad(dst + i, d);
+    VecStore(dst + i, d * num);
+  }
+  ScaleScalar(dst + i, num, n - i);
+}
+
+template <typename V>
+S21_VEC_INLINE void CopyVec(float* dst, const float* src, size_t n) {
+  size_t i = 0;
+  for (; i + kLanes<V> <= n; i += kLanes<V>) {
+    V s;
+    VecLoad(src + i, s);
+    VecStore(dst + i, s);
+  }
+  CopyScalar(dst + i, src + i, n - i);
+}
+
+template <typename V>
+S21_VEC_INLINE void AxpyVec(float* dst, float num, const float* src,
+                            size_t n) {
+  size_t i = 0;
+  for (; i + kLanes<V> <= n; i += kLanes<V>) {
+    V d, s;
+    VecLoad(dst + i, d);
+    VecLoad(src + i, s);
+    VecStore(dst + i, d + num * s);
+  }
+  AxpyScalar(dst + i, num, src + i, n - i);
+}
+
+template <typename V>
+S21_VEC_INLINE bool EqualVec(const float* a, const float* b, size_t n,
+                             float eps) {
+  size_t i = 0;
+  for (; i + kLanes<V> <= n; i += kLanes<V>) {
+    V va, vb;
+    VecLoad(a + i, va);
+    VecLoad(b + i, vb);
+    V diff = va - vb;
+    // Сравнение ложно для NaN, как и в скалярном цикле: NaN не считается
+    // отличием
+    auto out = (diff > eps) | (diff < -eps);
+    for (size_t l = 0; l < kLanes<V>; l++) {
+      if (out[l]) return false;
+    }
+  }
+  return EqualScalar(a + i, b + i, n - i, eps);
+}
+
+#define S21_FLOAT_KERNELS(suffix, isa, V)                                   \
+  __attribute__((target(isa))) void AddF##suffix(float* dst,                \
+                                                 const float* src,          \
+                                                 size_t n) {                \
+    AddVec<V>(dst, src, n);                                                 \
+  }                                                                         \
+  __attribute__((target(isa))) void SubF##suffix(float* dst,                \
+                                                 const float* src,          \
+                                                 size_t n) {                \
+    SubVec<V>(dst, src, n);                                                 \
+  }                                                                         \
+  __attribute__((target(isa))) void ScaleF##suffix(float* dst, float num,   \
+                                                   size_t n) {              \
+    ScaleVec<V>(dst, num, n);                                               \
+  }                                                                         \
+  __attribute__((target(isa))) void CopyF##suffix(float* dst,               \
+                                                  const float* src,         \
+                                                  size_t n) {               \
+    CopyVec<V>(dst, src, n);                                                \
+  }                                                                         \
+  __attribute__((target(isa))) void AxpyF##suffix(                          \
+      float* dst, float num, const float* src, size_t n) {                  \
+    AxpyVec<V>(dst, num, src, n);                                           \
+  }                                                                         \
+  __attribute__((target(isa))) bool EqualF##suffix(                         \
+      const float* a, const float* b, size_t n, float eps) {                \
+    return EqualVec<V>(a, b, n, eps);                                       \
+  }
+
+S21_FLOAT_KERNELS(Sse2, "sse2", SimdVec4f)
+S21_FLOAT_KERNELS(Avx2, "avx2", SimdVec8f)
+S21_FLOAT_KERNELS(Avx512, "avx512f", SimdVec16f)
+
+#undef S21_FLOAT_KERNELS
+
+__attribute__((target("sse2"))) void TransposeFSse2(const float* src,
+                                                    ptrdiff_t lds, float* dst,
+                                                    ptrdiff_t ldd, int rows,
+                                                    int cols) {
+  auto tile = [](const float* s, ptrdiff_t ls, float* d, ptrdiff_t ld)
+      __attribute__((target("sse2"))) {
+    __m128 r0 = _mm_loadu_ps(s), r1 = _mm_loadu_ps(s + ls);
+    __m128 r2 = _mm_loadu_ps(s + 2 * ls), r3 = _mm_loadu_ps(s + 3 * ls);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(d, r0);
+    _mm_storeu_ps(d + ld, r1);
+    _mm_storeu_ps(d + 2 * ld, r2);
+    _mm_storeu_ps(d + 3 * ld, r3);
+  };
+  TransposeTiles<4>(src, lds, dst, ldd, rows, cols, tile);
+}
+
+// Тайл 8x8 используется и на уровне AVX-512: тайл 16x16 не помещается в
+// регистры без сброса и не быстрее двух проходов по 8
+__attribute__((target("avx2"))) void TransposeFAvx2(const float* src,
+                                                    ptrdiff_t lds, float* dst,
+                                                    ptrdiff_t ldd, int rows,
+                                                    int cols) {
+  auto tile = [](const float* s, ptrdiff_t ls, float* d, ptrdiff_t ld)
+      __attribute__((target("avx2"))) {
+    __m256 t[8], u[8];
+    // Пары строк перемежаются, затем четверки собираются по 64 бита
+    for (int k = 0; k < 4; k++) {
+      __m256 r0 = _mm256_loadu_ps(s + 2 * k * ls);
+      __m256 r1 = _mm256_loadu_ps(s + (2 * k + 1) * ls);
+      t[2 * k] = _mm256_unpacklo_ps(r0, r1);
+      t[2 * k + 1] = _mm256_unpackhi_ps(r0, r1);
+    }
+    for (int h = 0; h < 2; h++) {
+      const __m256* th = t + 4 * h;
+      u[4 * h] = _mm256_shuffle_ps(th[0], th[2], _MM_SHUFFLE(1, 0, 1, 0));
+      u[4 * h + 1] = _mm256_shuffle_ps(th[0], th[2], _MM_SHUFFLE(3, 2, 3, 2));
+      u[4 * h + 2] = _mm256_shuffle_ps(th[1], th[3], _MM_SHUFFLE(1, 0, 1, 0));
+      u[4 * h + 3] = _mm256_shuffle_ps(th[1], th[3], _MM_SHUFFLE(3, 2, 3, 2));
+    }
+    // Половины по 128 бит: строки 0-3 из u[0..3], строки 4-7 из u[4..7]
+    for (int c = 0; c < 4; c++) {
+      _mm256_storeu_ps(d + c * ld,
+                       _mm256_permute2f128_ps(u[c], u[4 + c], 0x20));
+      _mm256_storeu_ps(d + (c + 4) * ld,
+                       _mm256_permute2f128_ps(u[c], u[4 + c], 0x31));
+    }
+  };
+  TransposeTiles<8>(src, lds, dst, ldd, rows, cols, tile);
+}
+
+#endif  // S21_X86
+
+//-------------Таблицы ядер-------------------
+
+const SimdKernels kScalarKernels = {
+    kSimdScalar, "scalar",   AddScalar,  SubScalar,   ScaleScalar,
+    CopyScalar,  AxpyScalar, EqualScalar, TransposeScalar};
+const BasicSimdKernels<float> kScalarKernelsF = {
+    kSimdScalar, "scalar",   AddScalar,  SubScalar,   ScaleScalar,
+    CopyScalar,  AxpyScalar, EqualScalar, TransposeScalar};
+const BasicSimdKernels<long double> kScalarKernelsLD = {
+    kSimdScalar, "scalar",   AddScalar,  SubScalar,   ScaleScalar,
+    CopyScalar,  AxpyScalar, EqualScalar, TransposeScalar};
+#ifdef S21_X86
+const SimdKernels kSse2Kernels = {kSimdSse2, "sse2",    AddSse2,
+                                  SubSse2,   ScaleSse2, CopySse2,
+                                  AxpySse2,  EqualSse2, TransposeSse2};
+const SimdKernels kAvx2Kernels = {kSimdAvx2, "avx2",    AddAvx2,
+                                  SubAvx2,   ScaleAvx2, CopyAvx2,
+                                  AxpyAvx2,  EqualAvx2, TransposeAvx2};
+const SimdKernels kAvx512Kernels = {
+    kSimdAvx512, "avx512",   AddAvx512,   SubAvx512,      ScaleAvx512,
+    CopyAvx512,  AxpyAvx512, EqualAvx512, TransposeAvx512};
+const BasicSimdKernels<float> kSse2KernelsF = {
+    kSimdSse2, "sse2",      AddFSse2,   SubFSse2,      ScaleFSse2,
+    CopyFSse2, AxpyFSse2,   EqualFSse2, TransposeFSse2};
+const BasicSimdKernels<float> kAvx2KernelsF = {
+    kSimdAvx2, "avx2",      AddFAvx2,   SubFAvx2,      ScaleFAvx2,
+    CopyFAvx2, AxpyFAvx2,   EqualFAvx2, TransposeFAvx2};
+const BasicSimdKernels<float> kAvx512KernelsF = {
+    kSimdAvx512, "avx512",      AddFAvx512,   SubFAvx512,    ScaleFAvx512,
+    CopyFAvx512, AxpyFAvx512,   EqualFAvx512, TransposeFAvx2};
+#endif
+
+// Таблица уровня level: [скалярная, sse2, avx2, avx512]
+template <typename T>
+const BasicSimdKernels<T>* pick(SimdLevel level,
+                                const BasicSimdKernels<T>* const* tables) {
+  return tables[level] ? tables[level] : tables[kSimdScalar];
+}
+
+template <typename T>
+const BasicSimdKernels<T>* kernels_for(SimdLevel level);
+
+template <>
+const SimdKernels* kernels_for<double>(SimdLevel level) {
+#ifdef S21_X86
+  static const SimdKernels* const tables[] = {
+      &kScalarKernels, &kSse2Kernels, &kAvx2Kernels, &kAvx512Kernels};
+#else
+  static const SimdKernels* const tables[] = {&kScalarKernels, nullptr,
+                                              nullptr, nullptr};
+#endif
+  return pick(level, tables);
+}
+
+template <>
+const BasicSimdKernels<float>* kernels_for<float>(SimdLevel level) {
+#ifdef S21_X86
+  static const BasicSimdKernels<float>* const tables[] = {
+      &kScalarKernelsF, &kSse2KernelsF, &kAvx2KernelsF, &kAvx512KernelsF};
+#else
+  static const BasicSimdKernels<float>* const tables[] = {
+      &kScalarKernelsF, nullptr, nullptr, nullptr};
+#endif
+  return pick(level, tables);
+}
+
+template <>
+const BasicSimdKernels<long double>* kernels_for<long double>(SimdLevel) {
+  return &kScalarKernelsLD;
+}
+
+template <typename T>
+std::atomic<const BasicSimdKernels<T>*>& active_kernels() {
+  static std::atomic<const BasicSimdKernels<T>*> active(
+      kernels_for<T>(DetectSimdLevel()));
+  return active;
+}
+
+}  // namespace
+
+SimdLevel DetectSimdLevel() {
+  static const SimdLevel level = [] {
+    SimdLevel detected = kSimdScalar;
+#ifdef S21_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+      detected = kSimdAvx512;
+    } else if (__builtin_cpu_supports("avx2") &&
+               __builtin_cpu_supports("fma")) {
+      detected = kSimdAvx2;
+    } else if (__builtin_cpu_supports("sse2")) {
+      detected = kSimdSse2;
+    }
+#endif
+    return detected;
+  }();
+  return level;
+}
+
+template <>
+const BasicSimdKernels<float>& Simd<float>() {
+  return *active_kernels<float>().load();
+}
+
+template <>
+const BasicSimdKernels<double>& Simd<double>() {
+  return *active_kernels<double>().load();
+}
+
+template <>
+const BasicSimdKernels<long double>& Simd<long double>() {
+  return *active_kernels<long double>().load();
+}
+
+SimdLevel SetSimdLevel(SimdLevel level) {
+  if (level > DetectSimdLevel()) level = DetectSimdLevel();
+  active_kernels<float>().store(kernels_for<float>(level));
+  active_kernels<double>().store(kernels_for<double>(level));
+  active_kernels<long double>().store(kernels_for<long double>(level));
+  return level;
+}
+
+}  // namespace s21
@@ -0,0 +1,60 @@
+#ifndef __S21SIMD_H__
+#define __S21SIMD_H__
+
+#include <cstddef>
+
+namespace s21 {
+
+// Уровни набора векторных инструкций, по возрастанию
+enum SimdLevel { kSimdScalar, kSimdSse2, kSimdAvx2, kSimdAvx512 };
+
+/**
+ * @brief Таблица поэлементных ядер для одного уровня SIMD и типа элемента T
+ * Все ядра работают с непрерывными массивами длины n и дают тот же результат,
+ * что и скалярный цикл
+ */
+template <typename T>
+struct BasicSimdKernels {
+  SimdLevel level;
+  const char* name;
+  void (*add)(T* dst, const T* src, size_t n);    // dst += src
+  void (*sub)(T* dst, const T* src, size_t n);    // dst -= src
+  void (*scale)(T* dst, T num, size_t n);         // dst *= num
+  void (*copy)(T* dst, const T* src, size_t n);   // dst = src
+  // dst += num * src (умножение и сложение раздельно, без FMA)
+  void (*axpy)(T* dst, T num, const T* src, size_t n);
+  // |a - b| <= eps для всех элементов, выход на первом отличающемся блоке
+  bool (*equal)(const T* a, const T* b, size_t n, T eps);
+  // dst (cols x rows) = src^T (rows x cols). Блок должен помещаться в L1:
+  // транспонирование идет тайлами в регистрах (для double 2x2/4x4/8x8, для
+  // float 4x4/8x8)
+  void (*transpose)(const T* src, ptrdiff_t lds, T* dst, ptrdiff_t ldd,
+                    int rows, int cols);
+};
+
+using SimdKernels = BasicSimdKernels<double>;
+
+// Наибольший уровень, поддерживаемый процессором и ОС (определяется по CPUID)
+SimdLevel DetectSimdLevel();
+
+// Активные ядра для типа T (float, double, long double). Выбираются один раз
+// при первом обращении. Для long double векторных ядер нет (x87), таблица
+// всегда скалярная
+template <typename T = double>
+const BasicSimdKernels<T>& Simd();
+
+template <>
+const BasicSimdKernels<float>& Simd<float>();
+template <>
+const BasicSimdKernels<double>& Simd<double>();
+template <>
+const BasicSimdKernels<long double>& Simd<long double>();
+
+// Принудительно понижает уровень для всех типов (для тестов и бенчмарков);
+// уровень выше поддерживаемого процессором ограничивается сверху. Возвращает
+// выбранный уровень. Нельзя вызывать параллельно с вычислениями
+SimdLevel SetSimdLevel(SimdLevel level);
+
+}  // namespace s21
+
+#endif
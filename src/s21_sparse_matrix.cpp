@@ -0,0 +1,588 @@
+#include "s21_sparse_matrix.h"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#include "s21_simd.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+// Начиная с этого объема работы (примерно число ненулевых x длина
+// обрабатываемой строки) операция делится между потоками пула
+constexpr double kSparseParallel = 1 << 16;
+// Частей на поток: запас для перехвата задач при неравных линиях
+constexpr int kPartsPerThread = 4;
+// Ширина полосы столбцов плотной матрицы в произведении CSC на плотную
+constexpr int kDenseBlock = 256;
+
+// Число частей для объема работы work (1 - выполнять в текущем потоке)
+int PartCount(double work, size_t limit) {
+  int threads = S21ThreadPool::ThreadCount();
+  if (threads < 2 || work < kSparseParallel || limit < 2) return 1;
+  return (int)std::min<size_t>(limit, (size_t)threads * kPartsPerThread);
+}
+
+/**
+ * @brief Границы parts частей главных линий с примерно равным весом;
+ * вес линии - число ее ненулевых плюс 1, чтобы пустые линии тоже делились
+ */
+std::vector<int> LineBounds(const std::vector<size_t>& ptr, int parts) {
+  const int lines = (int)ptr.size() - 1;
+  const double total = (double)ptr[lines] + lines;
+  std::vector<int> bounds(parts + 1, lines);
+  bounds[0] = 0;
+  for (int p = 1; p < parts; p++) {
+    const double target = total * p / parts;
+    // Первая линия l с ptr[l] + l >= target (ptr[l] + l возрастает)
+    int lo = bounds[p - 1], hi = lines;
+    while (lo < hi) {
+      int mid = lo + (hi - lo) / 2;
+      if ((double)ptr[mid] + mid < target) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    bounds[p] = lo;
+  }
+  return bounds;
+}
+
+/**
+ * @brief Вызывает fn(begin, end) для частей главных линий с равным числом
+ * ненулевых: в пуле, если работа велика, иначе fn(0, lines)
+ */
+template <typename Fn>
+void ForLines(const std::vector<size_t>& ptr, double work, const Fn& fn) {
+  const int lines = (int)ptr.size() - 1;
+  const int parts = PartCount(work, lines);
+  if (parts == 1) {
+    fn(0, lines);
+    return;
+  }
+  std::vector<int> bounds = LineBounds(ptr, parts);
+  S21ThreadPool::Instance().ParallelFor(parts, [&](int p) {
+    if (bounds[p] < bounds[p + 1]) fn(bounds[p], bounds[p + 1]);
+  });
+}
+
+/**
+ * @brief Вызывает fn(begin, end) для равных частей [0, n)
+ */
+template <typename Fn>
+void ForRange(size_t n, double work, const Fn& fn) {
+  const int parts = PartCount(work, n);
+  if (parts == 1) {
+    fn(0, n);
+    return;
+  }
+  S21ThreadPool::Instance().ParallelFor(parts, [&](int p) {
+    fn(n * p / parts, n * (p + 1) / parts);
+  });
+}
+
+// Префиксные суммы: counts[k] - число элементов линии k, на выходе ptr
+void CountsToPtr(std::vector<size_t>& counts) {
+  size_t pos = 0;
+  for (size_t& c : counts) {
+    size_t n = c;
+    c = pos;
+    pos += n;
+  }
+}
+
+/**
+ * @brief Пересжатие по другому измерению (параллельная сортировка
+ * подсчетом): из major линий длины minor получаются minor линий длины major.
+ * Для CSR это CSC той же матрицы или CSR транспонированной. Каждая часть
+ * исходных линий считает свою гистограмму, поэтому порядок внутри новых
+ * линий возрастающий без сортировки
+ */
+template <typename T>
+void Recompress(int major, int minor, const std::vector<size_t>& ptr,
+                const std::vector<int>& idx, const std::vector<T>& val,
+                std::vector<size_t>& out_ptr, std::vector<int>& out_idx,
+                std::vector<T>& out_val) {
+  const size_t nnz = ptr[major];
+  out_ptr.assign(minor + 1, 0);
+  out_idx.resize(nnz);
+  out_val.resize(nnz);
+  // Гистограммы частей занимают parts x minor: частей не больше, чем
+  // ненулевых на одну новую линию
+  int parts = PartCount((double)nnz, major);
+  parts = std::max(1, std::min<int>(parts, (int)(nnz / (minor + 1))));
+  std::vector<int> bounds = LineBounds(ptr, parts);
+  std::vector<size_t> offsets((size_t)parts * minor, 0);
+  auto run = [&](const auto& body) {
+    if (parts == 1) {
+      body(0);
+    } else {
+      S21ThreadPool::Instance().ParallelFor(parts, body);
+    }
+  };
+  run([&](int p) {
+    size_t* count = offsets.data() + (size_t)p * minor;
+    for (size_t e = ptr[bounds[p]]; e < ptr[bounds[p + 1]]; e++) {
+      count[idx[e]]++;
+    }
+  });
+  size_t pos = 0;
+  for (int m = 0; m < minor; m++) {
+    out_ptr[m] = pos;
+    for (int p = 0; p < parts; p++) {
+      size_t& o = offsets[(size_t)p * minor + m];
+      size_t n = o;
+      o = pos;
+      pos += n;
+    }
+  }
+  out_ptr[minor] = pos;
+  run([&](int p) {
+    size_t* next = offsets.data() + (size_t)p * minor;
+    for (int l = bounds[p]; l < bounds[p + 1]; l++) {
+      for (size_t e = ptr[l]; e < ptr[l + 1]; e++) {
+        size_t o = next[idx[e]]++;
+        out_idx[o] = l;
+        out_val[o] = val[e];
+      }
+    }
+  });
+}
+
+}  // namespace
+
+//-------------Конструкторы-------------------
+
+/**
+ * @brief Нулевая матрица rows x cols
+ */
+template <typename T>
+S21BasicSparseMatrix<T>::S21BasicSparseMatrix(int rows, int cols,
+                                              Format format)
+    : rows_(rows), cols_(cols), format_(format) {
+  if (rows <= 0 || cols <= 0) Matrix::not_exist();
+  ptr_.assign(major() + 1, 0);
+}
+
+/**
+ * @brief Построение из списка элементов: раскладка подсчетом по главным
+ * линиям, затем сортировка каждой линии и сложение повторов (в порядке
+ * списка)
+ */
+template <typename T>
+S21BasicSparseMatrix<T>::S21BasicSparseMatrix(
+    int rows, int cols, const std::vector<Triplet>& triplets, Format format)
+    : S21BasicSparseMatrix(rows, cols, format) {
+  const bool csr = format_ == kCsr;
+  std::vector<size_t> start(major() + 1, 0);
+  for (const Triplet& t : triplets) {
+    if (t.row < 0 || t.row >= rows_ || t.col < 0 || t.col >= cols_) {
+      Matrix::not_range();
+    }
+    start[csr ? t.row : t.col]++;
+  }
+  CountsToPtr(start);
+  std::vector<std::pair<int, T>> entries(triplets.size());
+  std::vector<size_t> next(start.begin(), start.end() - 1);
+  for (const Triplet& t : triplets) {
+    entries[next[csr ? t.row : t.col]++] = {csr ? t.col : t.row, t.value};
+  }
+  std::vector<size_t> counts(major(), 0);
+  ForLines(start, (double)entries.size() * 8, [&](int begin, int end) {
+    for (int l = begin; l < end; l++) {
+      auto first = entries.begin() + start[l];
+      auto last = entries.begin() + start[l + 1];
+      std::stable_sort(first, last, [](const auto& a, const auto& b) {
+        return a.first < b.first;
+      });
+      // Сложение повторов на месте: в начале линии остаются уникальные
+      auto out = first;
+      for (auto it = first; it != last; ++it) {
+        if (out != first && (out - 1)->first == it->first) {
+          (out - 1)->second += it->second;
+        } else {
+          *out++ = *it;
+        }
+      }
+      counts[l] = out - first;
+    }
+  });
+  counts.push_back(0);
+  CountsToPtr(counts);
+  ptr_ = std::move(counts);
+  indices_.resize(ptr_.back());
+  values_.resize(ptr_.back());
+  ForLines(ptr_, (double)ptr_.back(), [&](int begin, int end) {
+    for (int l = begin; l < end; l++) {
+      for (size_t k = 0; k < ptr_[l + 1] - ptr_[l]; k++) {
+        indices_[ptr_[l] + k] = entries[start[l] + k].first;
+        values_[ptr_[l] + k] = entries[start[l] + k].second;
+      }
+    }
+  });
+}
+
+/**
+ * @brief Сжатие плотной матрицы: подсчет ненулевых по строкам, префиксные
+ * суммы и заполнение (оба прохода параллельно по строкам). CSC получается
+ * пересжатием CSR
+ */
+template <typename T>
+S21BasicSparseMatrix<T>::S21BasicSparseMatrix(const Matrix& dense,
+                                              Format format, T drop)
+    : S21BasicSparseMatrix(dense.acc_rows(), dense.acc_cols(), kCsr) {
+  const T* a = dense.data();
+  const size_t cols = cols_;
+  auto keep = [drop](T x) { return (x < 0 ? -x : x) > drop; };
+  const double work = (double)rows_ * cols_;
+  ForRange(rows_, work, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      size_t n = 0;
+      for (size_t j = 0; j < cols; j++) n += keep(a[i * cols + j]);
+      ptr_[i] = n;
+    }
+  });
+  CountsToPtr(ptr_);
+  indices_.resize(ptr_.back());
+  values_.resize(ptr_.back());
+  ForRange(rows_, work, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      size_t e = ptr_[i];
+      for (size_t j = 0; j < cols; j++) {
+        if (keep(a[i * cols + j])) {
+          indices_[e] = (int)j;
+          values_[e++] = a[i * cols + j];
+        }
+      }
+    }
+  });
+  if (format == kCsc) *this = ToFormat(kCsc);
+}
+
+//-------------Доступ и преобразования-------------------
+
+template <typename T>
+T S21BasicSparseMatrix<T>::at(int row, int col) const {
+  if (row < 0 || row >= rows_ || col < 0 || col >= cols_) Matrix::not_range();
+  const int line = format_ == kCsr ? row : col;
+  const int index = format_ == kCsr ? col : row;
+  auto first = indices_.begin() + ptr_[line];
+  auto last = indices_.begin() + ptr_[line + 1];
+  auto it = std::lower_bound(first, last, index);
+  return it != last && *it == index ? values_[it - indices_.begin()] : T(0);
+}
+
+/**
+ * @brief Плотная копия: главные линии записываются параллельно (в CSC
+ * разные части пишут в разные столбцы)
+ */
+template <typename T>
+typename S21BasicSparseMatrix<T>::Matrix S21BasicSparseMatrix<T>::ToDense()
+    const {
+  Matrix res(rows_, cols_);
+  T* c = res.data();
+  const size_t row_step = format_ == kCsr ? cols_ : 1;
+  const size_t index_step = format_ == kCsr ? 1 : cols_;
+  ForLines(ptr_, (double)nnz(), [&](int begin, int end) {
+    for (int l = begin; l < end; l++) {
+      for (size_t e = ptr_[l]; e < ptr_[l + 1]; e++) {
+        c[l * row_step + indices_[e] * index_step] = values_[e];
+      }
+    }
+  });
+  return res;
+}
+
+template <typename T>
+S21BasicSparseMatrix<T> S21BasicSparseMatrix<T>::ToFormat(
+    Format format) const {
+  if (format == format_) return *this;
+  S21BasicSparseMatrix res(rows_, cols_, format);
+  Recompress(major(), minor(), ptr_, indices_, values_, res.ptr_,
+             res.indices_, res.values_);
+  return res;
+}
+
+//-------------Операции-------------------
+
+/**
+ * @brief Сравнение с точностью S21Tolerance<T>: нехранимые элементы равны 0
+ */
+template <typename T>
+bool S21BasicSparseMatrix<T>::EqMatrix(
+    const S21BasicSparseMatrix& other) const {
+  if (rows_ != other.rows_ || cols_ != other.cols_) return false;
+  if (other.format_ != format_) return EqMatrix(other.ToFormat(format_));
+  const S21BasicSparseMatrix& rhs = other;
+  const T eps = S21Tolerance<T>::value;
+  auto near = [eps](T x) { return (x < 0 ? -x : x) <= eps; };
+  std::atomic<bool> equal{true};
+  ForLines(ptr_, (double)(nnz() + rhs.nnz()), [&](int begin, int end) {
+    for (int l = begin; l < end && equal.load(std::memory_order_relaxed);
+         l++) {
+      size_t i = ptr_[l], j = rhs.ptr_[l];
+      while (i < ptr_[l + 1] || j < rhs.ptr_[l + 1]) {
+        int ci = i < ptr_[l + 1] ? indices_[i] : minor();
+        int cj = j < rhs.ptr_[l + 1] ? rhs.indices_[j] : minor();
+        T diff = ci == cj   ? values_[i++] - rhs.values_[j++]
+                 : ci < cj ? values_[i++]
+                           : rhs.values_[j++];
+        if (!near(diff)) {
+          equal.store(false, std::memory_order_relaxed);
+          return;
+        }
+      }
+    }
+  });
+  return equal.load();
+}
+
+/**
+ * @brief Поэлементное слияние a(i, j) = op(a(i, j), b(i, j)) по главным
+ * линиям в два прохода: подсчет элементов результата, затем заполнение.
+ * Точные нули результата не хранятся
+ */
+template <typename T>
+template <typename Op>
+void S21BasicSparseMatrix<T>::merge(const S21BasicSparseMatrix& other,
+                                    Op op) {
+  if (rows_ != other.rows_ || cols_ != other.cols_) Matrix::not_same_size();
+  if (other.format_ != format_) {
+    merge(other.ToFormat(format_), op);
+    return;
+  }
+  const std::vector<size_t>& bp = other.ptr_;
+  const std::vector<int>& bi = other.indices_;
+  const std::vector<T>& bv = other.values_;
+  const int end_index = minor();
+  // Обход линии l: emit(index, value) для каждого ненулевого результата
+  auto walk = [&](int l, const auto& emit) {
+    size_t i = ptr_[l], j = bp[l];
+    while (i < ptr_[l + 1] || j < bp[l + 1]) {
+      int ci = i < ptr_[l + 1] ? indices_[i] : end_index;
+      int cj = j < bp[l + 1] ? bi[j] : end_index;
+      const bool in_a = ci <= cj, in_b = cj <= ci;
+      T r = op(in_a ? values_[i++] : T(0), in_b ? bv[j++] : T(0));
+      if (r != T(0)) emit(in_a ? ci : cj, r);
+    }
+  };
+  std::vector<size_t> ptr(major() + 1, 0);
+  const double work = (double)(nnz() + other.nnz());
+  ForLines(ptr_, work, [&](int begin, int end) {
+    for (int l = begin; l < end; l++) {
+      size_t n = 0;
+      walk(l, [&n](int, T) { n++; });
+      ptr[l] = n;
+    }
+  });
+  CountsToPtr(ptr);
+  std::vector<int> indices(ptr.back());
+  std::vector<T> values(ptr.back());
+  ForLines(ptr_, work, [&](int begin, int end) {
+    for (int l = begin; l < end; l++) {
+      size_t e = ptr[l];
+      walk(l, [&](int index, T value) {
+        indices[e] = index;
+        values[e++] = value;
+      });
+    }
+  });
+  ptr_ = std::move(ptr);
+  indices_ = std::move(indices);
+  values_ = std::move(values);
+}
+
+template <typename T>
+void S21BasicSparseMatrix<T>::SumMatrix(const S21BasicSparseMatrix& other) {
+  merge(other, [](T x, T y) { return x + y; });
+}
+
+template <typename T>
+void S21BasicSparseMatrix<T>::SubMatrix(const S21BasicSparseMatrix& other) {
+  merge(other, [](T x, T y) { return x - y; });
+}
+
+template <typename T>
+void S21BasicSparseMatrix<T>::MulNumber(const T num) {
+  s21::Simd<T>().scale(values_.data(), num, values_.size());
+}
+
+/**
+ * @brief y = A * x. CSR: строки делятся между потоками, каждая строка -
+ * скалярное произведение. CSC: части столбцов накапливают свои копии y,
+ * которые затем складываются (копий не больше, чем ненулевых на строку y)
+ */
+template <typename T>
+void S21BasicSparseMatrix<T>::MulVector(const T* x, T* y) const {
+  if (format_ == kCsr) {
+    ForLines(ptr_, (double)nnz(), [&](int begin, int end) {
+      for (int i = begin; i < end; i++) {
+        T sum = 0;
+        for (size_t e = ptr_[i]; e < ptr_[i + 1]; e++) {
+          sum += values_[e] * x[indices_[e]];
+        }
+        y[i] = sum;
+      }
+    });
+    return;
+  }
+  int parts = PartCount((double)nnz(), cols_);
+  parts = std::max(1, std::min<int>(parts, (int)(nnz() / rows_)));
+  auto scatter = [&](int begin, int end, T* out) {
+    for (int j = begin; j < end; j++) {
+      for (size_t e = ptr_[j]; e < ptr_[j + 1]; e++) {
+        out[indices_[e]] += values_[e] * x[j];
+      }
+    }
+  };
+  std::fill(y, y + rows_, T(0));
+  if (parts == 1) {
+    scatter(0, cols_, y);
+    return;
+  }
+  std::vector<int> bounds = LineBounds(ptr_, parts);
+  std::vector<T> partial((size_t)(parts - 1) * rows_, T(0));
+  S21ThreadPool::Instance().ParallelFor(parts, [&](int p) {
+    T* out = p == 0 ? y : partial.data() + (size_t)(p - 1) * rows_;
+    scatter(bounds[p], bounds[p + 1], out);
+  });
+  ForRange(rows_, (double)parts * rows_, [&](size_t begin, size_t end) {
+    for (int p = 1; p < parts; p++) {
+      const T* src = partial.data() + (size_t)(p - 1) * rows_;
+      s21::Simd<T>().add(y + begin, src + begin, end - begin);
+    }
+  });
+}
+
+template <typename T>
+std::vector<T> S21BasicSparseMatrix<T>::MulVector(
+    const std::vector<T>& x) const {
+  if ((int)x.size() != cols_) Matrix::not_equal();
+  std::vector<T> y(rows_);
+  MulVector(x.data(), y.data());
+  return y;
+}
+
+/**
+ * @brief Произведение на плотную матрицу B (cols x n): C[i, :] += a(i, j) *
+ * B[j, :] ядром axpy. CSR делится по строкам C. CSC делится по полосам
+ * столбцов C шириной kDenseBlock; если полос меньше, чем потоков, матрица
+ * сначала пересжимается в CSR (O(nnz), меньше самого умножения)
+ */
+template <typename T>
+typename S21BasicSparseMatrix<T>::Matrix S21BasicSparseMatrix<T>::MulMatrix(
+    const Matrix& dense) const {
+  if (cols_ != dense.acc_rows()) Matrix::not_equal();
+  const int n = dense.acc_cols();
+  Matrix res(rows_, n);
+  if (n == 1) {
+    MulVector(dense.data(), res.data());
+    return res;
+  }
+  const double work = (double)nnz() * n;
+  const int blocks = (n + kDenseBlock - 1) / kDenseBlock;
+  if (format_ == kCsc && PartCount(work, 2) > 1 &&
+      blocks < S21ThreadPool::ThreadCount()) {
+    return ToFormat(kCsr).MulMatrix(dense);
+  }
+  const T* b = dense.data();
+  T* c = res.data();
+  const auto& simd = s21::Simd<T>();
+  if (format_ == kCsr) {
+    ForLines(ptr_, work, [&](int begin, int end) {
+      for (int i = begin; i < end; i++) {
+        for (size_t e = ptr_[i]; e < ptr_[i + 1]; e++) {
+          simd.axpy(c + (size_t)i * n, values_[e],
+                    b + (size_t)indices_[e] * n, n);
+        }
+      }
+    });
+  } else {
+    ForRange(blocks, work, [&](size_t begin, size_t end) {
+      const size_t c0 = begin * kDenseBlock;
+      const size_t width = std::min<size_t>(end * kDenseBlock, n) - c0;
+      for (int j = 0; j < cols_; j++) {
+        for (size_t e = ptr_[j]; e < ptr_[j + 1]; e++) {
+          simd.axpy(c + (size_t)indices_[e] * n + c0, values_[e],
+                    b + (size_t)j * n + c0, width);
+        }
+      }
+    });
+  }
+  return res;
+}
+
+/**
+ * @brief Транспонирование в том же формате: CSR матрицы A^T совпадает с CSC
+ * матрицы A, поэтому это то же пересжатие с переставленными размерами
+ */
+template <typename T>
+S21BasicSparseMatrix<T> S21BasicSparseMatrix<T>::Transpose() const {
+  S21BasicSparseMatrix res(cols_, rows_, format_);
+  Recompress(major(), minor(), ptr_, indices_, values_, res.ptr_,
+             res.indices_, res.values_);
+  return res;
+}
+
+//-------------Перегрузки операторов-------------------
+
+template <typename T>
+bool S21BasicSparseMatrix<T>::operator==(
+    const S21BasicSparseMatrix& other) const {
+  return EqMatrix(other);
+}
+
+template <typename T>
+S21BasicSparseMatrix<T> S21BasicSparseMatrix<T>::operator+(
+    const S21BasicSparseMatrix& other) const {
+  S21BasicSparseMatrix res(*this);
+  res.SumMatrix(other);
+  return res;
+}
+
+template <typename T>
+S21BasicSparseMatrix<T> S21BasicSparseMatrix<T>::operator-(
+    const S21BasicSparseMatrix& other) const {
+  S21BasicSparseMatrix res(*this);
+  res.SubMatrix(other);
+  return res;
+}
+
+template <typename T>
+typename S21BasicSparseMatrix<T>::Matrix S21BasicSparseMatrix<T>::operator*(
+    const Matrix& dense) const {
+  return MulMatrix(dense);
+}
+
+template <typename T>
+S21BasicSparseMatrix<T> S21BasicSparseMatrix<T>::operator*(T num) const {
+  S21BasicSparseMatrix res(*this);
+  res.MulNumber(num);
+  return res;
+}
+
+template <typename T>
+S21BasicSparseMatrix<T>& S21BasicSparseMatrix<T>::operator+=(
+    const S21BasicSparseMatrix& other) {
+  SumMatrix(other);
+  return *this;
+}
+
+template <typename T>
+S21BasicSparseMatrix<T>& S21BasicSparseMatrix<T>::operator-=(
+    const S21BasicSparseMatrix& other) {
+  SubMatrix(other);
+  return *this;
+}
+
+template <typename T>
+S21BasicSparseMatrix<T>& S21BasicSparseMatrix<T>::operator*=(T num) {
+  MulNumber(num);
+  return *this;
+}
+
+template class S21BasicSparseMatrix<float>;
+template class S21BasicSparseMatrix<double>;
+template class S21BasicSparseMatrix<long double>;
@@ -0,0 +1,104 @@
+#ifndef __S21SPARSEMATRIX_H__
+#define __S21SPARSEMATRIX_H__
+
+#include <cstddef>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+/**
+ * @brief Разреженная матрица rows x cols в сжатом формате по строкам (CSR)
+ * или по столбцам (CSC). Хранятся только ненулевые элементы: для k-й
+ * главной линии (строки в CSR, столбца в CSC) отрезок [ptr()[k],
+ * ptr()[k + 1]) массивов indices() и values() содержит номера столбцов (CSR)
+ * или строк (CSC) по возрастанию и значения. Память и время операций
+ * пропорциональны числу ненулевых nnz(), а не rows x cols; большие операции
+ * делятся между потоками пула на части с примерно равным числом ненулевых.
+ * Определена для T = float, double, long double
+ */
+template <typename T>
+class S21BasicSparseMatrix {
+ public:
+  using value_type = T;
+  using Matrix = S21BasicMatrix<T>;
+
+  enum Format { kCsr, kCsc };
+
+  // Элемент для построения из списка
+  struct Triplet {
+    int row, col;
+    T value;
+  };
+
+  // Нулевая матрица (nnz = 0)
+  S21BasicSparseMatrix(int rows, int cols, Format format = kCsr);
+  // Из списка элементов в любом порядке; повторы (row, col) складываются
+  S21BasicSparseMatrix(int rows, int cols, const std::vector<Triplet>& triplets,
+                       Format format = kCsr);
+  // Из плотной матрицы: элементы с |a(i, j)| <= drop не хранятся
+  explicit S21BasicSparseMatrix(const Matrix& dense, Format format = kCsr,
+                                T drop = 0);
+
+  // Accessors:
+  int rows() const { return rows_; }
+  int cols() const { return cols_; }
+  Format format() const { return format_; }
+  size_t nnz() const { return values_.size(); }
+  const std::vector<size_t>& ptr() const { return ptr_; }
+  const std::vector<int>& indices() const { return indices_; }
+  const std::vector<T>& values() const { return values_; }
+  // Элемент (row, col), 0 для нехранимых: двоичный поиск в главной линии
+  T at(int row, int col) const;
+
+  // Conversions:
+  Matrix ToDense() const;
+  // Та же матрица в формате format (копия, если формат уже совпадает)
+  S21BasicSparseMatrix ToFormat(Format format) const;
+
+  // Operations:
+  bool EqMatrix(const S21BasicSparseMatrix& other) const;
+  // Форматы слагаемых могут различаться: результат в формате *this
+  void SumMatrix(const S21BasicSparseMatrix& other);
+  void SubMatrix(const S21BasicSparseMatrix& other);
+  void MulNumber(const T num);
+  // Разреженная на плотную: (rows x cols) * (cols x n)
+  Matrix MulMatrix(const Matrix& dense) const;
+  // y = A * x: x длины cols, y длины rows (перезаписывается)
+  void MulVector(const T* x, T* y) const;
+  std::vector<T> MulVector(const std::vector<T>& x) const;
+  // Транспонированная матрица в том же формате
+  S21BasicSparseMatrix Transpose() const;
+
+  // Overloads:
+  bool operator==(const S21BasicSparseMatrix& other) const;
+  S21BasicSparseMatrix operator+(const S21BasicSparseMatrix& other) const;
+  S21BasicSparseMatrix operator-(const S21BasicSparseMatrix& other) const;
+  Matrix operator*(const Matrix& dense) const;
+  S21BasicSparseMatrix operator*(T num) const;
+  S21BasicSparseMatrix& operator+=(const S21BasicSparseMatrix& other);
+  S21BasicSparseMatrix& operator-=(const S21BasicSparseMatrix& other);
+  S21BasicSparseMatrix& operator*=(T num);
+
+ private:
+  // Число главных линий и длина линии
+  int major() const { return format_ == kCsr ? rows_ : cols_; }
+  int minor() const { return format_ == kCsr ? cols_ : rows_; }
+  template <typename Op>
+  void merge(const S21BasicSparseMatrix& other, Op op);
+
+  int rows_, cols_;
+  Format format_;
+  std::vector<size_t> ptr_;  // major() + 1 смещений
+  std::vector<int> indices_;
+  std::vector<T> values_;
+};
+
+using S21SparseMatrix = S21BasicSparseMatrix<double>;
+using S21SparseMatrixF = S21BasicSparseMatrix<float>;
+using S21SparseMatrixLD = S21BasicSparseMatrix<long double>;
+
+extern template class S21BasicSparseMatrix<float>;
+extern template class S21BasicSparseMatrix<double>;
+extern template class S21BasicSparseMatrix<long double>;
+
+#endif
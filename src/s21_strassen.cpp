@@ -0,0 +1,360 @@
+#include "s21_strassen.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <vector>
+
+#include "s21_gemm.h"
+#include "s21_simd.h"
+#include "s21_thread_pool.h"
+
+namespace s21 {
+
+namespace {
+
+// Сложения блоков от этого числа элементов раздаются потокам пула
+constexpr long long kParallelCombine = 1 << 16;
+// Параллельный уровень держит 11 временных четвертей вместо двух; он не
+// используется, если его рабочая память больше kParallelMemory размеров C
+constexpr int kParallelMemory = 4;
+
+int default_crossover() {
+  const char* env = std::getenv("S21_STRASSEN_CROSSOVER");
+  int crossover = env ? std::atoi(env) : 0;
+  return crossover > 0 ? crossover : 0;
+}
+
+std::atomic<int>& crossover_value() {
+  static std::atomic<int> value(default_crossover());
+  return value;
+}
+
+bool is_leaf(int m, int n, int k, int crossover) {
+  return std::min({m, n, k}) <= crossover;
+}
+
+/**
+ * @brief Рабочая память (в элементах) последовательных уровней: X и Y
+ * текущего уровня плюс память одного произведения следующего (произведения
+ * считаются по очереди и делят ее)
+ */
+size_t sequential_space(int m, int n, int k, int crossover) {
+  if (is_leaf(m, n, k, crossover)) return 0;
+  const int m2 = m / 2, n2 = n / 2, k2 = k / 2;
+  return (size_t)m2 * std::max(k2, n2) + (size_t)k2 * n2 +
+         sequential_space(m2, n2, k2, crossover);
+}
+
+/**
+ * @brief Рабочая память с levels параллельными уровнями сверху: S1..S4,
+ * T1..T4, P1, P2, P4 и по отдельной памяти на каждое из 7 произведений
+ */
+size_t parallel_space(int m, int n, int k, int crossover, int levels) {
+  if (levels == 0 || is_leaf(m, n, k, crossover)) {
+    return sequential_space(m, n, k, crossover);
+  }
+  const int m2 = m / 2, n2 = n / 2, k2 = k / 2;
+  return 4 * (size_t)m2 * k2 + 4 * (size_t)k2 * n2 + 3 * (size_t)m2 * n2 +
+         7 * parallel_space(m2, n2, k2, crossover, levels - 1);
+}
+
+/**
+ * @brief z = x + y или z = x - y на блоках rows x cols построчно ядрами
+ * Simd; z может совпадать с x или y. Большие блоки делятся по строкам между
+ * потоками пула
+ */
+template <bool kSub, typename T>
+void combine(int rows, int cols, const T* x, ptrdiff_t ldx, const T* y,
+             ptrdiff_t ldy, T* z, ptrdiff_t ldz) {
+  const BasicSimdKernels<T>& simd = Simd<T>();
+  auto body = [&](int r0, int r1) {
+    for (int i = r0; i < r1; i++) {
+      const T* xi = x + i * ldx;
+      const T* yi = y + i * ldy;
+      T* zi = z + i * ldz;
+      if (zi == yi && zi != xi) {
+        if (kSub) simd.scale(zi, T(-1), cols);  // x - z = -z + x
+        simd.add(zi, xi, cols);
+        continue;
+      }
+      if (zi != xi) simd.copy(zi, xi, cols);
+      if (kSub) {
+        simd.sub(zi, yi, cols);
+      } else {
+        simd.add(zi, yi, cols);
+      }
+    }
+  };
+  S21ThreadPool& pool = S21ThreadPool::Instance();
+  const int parts = std::min(rows, S21ThreadPool::ThreadCount());
+  if (parts > 1 && (long long)rows * cols >= kParallelCombine) {
+    pool.ParallelFor(parts, [&](int part) {
+      body((int)((long long)rows * part / parts),
+           (int)((long long)rows * (part + 1) / parts));
+    });
+  } else {
+    body(0, rows);
+  }
+}
+
+template <typename T>
+void add(int rows, int cols, const T* x, ptrdiff_t ldx, const T* y,
+         ptrdiff_t ldy, T* z, ptrdiff_t ldz) {
+  combine<false>(rows, cols, x, ldx, y, ldy, z, ldz);
+}
+
+template <typename T>
+void sub(int rows, int cols, const T* x, ptrdiff_t ldx, const T* y,
+         ptrdiff_t ldy, T* z, ptrdiff_t ldz) {
+  combine<true>(rows, cols, x, ldx, y, ldy, z, ldz);
+}
+
+template <typename T>
+void winograd(int m, int n, int k, const T* a, ptrdiff_t lda, const T* b,
+              ptrdiff_t ldb, T* c, ptrdiff_t ldc, int crossover, T* work,
+              int levels);
+
+/**
+ * @brief Четные части (2 * m2 x 2 * n2 x 2 * k2) по схеме Винограда с двумя
+ * временными матрицами X (m2 x max(k2, n2)) и Y (k2 x n2): 7 произведений
+ * по очереди пишутся в четверти C и X, затем собираются в ответ
+ */
+template <typename T>
+void sequential_step(int m2, int n2, int k2, const T* a, ptrdiff_t lda,
+                     const T* b, ptrdiff_t ldb, T* c, ptrdiff_t ldc,
+                     int crossover, T* work) {
+  const T *a11 = a, *a12 = a + k2, *a21 = a + m2 * lda, *a22 = a21 + k2;
+  const T *b11 = b, *b12 = b + n2, *b21 = b + k2 * ldb, *b22 = b21 + n2;
+  T *c11 = c, *c12 = c + n2, *c21 = c + m2 * ldc, *c22 = c21 + n2;
+  const ptrdiff_t ldx = std::max(k2, n2), ldy = n2;
+  T* x = work;
+  T* y = x + (size_t)m2 * ldx;
+  T* next = y + (size_t)k2 * ldy;
+  auto mul = [&](const T* p, ptrdiff_t ldp, const T* q, ptrdiff_t ldq, T* r,
+                 ptrdiff_t ldr) {
+    winograd(m2, n2, k2, p, ldp, q, ldq, r, ldr, crossover, next, 0);
+  };
+
+  sub(m2, k2, a11, lda, a21, lda, x, ldx);  // S3 = A11 - A21
+  sub(k2, n2, b22, ldb, b12, ldb, y, ldy);  // T3 = B22 - B12
+  mul(x, ldx, y, ldy, c21, ldc);            // P7 = S3 * T3
+  add(m2, k2, a21, lda, a22, lda, x, ldx);  // S1 = A21 + A22
+  sub(k2, n2, b12, ldb, b11, ldb, y, ldy);  // T1 = B12 - B11
+  mul(x, ldx, y, ldy, c22, ldc);            // P5 = S1 * T1
+  sub(m2, k2, x, ldx, a11, lda, x, ldx);    // S2 = S1 - A11
+  sub(k2, n2, b22, ldb, y, ldy, y, ldy);    // T2 = B22 - T1
+  mul(x, ldx, y, ldy, c12, ldc);            // P6 = S2 * T2
+  sub(m2, k2, a12, lda, x, ldx, x, ldx);    // S4 = A12 - S2
+  mul(x, ldx, b22, ldb, c11, ldc);          // P3 = S4 * B22
+  mul(a11, lda, b11, ldb, x, ldx);          // P1 = A11 * B11
+  add(m2, n2, x, ldx, c12, ldc, c12, ldc);  // U2 = P1 + P6
+  add(m2, n2, c12, ldc, c21, ldc, c21, ldc);  // U3 = U2 + P7
+  add(m2, n2, c12, ldc, c22, ldc, c12, ldc);  // U4 = U2 + P5
+  add(m2, n2, c21, ldc, c22, ldc, c22, ldc);  // C22 = U3 + P5
+  add(m2, n2, c12, ldc, c11, ldc, c12, ldc);  // C12 = U4 + P3
+  sub(k2, n2, y, ldy, b21, ldb, y, ldy);      // T4 = T2 - B21
+  mul(a22, lda, y, ldy, c11, ldc);            // P4 = A22 * T4
+  sub(m2, n2, c21, ldc, c11, ldc, c21, ldc);  // C21 = U3 - P4
+  mul(a12, lda, b21, ldb, c11, ldc);          // P2 = A12 * B21
+  add(m2, n2, x, ldx, c11, ldc, c11, ldc);    // C11 = P1 + P2
+}
+
+/**
+ * @brief Тот же уровень, но все 8 сумм считаются заранее, а 7 произведений
+ * независимы и раздаются потокам пула, каждое со своей частью work
+ */
+template <typename T>
+void parallel_step(int m2, int n2, int k2, const T* a, ptrdiff_t lda,
+                   const T* b, ptrdiff_t ldb, T* c, ptrdiff_t ldc,
+                   int crossover, T* work, int levels) {
+  const T *a11 = a, *a12 = a + k2, *a21 = a + m2 * lda, *a22 = a21 + k2;
+  const T *b11 = b, *b12 = b + n2, *b21 = b + k2 * ldb, *b22 = b21 + n2;
+  T *c11 = c, *c12 = c + n2, *c21 = c + m2 * ldc, *c22 = c21 + n2;
+  const size_t sa = (size_t)m2 * k2, sb = (size_t)k2 * n2,
+               sc = (size_t)m2 * n2;
+  T *s1 = work, *s2 = s1 + sa, *s3 = s2 + sa, *s4 = s3 + sa;
+  T *t1 = s4 + sa, *t2 = t1 + sb, *t3 = t2 + sb, *t4 = t3 + sb;
+  T *p1 = t4 + sb, *p2 = p1 + sc, *p4 = p2 + sc;
+  T* next = p4 + sc;
+  const size_t next_size =
+      parallel_space(m2, n2, k2, crossover, levels - 1);
+
+  add(m2, k2, a21, lda, a22, lda, s1, k2);
+  sub(m2, k2, s1, k2, a11, lda, s2, k2);
+  sub(m2, k2, a11, lda, a21, lda, s3, k2);
+  sub(m2, k2, a12, lda, s2, k2, s4, k2);
+  sub(k2, n2, b12, ldb, b11, ldb, t1, n2);
+  sub(k2, n2, b22, ldb, t1, n2, t2, n2);
+  sub(k2, n2, b22, ldb, b12, ldb, t3, n2);
+  sub(k2, n2, t2, n2, b21, ldb, t4, n2);
+
+  struct Product {
+    const T* p;
+    ptrdiff_t ldp;
+    const T* q;
+    ptrdiff_t ldq;
+    T* r;
+    ptrdiff_t ldr;
+  };
+  const Product products[7] = {
+      {a11, lda, b11, ldb, p1, n2},   // P1
+      {a12, lda, b21, ldb, p2, n2},   // P2
+      {s4, k2, b22, ldb, c11, ldc},   // P3
+      {a22, lda, t4, n2, p4, n2},     // P4
+      {s1, k2, t1, n2, c22, ldc},     // P5
+      {s2, k2, t2, n2, c12, ldc},     // P6
+      {s3, k2, t3, n2, c21, ldc},     // P7
+  };
+  S21ThreadPool::Instance().ParallelFor(7, [&](int i) {
+    const Product& pr = products[i];
+    winograd(m2, n2, k2, pr.p, pr.ldp, pr.q, pr.ldq, pr.r, pr.ldr, crossover,
+             next + i * next_size, levels - 1);
+  });
+
+  add(m2, n2, p1, n2, c12, ldc, c12, ldc);    // U2 = P1 + P6
+  add(m2, n2, c12, ldc, c21, ldc, c21, ldc);  // U3 = U2 + P7
+  add(m2, n2, c12, ldc, c22, ldc, c12, ldc);  // U4 = U2 + P5
+  add(m2, n2, c21, ldc, c22, ldc, c22, ldc);  // C22 = U3 + P5
+  add(m2, n2, c12, ldc, c11, ldc, c12, ldc);  // C12 = U4 + P3
+  sub(m2, n2, c21, ldc, p4, n2, c21, ldc);    // C21 = U3 - P4
+  add(m2, n2, p1, n2, p2, n2, c11, ldc);      // C11 = P1 + P2
+}
+
+/**
+ * @brief Досчитать C = A * B (m x n x k), когда C[0:mc, 0:nc] уже содержит
+ * A[0:mc, 0:kc] * B[0:kc, 0:nc]: слагаемые по оставшимся k, оставшиеся
+ * столбцы C целиком и оставшиеся строки без них - через Gemm
+ */
+template <typename T>
+void peel(int m, int n, int k, int mc, int nc, int kc, const T* a,
+          ptrdiff_t lda, const T* b, ptrdiff_t ldb, T* c, ptrdiff_t ldc) {
+  if (k > kc) {
+    Gemm(mc, nc, k - kc, T(1), a + kc, lda, 1, b + kc * ldb, ldb, 1, T(1), c,
+         ldc);
+  }
+  if (n > nc) Gemm(m, n - nc, k, a, lda, b + nc, ldb, c + nc, ldc);
+  if (m > mc) {
+    Gemm(m - mc, nc, k, a + mc * lda, lda, b, ldb, c + mc * ldc, ldc);
+  }
+}
+
+/**
+ * @brief Один уровень рекурсии: четные части по Винограду, нечетные
+ * остатки - через peel
+ */
+template <typename T>
+void winograd(int m, int n, int k, const T* a, ptrdiff_t lda, const T* b,
+              ptrdiff_t ldb, T* c, ptrdiff_t ldc, int crossover, T* work,
+              int levels) {
+  if (is_leaf(m, n, k, crossover)) {
+    Gemm(m, n, k, a, lda, b, ldb, c, ldc);
+    return;
+  }
+  const int m2 = m / 2, n2 = n / 2, k2 = k / 2;
+  if (levels > 0) {
+    parallel_step(m2, n2, k2, a, lda, b, ldb, c, ldc, crossover, work,
+                  levels);
+  } else {
+    sequential_step(m2, n2, k2, a, lda, b, ldb, c, ldc, crossover, work);
+  }
+  peel(m, n, k, 2 * m2, 2 * n2, 2 * k2, a, lda, b, ldb, c, ldc);
+}
+
+/**
+ * @brief Число параллельных уровней: пока 7^levels меньше числа потоков и
+ * рабочая память укладывается в kParallelMemory размеров C
+ */
+int parallel_levels(int m, int n, int k, int crossover) {
+  const int threads = S21ThreadPool::ThreadCount();
+  const size_t limit = (size_t)kParallelMemory * m * n;
+  size_t space = parallel_space(m, n, k, crossover, 0);
+  int levels = 0;
+  for (long long tasks = 1; tasks < threads; tasks *= 7) {
+    const size_t deeper = parallel_space(m, n, k, crossover, levels + 1);
+    // Следующий уровень не влезает в память или уже считается через Gemm
+    if (deeper > limit || deeper == space) break;
+    space = deeper;
+    levels++;
+  }
+  return levels;
+}
+
+/**
+ * @brief Рабочая память одного вызова: поточный буфер, если он свободен,
+ * иначе собственный. Поточный буфер растет до наибольшего запрошенного
+ * размера и живет до завершения потока. Поток, ожидающий свои задачи в
+ * пуле, может выполнить чужой StrassenGemm, пока его буфер занят
+ */
+template <typename T>
+class Workspace {
+ public:
+  Workspace() : owns_shared_(!busy()) { busy() = true; }
+  ~Workspace() {
+    if (owns_shared_) busy() = false;
+  }
+  Workspace(const Workspace&) = delete;
+  Workspace& operator=(const Workspace&) = delete;
+
+  T* reserve(size_t count) {
+    std::vector<T>& buffer = owns_shared_ ? shared() : local_;
+    if (buffer.size() < count) {
+      buffer.clear();
+      buffer.shrink_to_fit();
+      buffer.resize(count);
+    }
+    return buffer.data();
+  }
+
+ private:
+  static std::vector<T>& shared() {
+    static thread_local std::vector<T> buffer;
+    return buffer;
+  }
+  static bool& busy() {
+    static thread_local bool flag = false;
+    return flag;
+  }
+
+  bool owns_shared_;
+  std::vector<T> local_;
+};
+
+}  // namespace
+
+void SetStrassenCrossover(int crossover) {
+  crossover_value() = crossover > 0 ? crossover : 0;
+}
+
+int StrassenCrossover() { return crossover_value(); }
+
+template <typename T>
+void StrassenGemm(int m, int n, int k, const T* a, ptrdiff_t lda, const T* b,
+                  ptrdiff_t ldb, T* c, ptrdiff_t ldc) {
+  const int crossover = StrassenCrossover();
+  if (crossover == 0 || is_leaf(m, n, k, crossover)) {
+    Gemm(m, n, k, a, lda, b, ldb, c, ldc);
+    return;
+  }
+  // Размеры рекурсии округляются вниз до кратных 2^depth, чтобы остатки
+  // отщеплялись один раз здесь, а не узкими Gemm на каждом уровне
+  int depth = 0;
+  while (!is_leaf(m >> depth, n >> depth, k >> depth, crossover)) depth++;
+  const int mask = (1 << depth) - 1;
+  const int mc = m & ~mask, nc = n & ~mask, kc = k & ~mask;
+  const int levels = parallel_levels(mc, nc, kc, crossover);
+  Workspace<T> workspace;
+  T* work = workspace.reserve(parallel_space(mc, nc, kc, crossover, levels));
+  winograd(mc, nc, kc, a, lda, b, ldb, c, ldc, crossover, work, levels);
+  peel(m, n, k, mc, nc, kc, a, lda, b, ldb, c, ldc);
+}
+
+template void StrassenGemm(int, int, int, const float*, ptrdiff_t,
+                           const float*, ptrdiff_t, float*, ptrdiff_t);
+template void StrassenGemm(int, int, int, const double*, ptrdiff_t,
+                           const double*, ptrdiff_t, double*, ptrdiff_t);
+template void StrassenGemm(int, int, int, const long double*, ptrdiff_t,
+                           const long double*, ptrdiff_t, long double*,
+                           ptrdiff_t);
+
+}  // namespace s21
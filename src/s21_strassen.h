@@ -0,0 +1,37 @@
+#ifndef __S21STRASSEN_H__
+#define __S21STRASSEN_H__
+
+#include <cstddef>
+
+namespace s21 {
+
+/**
+ * @brief Умножение row-major матриц C = A * B по Штрассену–Винограду
+ * Пока все три размера больше порога (StrassenCrossover), произведение
+ * делится на четверти и считается 7 умножениями и 15 сложениями вместо 8
+ * умножений; меньшие произведения считает Gemm. Неквадратные и нечетные
+ * размеры не дополняются нулями: в рекурсию идет часть, округленная вниз до
+ * кратных 2^глубина, а оставшиеся строки, столбцы и слагаемые по k один раз
+ * досчитываются через Gemm. Верхние уровни рекурсии (по 7 независимых
+ * произведений) выполняются параллельно в пуле потоков, нижние - по схеме
+ * с двумя временными матрицами на уровень. Вся рабочая память выделяется
+ * одним буфером на поток и переиспользуется между уровнями и вызовами.
+ * Погрешность больше, чем у классического умножения (растет с числом
+ * уровней), поэтому путь выключен по умолчанию. При выключенном пути или
+ * малых размерах - то же, что Gemm. Определено для T = float, double,
+ * long double
+ */
+template <typename T>
+void StrassenGemm(int m, int n, int k, const T* a, ptrdiff_t lda, const T* b,
+                  ptrdiff_t ldb, T* c, ptrdiff_t ldc);
+
+// Порог перехода на Gemm: рекурсия идет, пока min(m, n, k) > crossover.
+// 0 - путь выключен (значение по умолчанию, если не задана переменная
+// окружения S21_STRASSEN_CROSSOVER). MulMatrix и operator* матриц идут через
+// StrassenGemm
+void SetStrassenCrossover(int crossover);
+int StrassenCrossover();
+
+}  // namespace s21
+
+#endif
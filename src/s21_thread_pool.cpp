@@ -0,0 +1,165 @@
+#include "s21_thread_pool.h"
+
+#include <cstdlib>
+#include <exception>
+
+namespace {
+
+/**
+ * @brief Число потоков по умолчанию: S21_NUM_THREADS или число ядер
+ */
+int default_thread_count() {
+  int count = 0;
+  const char* env = std::getenv("S21_NUM_THREADS");
+  if (env) count = std::atoi(env);
+  if (count <= 0) count = (int)std::thread::hardware_concurrency();
+  return count > 0 ? count : 1;
+}
+
+}  // namespace
+
+//-------------Управление пулом-------------------
+
+S21ThreadPool::S21ThreadPool()
+    : thread_count_(1), pending_(0), next_queue_(0), stop_(false) {
+  start(default_thread_count());
+}
+
+S21ThreadPool::~S21ThreadPool() { stop(); }
+
+/**
+ * @brief Глобальный пул библиотеки (создается при первом обращении)
+ */
+S21ThreadPool& S21ThreadPool::Instance() {
+  static S21ThreadPool pool;
+  return pool;
+}
+
+/**
+ * @brief Пересоздает пул с заданным числом потоков
+ * @param count Число потоков, 0 - значение по умолчанию
+ */
+void S21ThreadPool::SetThreadCount(int count) {
+  S21ThreadPool& pool = Instance();
+  pool.stop();
+  pool.start(count > 0 ? count : default_thread_count());
+}
+
+/**
+ * @brief Текущее число потоков пула (с учетом вызывающего)
+ */
+int S21ThreadPool::ThreadCount() { return Instance().thread_count_; }
+
+/**
+ * @brief Запускает count - 1 рабочих потоков, каждый со своей очередью
+ */
+void S21ThreadPool::start(int count) {
+  thread_count_ = count;
+  stop_ = false;
+  for (int i = 0; i < count - 1; i++) queues_.emplace_back(new Queue);
+  for (int i = 0; i < count - 1; i++) {
+    workers_.emplace_back(&S21ThreadPool::worker_loop, this, i);
+  }
+}
+
+/**
+ * @brief Дожидается опустошения очередей и останавливает рабочие потоки
+ */
+void S21ThreadPool::stop() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stop_ = true;
+  }
+  sleep_cv_.notify_all();
+  for (auto& worker : workers_) worker.join();
+  workers_.clear();
+  queues_.clear();
+}
+
+//-------------Выполнение задач-------------------
+
+/**
+ * @brief Берет задачу: сначала с конца своей очереди, затем крадет с начала
+ * чужих
+ * @param index Номер очереди потока, -1 для внешнего потока
+ * @return true - задача найдена
+ */
+bool S21ThreadPool::pop_task(int index, std::function<void()>& task) {
+  int count = (int)queues_.size();
+  if (index >= 0) {
+    Queue& own = *queues_[index];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      pending_--;
+      return true;
+    }
+  }
+  for (int i = 1; i <= count; i++) {
+    Queue& victim = *queues_[(index + i + count) % count];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      pending_--;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Выполняет одну задачу, если она есть
+ */
+bool S21ThreadPool::run_one(int index) {
+  std::function<void()> task;
+  bool found = pop_task(index, task);
+  if (found) task();
+  return found;
+}
+
+void S21ThreadPool::worker_loop(int index) {
+  while (true) {
+    if (run_one(index)) continue;
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    sleep_cv_.wait(lock, [this] { return stop_ || pending_ > 0; });
+    if (stop_ && pending_ == 0) return;
+  }
+}
+
+void S21ThreadPool::ParallelFor(int count,
+                                const std::function<void(int)>& body) {
+  if (count <= 0) return;
+  if (queues_.empty() || count == 1) {
+    for (int i = 0; i < count; i++) body(i);
+    return;
+  }
+  std::atomic<int> remaining(count);
+  std::mutex error_mutex;
+  std::exception_ptr error;
+  unsigned first = next_queue_.fetch_add(1);
+  for (int i = 0; i < count; i++) {
+    Queue& queue = *queues_[(first + i) % queues_.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.emplace_back([&, i] {
+      try {
+        body(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> guard(error_mutex);
+        if (!error) error = std::current_exception();
+      }
+      remaining--;
+    });
+    pending_++;
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+  }
+  sleep_cv_.notify_all();
+  // Вызывающий поток помогает, пока его задачи не закончатся
+  while (remaining > 0) {
+    if (!run_one(-1)) std::this_thread::yield();
+  }
+  if (error) std::rethrow_exception(error);
+}
@@ -0,0 +1,61 @@
+#ifndef __S21THREADPOOL_H__
+#define __S21THREADPOOL_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Пул потоков библиотеки с перехватом задач (work stealing)
+ * У каждого рабочего потока своя очередь: он берет задачи с ее конца, а
+ * опустевший поток крадет их с начала чужих очередей. Размер пула берется из
+ * переменной окружения S21_NUM_THREADS, иначе из hardware_concurrency(), и
+ * может быть изменен через SetThreadCount(). Вызывающий поток тоже выполняет
+ * задачи, поэтому пул из N потоков держит N - 1 рабочих потоков
+ */
+class S21ThreadPool {
+ public:
+  static S21ThreadPool& Instance();
+
+  // Задать число потоков (0 - вернуть значение по умолчанию). Нельзя вызывать,
+  // пока в пуле выполняются задачи
+  static void SetThreadCount(int count);
+  static int ThreadCount();
+
+  // Выполняет body(i) для всех i из [0, count) и дожидается завершения.
+  // Первое выброшенное задачей исключение пробрасывается вызывающему
+  void ParallelFor(int count, const std::function<void(int)>& body);
+
+  ~S21ThreadPool();
+  S21ThreadPool(const S21ThreadPool&) = delete;
+  S21ThreadPool& operator=(const S21ThreadPool&) = delete;
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  S21ThreadPool();
+  void start(int count);
+  void stop();
+  void worker_loop(int index);
+  bool run_one(int index);
+  bool pop_task(int index, std::function<void()>& task);
+
+  int thread_count_;
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> workers_;
+  std::atomic<int> pending_;
+  std::atomic<unsigned> next_queue_;
+  bool stop_;
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cv_;
+};
+
+#endif
@@ -0,0 +1,113 @@
+#include "s21_transpose.h"
+
+#include <algorithm>
+
+#include "s21_simd.h"
+#include "s21_thread_pool.h"
+
+namespace s21 {
+
+namespace {
+
+// Наибольший блок, который транспонируется целиком: 32 x 32 double = 8 КБ,
+// источник и приемник вместе помещаются в L1 (для long double - 16 КБ)
+constexpr int kTransposeBlock = 32;
+// Начиная с этого числа элементов транспонирование делится между потоками
+constexpr long kTransposeParallel = 1L << 20;
+
+template <typename T>
+void TransposeRecursive(const BasicSimdKernels<T>& simd, int rows, int cols,
+                        const T* src, ptrdiff_t lds, T* dst, ptrdiff_t ldd) {
+  if (rows <= kTransposeBlock && cols <= kTransposeBlock) {
+    simd.transpose(src, lds, dst, ldd, rows, cols);
+  } else if (rows >= cols) {
+    // Граница кратна 8, чтобы блоки делились на целые тайлы
+    int half = std::max(rows / 2 / 8 * 8, 8);
+    TransposeRecursive(simd, half, cols, src, lds, dst, ldd);
+    TransposeRecursive(simd, rows - half, cols, src + half * lds, lds,
+                       dst + half, ldd);
+  } else {
+    int half = std::max(cols / 2 / 8 * 8, 8);
+    TransposeRecursive(simd, rows, half, src, lds, dst, ldd);
+    TransposeRecursive(simd, rows, cols - half, src + half, lds,
+                       dst + half * ldd, ldd);
+  }
+}
+
+/**
+ * @brief Меняет местами p (rows x cols) и q (cols x rows) с транспонированием:
+ * p = q^T, q = p^T. Блок p сохраняется во временный буфер на стеке
+ */
+template <typename T>
+void SwapTransposed(const BasicSimdKernels<T>& simd, int rows, int cols, T* p,
+                    T* q, ptrdiff_t lda) {
+  if (rows <= kTransposeBlock && cols <= kTransposeBlock) {
+    T tmp[kTransposeBlock * kTransposeBlock];
+    for (int i = 0; i < rows; i++) {
+      std::copy(p + i * lda, p + i * lda + cols, tmp + i * kTransposeBlock);
+    }
+    simd.transpose(q, lda, p, lda, cols, rows);
+    simd.transpose(tmp, kTransposeBlock, q, lda, rows, cols);
+  } else if (rows >= cols) {
+    int half = std::max(rows / 2 / 8 * 8, 8);
+    SwapTransposed(simd, half, cols, p, q, lda);
+    SwapTransposed(simd, rows - half, cols, p + half * lda, q + half, lda);
+  } else {
+    int half = std::max(cols / 2 / 8 * 8, 8);
+    SwapTransposed(simd, rows, half, p, q, lda);
+    SwapTransposed(simd, rows, cols - half, p + half, q + half * lda, lda);
+  }
+}
+
+template <typename T>
+void TransposeInPlaceRecursive(const BasicSimdKernels<T>& simd, int n, T* a,
+                               ptrdiff_t lda) {
+  if (n <= kTransposeBlock) {
+    for (int i = 0; i < n; i++) {
+      for (int j = i + 1; j < n; j++) std::swap(a[i * lda + j], a[j * lda + i]);
+    }
+    return;
+  }
+  int half = n / 2 / 8 * 8;
+  TransposeInPlaceRecursive(simd, half, a, lda);
+  TransposeInPlaceRecursive(simd, n - half, a + half * lda + half, lda);
+  SwapTransposed(simd, half, n - half, a + half, a + half * lda, lda);
+}
+
+}  // namespace
+
+template <typename T>
+void Transpose(int rows, int cols, const T* src, ptrdiff_t lds, T* dst,
+               ptrdiff_t ldd) {
+  const BasicSimdKernels<T>& simd = Simd<T>();
+  int threads = S21ThreadPool::ThreadCount();
+  if (threads < 2 || (long)rows * cols < kTransposeParallel) {
+    TransposeRecursive(simd, rows, cols, src, lds, dst, ldd);
+    return;
+  }
+  // Полосы по строкам источника: каждая пишет свою полосу столбцов приемника
+  int band = (rows + threads - 1) / threads;
+  band = (band + kTransposeBlock - 1) / kTransposeBlock * kTransposeBlock;
+  int bands = (rows + band - 1) / band;
+  S21ThreadPool::Instance().ParallelFor(bands, [&](int b) {
+    int first = b * band, count = std::min(band, rows - first);
+    TransposeRecursive(simd, count, cols, src + first * lds, lds, dst + first,
+                       ldd);
+  });
+}
+
+template <typename T>
+void TransposeInPlace(int n, T* a, ptrdiff_t lda) {
+  TransposeInPlaceRecursive(Simd<T>(), n, a, lda);
+}
+
+template void Transpose(int, int, const float*, ptrdiff_t, float*, ptrdiff_t);
+template void Transpose(int, int, const double*, ptrdiff_t, double*,
+                        ptrdiff_t);
+template void Transpose(int, int, const long double*, ptrdiff_t,
+                        long double*, ptrdiff_t);
+template void TransposeInPlace(int, float*, ptrdiff_t);
+template void TransposeInPlace(int, double*, ptrdiff_t);
+template void TransposeInPlace(int, long double*, ptrdiff_t);
+
+}  // namespace s21
@@ -0,0 +1,29 @@
+#ifndef __S21TRANSPOSE_H__
+#define __S21TRANSPOSE_H__
+
+#include <cstddef>
+
+namespace s21 {
+
+/**
+ * @brief Транспонирование dst (cols x rows) = src^T (rows x cols)
+ * Кэш-независимый обход: большая сторона делится пополам, пока блок не
+ * поместится в L1, после чего блок транспонируется SIMD-тайлами в регистрах.
+ * Большие матрицы делятся на полосы между потоками пула. Области src и dst не
+ * должны пересекаться. Определено для T = float, double, long double
+ */
+template <typename T>
+void Transpose(int rows, int cols, const T* src, ptrdiff_t lds, T* dst,
+               ptrdiff_t ldd);
+
+/**
+ * @brief Транспонирование квадратной матрицы n x n на месте, без выделения
+ * памяти в куче. Диагональные блоки транспонируются рекурсивно, а
+ * симметричные им внедиагональные блоки меняются местами с транспонированием
+ */
+template <typename T>
+void TransposeInPlace(int n, T* a, ptrdiff_t lda);
+
+}  // namespace s21
+
+#endif
@@ -1,5 +1,19 @@
+#include <unistd.h>
+
+#include <fstream>
+#include <limits>
+#include <sstream>
+
 #include "gtest/gtest.h"
+#include "s21_allocator.h"
+#include "s21_fixed_matrix.h"
+#include "s21_matrix_batch.h"
+#include "s21_matrix_io.h"
 #include "s21_matrix_oop.h"
+#include "s21_simd.h"
+#include "s21_sparse_matrix.h"
+#include "s21_strassen.h"
+#include "s21_thread_pool.h"
 
 //-------------Constructors-------------------
 
@@ -62,6 +76,19 @@ TEST(Mutator_tests, mutator_plus) {
   ASSERT_TRUE(a == b);
 }
 
+TEST(Mutator_tests, mutator_change_cols) {
+  S21Matrix a(2, 3);
+  a.sequent_filling(1, 1);
+  a.mutator(3, 2);
+  S21Matrix b(3, 2);
+  b(0, 0) = 1;
+  b(0, 1) = 2;
+
+  b(1, 0) = 4;
+  b(1, 1) = 5;
+  ASSERT_TRUE(a == b);
+}
+
 TEST(Mutator_tests, mutator_not_exist) {
   S21Matrix a;
   EXPECT_THROW(a.mutator(-5, 2), std::invalid_argument);
@@ -178,6 +205,123 @@ TEST(Operations_tests, MulMatrix_equal) {
   ASSERT_TRUE(a == c);
 }
 
+TEST(Operations_tests, MulMatrix_large_blocked) {
+  S21Matrix a(130, 300);
+  S21Matrix b(300, 70);
+  a.sequent_filling(-1, 0.0001);
+  b.sequent_filling(2, -0.0003);
+  S21Matrix check(130, 70);
+  for (int m = 0; m < 130; m++) {
+    for (int n = 0; n < 70; n++) {
+      for (int k = 0; k < 300; k++) check(m, n) += a(m, k) * b(k, n);
+    }
+  }
+  a.MulMatrix(b);
+  ASSERT_TRUE(a == check);
+}
+
+TEST(Operations_tests, MulMatrix_same_bits_any_threads) {
+  S21Matrix a(300, 260);
+  S21Matrix b(260, 310);
+  a.sequent_filling(0.5, 0.00013);
+  b.sequent_filling(-3, 0.00007);
+  S21ThreadPool::SetThreadCount(1);
+  S21Matrix serial = a * b;
+  S21ThreadPool::SetThreadCount(5);
+  S21Matrix parallel = a * b;
+  S21ThreadPool::SetThreadCount(0);
+  bool same = true;
+  for (int m = 0; m < 300; m++) {
+    for (int n = 0; n < 310; n++) same = same && serial(m, n) == parallel(m, n);
+  }
+  ASSERT_TRUE(same);
+}
+
+// Произведение по определению, для сравнения с Gemv / Gevm
+template <typename T>
+S21BasicMatrix<T> NaiveProduct(S21BasicMatrix<T>& a, S21BasicMatrix<T>& b) {
+  S21BasicMatrix<T> c(a.acc_rows(), b.acc_cols());
+  for (int m = 0; m < a.acc_rows(); m++) {
+    for (int n = 0; n < b.acc_cols(); n++) {
+      long double sum = 0;
+      for (int k = 0; k < a.acc_cols(); k++) sum += a(m, k) * b(k, n);
+      c(m, n) = (T)sum;
+    }
+  }
+  return c;
+}
+
+TEST(Operations_tests, MulMatrix_vector_shapes) {
+  int threads = S21ThreadPool::ThreadCount();
+  s21::SimdLevel top = s21::DetectSimdLevel();
+  // Хвосты короче вектора, четыре строки за проход с остатком и размеры,
+  // при которых работа делится между потоками
+  for (auto shape : {std::make_pair(7, 13), std::make_pair(37, 53),
+                     std::make_pair(1, 301), std::make_pair(1100, 150),
+                     std::make_pair(150, 1100), std::make_pair(9000, 21)}) {
+    const int rows = shape.first, cols = shape.second;
+    S21Matrix a(rows, cols), x(cols, 1), xt(1, rows);
+    a.sequent_filling(-1, 1.0 / (rows * cols));
+    x.sequent_filling(0.5, 0.01);
+    xt.sequent_filling(-0.25, 0.003);
+    S21Matrix column = NaiveProduct(a, x), row = NaiveProduct(xt, a);
+    S21ThreadPool::SetThreadCount(1);
+    S21Matrix serial = xt * a;
+    for (int level = s21::kSimdScalar; level <= top; level++) {
+      s21::SetSimdLevel((s21::SimdLevel)level);
+      for (int count : {1, 4}) {
+        S21ThreadPool::SetThreadCount(count);
+        EXPECT_TRUE(a * x == column);
+        EXPECT_TRUE(xt * a == row);
+        // Транспонированный вид: Gemm меняет Gemv и Gevm местами
+        EXPECT_TRUE(x.view().Transposed() * a.view().Transposed() ==
+                    column.Transpose());
+        EXPECT_TRUE(a.view().Transposed() * xt.view().Transposed() ==
+                    row.Transpose());
+      }
+    }
+    s21::SetSimdLevel(top);
+    S21Matrix parallel = xt * a;
+    bool same = true;
+    for (int n = 0; n < cols; n++) {
+      same = same && serial(0, n) == parallel(0, n);
+    }
+    EXPECT_TRUE(same);
+  }
+  S21ThreadPool::SetThreadCount(threads);
+}
+
+TEST(Operations_tests, MulVector_raw) {
+  S21MatrixF a(33, 18);
+  a.sequent_filling(2, -0.01f);
+  std::vector<float> x(18), xt(33), y(33, NAN), yt(18, NAN);
+  S21MatrixF xm(18, 1), xtm(1, 33);
+  for (int i = 0; i < 18; i++) xm(i, 0) = x[i] = 0.1f * i - 0.5f;
+  for (int i = 0; i < 33; i++) xtm(0, i) = xt[i] = 0.05f * i;
+  // Выход не читается (NAN в y не портит результат)
+  a.MulVector(x.data(), y.data());
+  a.VectorMul(xt.data(), yt.data());
+  S21MatrixF column = NaiveProduct(a, xm), row = NaiveProduct(xtm, a);
+  for (int i = 0; i < 33; i++) EXPECT_NEAR(y[i], column(i, 0), 1e-4);
+  for (int i = 0; i < 18; i++) EXPECT_NEAR(yt[i], row(0, i), 1e-4);
+  EXPECT_EQ(a.MulVector(x), y);
+  EXPECT_EQ(a.VectorMul(xt), yt);
+  EXPECT_THROW(a.MulVector(xt), std::invalid_argument);
+  EXPECT_THROW(a.VectorMul(x), std::invalid_argument);
+
+  // alpha, beta и шаги у s21::Gemv / s21::Gevm
+  S21MatrixLD b(5, 3);
+  b.sequent_filling(1, 1);
+  long double v[6] = {1, -1, 2, -2, 3, -3}, out[10] = {};
+  for (int i = 0; i < 10; i++) out[i] = 1;
+  s21::Gemv(5, 3, 2.0L, b.data(), 3, v, 2, 3.0L, out, 2);
+  // Строка i: (3i + 1) * 1 + (3i + 2) * 2 + (3i + 3) * 3 = 18i + 14
+  for (int i = 0; i < 5; i++) {
+    EXPECT_EQ(out[2 * i], 2 * (18 * i + 14) + 3);
+    EXPECT_EQ(out[2 * i + 1], 1);
+  }
+}
+
 TEST(Operations_tests, MulMatrix_invalid_argum) {
   S21Matrix a(2, 4);
   S21Matrix b(3, 2);
@@ -205,6 +349,37 @@ TEST(Operations_tests, Transpose_equal) {
   ASSERT_TRUE(trans == c);
 }
 
+TEST(Operations_tests, Transpose_large_all_levels) {
+  S21Matrix a(300, 517);
+  a.sequent_filling(-3, 0.01);
+  s21::SimdLevel top = s21::DetectSimdLevel();
+  for (int level = s21::kSimdScalar; level <= top; level++) {
+    s21::SetSimdLevel((s21::SimdLevel)level);
+    S21Matrix trans = a.Transpose();
+    ASSERT_EQ(trans.acc_rows(), 517);
+    ASSERT_EQ(trans.acc_cols(), 300);
+    bool same = true;
+    for (int m = 0; m < 300; m++) {
+      for (int n = 0; n < 517; n++) same = same && trans(n, m) == a(m, n);
+    }
+    EXPECT_TRUE(same);
+  }
+  s21::SetSimdLevel(top);
+}
+
+TEST(Operations_tests, TransposeInPlace_equal) {
+  S21Matrix a(203, 203);
+  a.sequent_filling(1, 0.5);
+  S21Matrix check = a.Transpose();
+  a.TransposeInPlace();
+  EXPECT_TRUE(a == check);
+}
+
+TEST(Operations_tests, TransposeInPlace_not_square) {
+  S21Matrix a(2, 3);
+  EXPECT_THROW(a.TransposeInPlace(), std::invalid_argument);
+}
+
 //-------------Determinant-------------------
 
 TEST(Operations_tests, Determinant_without_0elem_0det) {
@@ -309,6 +484,66 @@ TEST(Operations_tests, Determinant_cannot_change_rows_det0) {
   EXPECT_EQ(res, check);
 }
 
+TEST(Operations_tests, Determinant_ill_conditioned_hilbert) {
+  S21Matrix h(6, 6);
+  for (int m = 0; m < 6; m++) {
+    for (int n = 0; n < 6; n++) h(m, n) = 1.0 / (m + n + 1);
+  }
+  double check = 1.0 / 186313420339200000.0;
+  EXPECT_NEAR(h.Determinant() / check, 1, 1e-6);
+}
+
+TEST(Operations_tests, Determinant_large_blocked) {
+  int size = 150;
+  S21Matrix l(size, size), u(size, size);
+  double check = 1;
+  for (int m = 0; m < size; m++) {
+    for (int n = 0; n < size; n++) {
+      if (n < m) l(m, n) = ((m * 7 + n * 3) % 11 - 5) * 0.01;
+      if (n > m) u(m, n) = ((m * 5 + n) % 13 - 6) * 0.01;
+    }
+    l(m, m) = 1;
+    u(m, m) = 1 + (m % 3) * 0.01;
+    check *= u(m, m);
+  }
+  EXPECT_NEAR((l * u).Determinant() / check, 1, 1e-9);
+}
+
+//-------------LU-------------------
+
+TEST(Operations_tests, LU_reconstruct) {
+  S21Matrix a(4, 4);
+  a.sequent_filling(1, 1);
+  a(0, 0) = 0;
+  a(2, 3) = -7;
+  a(3, 1) = 4;
+  S21Matrix l, u;
+  std::vector<int> perm;
+  EXPECT_NE(a.LU(l, u, perm), 0);
+  S21Matrix pa(4, 4);
+  for (int m = 0; m < 4; m++) {
+    for (int n = 0; n < 4; n++) {
+      pa(m, n) = a(perm[m], n);
+      if (n > m) {
+        EXPECT_EQ(l(m, n), 0);
+      } else if (n < m) {
+        EXPECT_EQ(u(m, n), 0);
+      }
+    }
+    EXPECT_EQ(l(m, m), 1);
+  }
+  ASSERT_TRUE(l * u == pa);
+}
+
+TEST(Operations_tests, LU_singular) {
+  S21Matrix a;
+  a.sequent_filling(1, 1);
+  std::vector<int> perm;
+  EXPECT_EQ(a.LUInPlace(perm), 0);
+  S21Matrix b(2, 3);
+  EXPECT_THROW(b.LUInPlace(perm), std::invalid_argument);
+}
+
 //-------------CalcComplements-------------------
 
 TEST(Operations_tests, CalcComplements_matrix_2on2) {
@@ -361,6 +596,47 @@ TEST(Operations_tests, CalcComplements_matrix_3on3) {
   ASSERT_TRUE(res == check);
 }
 
+TEST(Operations_tests, CalcComplements_rank_deficient) {
+  S21Matrix c(4, 4);
+  c.sequent_filling(1, 1);
+  S21Matrix zero(4, 4);
+  ASSERT_TRUE(c.CalcComplements() == zero);
+
+  S21Matrix d(3, 3);
+  d(0, 0) = 2;
+  d(0, 1) = 1;
+  d(0, 2) = 3;
+
+  d(1, 1) = 0;
+  d(1, 2) = 5;
+
+  d(2, 0) = 4;
+  d(2, 1) = 2;
+  d(2, 2) = 6;
+  S21Matrix check(3, 3);
+  for (int r = 0; r < 3; r++) {
+    for (int k = 0; k < 3; k++) {
+      double minor = d.CreateMiniMatrix(r, k).Determinant();
+      check(r, k) = (r + k) % 2 ? -minor : minor;
+    }
+  }
+  ASSERT_TRUE(d.CalcComplements() == check);
+}
+
+TEST(Operations_tests, CalcComplements_large_nonsingular) {
+  int size = 20;
+  S21Matrix a(size, size);
+  for (int m = 0; m < size; m++) {
+    for (int n = 0; n < size; n++) a(m, n) = ((m * 13 + n * 7) % 9 - 4) * 0.1;
+    a(m, m) += 2;
+  }
+  S21Matrix adj = a.CalcComplements().Transpose();
+  S21Matrix identity(size, size);
+  double det = a.Determinant();
+  for (int m = 0; m < size; m++) identity(m, m) = det;
+  ASSERT_TRUE(a * adj == identity);
+}
+
 TEST(Operations_tests, CalcComplements_matrix_1on1) {
   S21Matrix c(1, 1);
   S21Matrix check(1, 1);
@@ -428,6 +704,21 @@ TEST(Operations_tests, InverseMatrix_matrix_2on2) {
   ASSERT_TRUE(res == check);
 }
 
+TEST(Operations_tests, InverseMatrix_large_blocked) {
+  int size = 200;
+  S21Matrix a(size, size), identity(size, size);
+  for (int m = 0; m < size; m++) {
+    for (int n = 0; n < size; n++) {
+      a(m, n) = ((m * 31 + n * 17) % 23 - 11) * 0.05;
+    }
+    a(m, (m * 7) % size) += 10;
+    identity(m, m) = 1;
+  }
+  S21Matrix inverse = a.InverseMatrix();
+  ASSERT_TRUE(a * inverse == identity);
+  ASSERT_TRUE(inverse * a == identity);
+}
+
 TEST(Operations_tests, InverseMatrix_null_determinant) {
   S21Matrix c;
   c(0, 0) = 1;
@@ -462,6 +753,375 @@ TEST(Operations_tests, InverseMatrix_matrix_1on1) {
   ASSERT_TRUE(res == check);
 }
 
+//-------------Solve-------------------
+
+// Хорошо обусловленная матрица с перестановкой строк при разложении
+S21Matrix SolveTestMatrix(int size) {
+  S21Matrix a(size, size);
+  for (int m = 0; m < size; m++) {
+    for (int n = 0; n < size; n++) {
+      a(m, n) = ((m * 31 + n * 17) % 23 - 11) * 0.05;
+    }
+    a(m, (m * 7) % size) += 10;
+  }
+  return a;
+}
+
+TEST(Operations_tests, Solve_matrix_3on3) {
+  S21Matrix a(3, 3), b(3, 1), check(3, 1);
+  a(0, 0) = 0;
+  a(0, 1) = 2;
+  a(0, 2) = 1;
+  a(1, 0) = 1;
+  a(1, 1) = 1;
+  a(1, 2) = 1;
+  a(2, 0) = 2;
+  a(2, 1) = 1;
+  a(2, 2) = 3;
+  b(0, 0) = 7;
+  b(1, 0) = 6;
+  b(2, 0) = 13;
+  check(0, 0) = 1;
+  check(1, 0) = 2;
+  check(2, 0) = 3;
+  ASSERT_TRUE(a.Solve(b) == check);
+  ASSERT_TRUE(a.Solve(b, s21::SolveMode::kMixedPrecision) == check);
+}
+
+TEST(Operations_tests, Solve_large_multiple_rhs) {
+  const int size = 300, rhs = 7;
+  S21Matrix a = SolveTestMatrix(size), x(size, rhs);
+  x.sequent_filling(-2, 0.003);
+  S21Matrix b = a * x;
+  ASSERT_TRUE(a.Solve(b) == x);
+  ASSERT_TRUE(a.Solve(b, s21::SolveMode::kMixedPrecision) == x);
+  ASSERT_TRUE(a.Solve(b.Col(3).ToMatrix()) == x.Col(3).ToMatrix());
+
+  S21MatrixLD ald(size, size), xld(size, 2);
+  for (int m = 0; m < size; m++) {
+    for (int n = 0; n < size; n++) ald(m, n) = a(m, n);
+  }
+  xld.sequent_filling(1, -0.01L);
+  S21MatrixLD sol = ald.Solve(ald * xld, s21::SolveMode::kMixedPrecision);
+  long double worst = 0;
+  for (int m = 0; m < size; m++) {
+    for (int n = 0; n < 2; n++) {
+      worst = std::max(worst, std::fabs(sol(m, n) - xld(m, n)));
+    }
+  }
+  EXPECT_LT(worst, 1e-15L);
+}
+
+TEST(Operations_tests, Solve_ill_conditioned_falls_back) {
+  // Матрица Гильберта 11 x 11: число обусловленности ~1e15, float-разложение
+  // бесполезно, и решение считается в double
+  const int size = 11;
+  S21Matrix h(size, size), x(size, 1);
+  for (int m = 0; m < size; m++) {
+    for (int n = 0; n < size; n++) h(m, n) = 1.0 / (m + n + 1);
+    x(m, 0) = 1;
+  }
+  S21Matrix b = h * x;
+  S21Matrix direct = h.Solve(b);
+  S21Matrix mixed = h.Solve(b, s21::SolveMode::kMixedPrecision);
+  EXPECT_EQ(memcmp(direct.data(), mixed.data(), sizeof(double) * size), 0);
+  ASSERT_TRUE(h * mixed == b);
+}
+
+TEST(Operations_tests, Solve_errors) {
+  S21Matrix a(2, 3), b(2, 1), c(3, 3), d(2, 1);
+  EXPECT_THROW(a.Solve(b), std::invalid_argument);
+  EXPECT_THROW(c.Solve(d), std::invalid_argument);
+  S21Matrix singular(2, 2), rhs(2, 1);
+  singular(0, 0) = 1;
+  singular(0, 1) = 2;
+  singular(1, 0) = 2;
+  singular(1, 1) = 4;
+  EXPECT_THROW(singular.Solve(rhs), std::invalid_argument);
+  EXPECT_THROW(singular.Solve(rhs, s21::SolveMode::kMixedPrecision),
+               std::invalid_argument);
+}
+
+//-------------Cholesky-------------------
+
+// Матрица Грама X^T * X + I: симметричная положительно определенная
+S21Matrix SpdTestMatrix(int size) {
+  S21Matrix x(size + 5, size);
+  for (int m = 0; m < size + 5; m++) {
+    for (int n = 0; n < size; n++) x(m, n) = ((m * 13 + n * 29) % 19 - 9) * 0.1;
+  }
+  S21Matrix a = x.Transpose() * x;
+  for (int m = 0; m < size; m++) {
+    for (int n = 0; n < m; n++) a(m, n) = a(n, m);
+    a(m, m) += 1;
+  }
+  return a;
+}
+
+TEST(Operations_tests, Cholesky_matrix_3on3) {
+  S21Matrix a(3, 3), check(3, 3), l;
+  double values[] = {4, 12, -16, 12, 37, -43, -16, -43, 98};
+  double lower[] = {2, 0, 0, 6, 1, 0, -8, 5, 3};
+  for (int i = 0; i < 9; i++) {
+    a(i / 3, i % 3) = values[i];
+    check(i / 3, i % 3) = lower[i];
+  }
+  ASSERT_TRUE(a.Cholesky(l));
+  ASSERT_TRUE(l == check);
+  EXPECT_NEAR(a.DeterminantSPD(), 36, 1e-9);
+  ASSERT_TRUE(a.InverseMatrixSPD() == a.InverseMatrix());
+}
+
+TEST(Operations_tests, Cholesky_large_blocked) {
+  int threads = S21ThreadPool::ThreadCount();
+  for (int count : {1, 4}) {
+    S21ThreadPool::SetThreadCount(count);
+    const int size = 203;
+    S21Matrix a = SpdTestMatrix(size), l, identity(size, size);
+    for (int m = 0; m < size; m++) identity(m, m) = 1;
+    ASSERT_TRUE(a.Cholesky(l));
+    bool lower = true;
+    for (int m = 0; m < size; m++) {
+      for (int n = m + 1; n < size; n++) lower = lower && l(m, n) == 0;
+    }
+    EXPECT_TRUE(lower);
+    ASSERT_TRUE(l * l.Transpose() == a);
+    S21Matrix inverse = a.InverseMatrixSPD();
+    ASSERT_TRUE(a * inverse == identity);
+    ASSERT_TRUE(inverse == inverse.Transpose());
+    S21Matrix x(size, 5);
+    x.sequent_filling(-1, 0.001);
+    ASSERT_TRUE(a.SolveSPD(a * x) == x);
+  }
+  S21ThreadPool::SetThreadCount(threads);
+  S21Matrix small = SpdTestMatrix(40);
+  double det = small.Determinant();
+  EXPECT_NEAR(small.DeterminantSPD() / det, 1, 1e-10);
+}
+
+TEST(Operations_tests, Cholesky_not_positive_definite) {
+  S21Matrix indefinite(2, 2), asymmetric(2, 2), rhs(2, 1);
+  indefinite(0, 0) = 1;
+  indefinite(0, 1) = 2;
+  indefinite(1, 0) = 2;
+  indefinite(1, 1) = 1;
+  asymmetric(0, 0) = 2;
+  asymmetric(0, 1) = 1;
+  asymmetric(1, 1) = 2;
+  S21Matrix copy(indefinite), l;
+  EXPECT_FALSE(copy.CholeskyInPlace());
+  EXPECT_FALSE(indefinite.Cholesky(l));
+  EXPECT_THROW(indefinite.DeterminantSPD(), std::invalid_argument);
+  EXPECT_THROW(indefinite.InverseMatrixSPD(), std::invalid_argument);
+  EXPECT_THROW(indefinite.SolveSPD(rhs), std::invalid_argument);
+  EXPECT_THROW(asymmetric.InverseMatrixSPD(), std::invalid_argument);
+  S21Matrix rect(2, 3);
+  EXPECT_THROW(rect.DeterminantSPD(), std::invalid_argument);
+  EXPECT_THROW(rect.CholeskyInPlace(), std::invalid_argument);
+}
+
+//-------------QR-------------------
+
+TEST(Operations_tests, QR_tall_blocked) {
+  int threads = S21ThreadPool::ThreadCount();
+  for (int count : {1, 4}) {
+    S21ThreadPool::SetThreadCount(count);
+    const int rows = 3000, cols = 70;
+    S21Matrix a(rows, cols), q, r, identity(cols, cols);
+    for (int m = 0; m < rows; m++) {
+      for (int n = 0; n < cols; n++) {
+        a(m, n) = ((m * 37 + n * 11) % 29 - 14) * 0.07 + (m == n ? 3 : 0);
+      }
+    }
+    for (int m = 0; m < cols; m++) identity(m, m) = 1;
+    a.QR(q, r);
+    ASSERT_EQ(q.acc_rows(), rows);
+    ASSERT_EQ(r.acc_rows(), cols);
+    bool upper = true;
+    for (int m = 0; m < cols; m++) {
+      for (int n = 0; n < m; n++) upper = upper && r(m, n) == 0;
+    }
+    EXPECT_TRUE(upper);
+    ASSERT_TRUE(q.Transpose() * q == identity);
+    ASSERT_TRUE(q * r == a);
+  }
+  S21ThreadPool::SetThreadCount(threads);
+}
+
+TEST(Operations_tests, LeastSquares_line_fit) {
+  // y = 2x + 1 с шумом +-0.1 в четырех точках: решение (2, 1) точно, т.к.
+  // шум ортогонален столбцам
+  S21Matrix a(4, 2), b(4, 1), check(2, 1);
+  double noise[] = {0.1, -0.1, -0.1, 0.1};
+  for (int m = 0; m < 4; m++) {
+    a(m, 0) = m;
+    a(m, 1) = 1;
+    b(m, 0) = 2 * m + 1 + noise[m];
+  }
+  check(0, 0) = 2;
+  check(1, 0) = 1;
+  ASSERT_TRUE(a.LeastSquares(b) == check);
+}
+
+TEST(Operations_tests, LeastSquares_matches_normal_equations) {
+  const int rows = 20000, cols = 40, rhs = 3;
+  S21Matrix a(rows, cols), b(rows, rhs);
+  for (int m = 0; m < rows; m++) {
+    for (int n = 0; n < cols; n++) {
+      a(m, n) = ((m * 37 + n * 11) % 29 - 14) * 0.07 + (m % cols == n ? 1 : 0);
+    }
+    for (int n = 0; n < rhs; n++) b(m, n) = ((m * 7 + n) % 13 - 6) * 0.1;
+  }
+  S21Matrix at = a.Transpose();
+  S21Matrix normal = at * a;
+  ASSERT_TRUE(a.LeastSquares(b) == normal.Solve(at * b));
+  S21Matrix square = SolveTestMatrix(100), x(100, 2);
+  x.sequent_filling(1, 0.01);
+  ASSERT_TRUE(square.LeastSquares(square * x) == x);
+}
+
+TEST(Operations_tests, LeastSquares_errors) {
+  S21Matrix wide(2, 3), b(2, 1), tall(3, 2), wrong(2, 1), q, r;
+  EXPECT_THROW(wide.LeastSquares(b), std::invalid_argument);
+  EXPECT_THROW(wide.QR(q, r), std::invalid_argument);
+  EXPECT_THROW(tall.LeastSquares(wrong), std::invalid_argument);
+  for (int m = 0; m < 3; m++) {
+    tall(m, 0) = m + 1;
+    tall(m, 1) = 2 * (m + 1);
+  }
+  S21Matrix rhs(3, 1);
+  EXPECT_THROW(tall.LeastSquares(rhs), std::invalid_argument);
+  EXPECT_THROW(tall.QR(q, r), std::invalid_argument);
+}
+
+//-------------Factor cache-------------------
+
+// Определитель копии без сохраненного разложения
+double FreshDeterminant(const S21Matrix& a) {
+  S21Matrix copy(a);
+  return copy.Determinant();
+}
+
+TEST(Operations_tests, Factors_reused_across_calls) {
+  const int size = 40;
+  S21Matrix a = SolveTestMatrix(size), fresh = SolveTestMatrix(size);
+  S21Matrix b(size, 2), identity(size, size);
+  for (int m = 0; m < size; m++) {
+    identity(m, m) = 1;
+    b(m, 0) = m;
+    b(m, 1) = 1;
+  }
+  double det = a.Determinant();
+  S21Matrix inverse = a.InverseMatrix();
+  EXPECT_DOUBLE_EQ(a.Determinant(), det);
+  EXPECT_NEAR(det, fresh.Determinant(), std::fabs(det) * 1e-12);
+  ASSERT_TRUE(inverse == fresh.InverseMatrix());
+  ASSERT_TRUE(a * inverse == identity);
+  ASSERT_TRUE(a.Solve(b) == fresh.Solve(b));
+  ASSERT_TRUE(a.Solve(b, s21::SolveMode::kMixedPrecision) == fresh.Solve(b));
+  ASSERT_TRUE(a.CalcComplements() == fresh.CalcComplements());
+
+  S21Matrix spd = SpdTestMatrix(12), spd_fresh = SpdTestMatrix(12);
+  EXPECT_NEAR(spd.DeterminantSPD(), spd.Determinant(),
+              spd.Determinant() * 1e-12);
+  ASSERT_TRUE(spd.InverseMatrix() == spd_fresh.InverseMatrix());
+
+  S21Matrix tall(30, 4), rhs1(30, 1), rhs2(30, 1);
+  for (int m = 0; m < 30; m++) {
+    for (int n = 0; n < 4; n++) tall(m, n) = std::pow(m * 0.1, n);
+    rhs1(m, 0) = std::sin(m * 0.3);
+    rhs2(m, 0) = m * m * 0.01;
+  }
+  S21Matrix tall_fresh(tall), q, r;
+  S21Matrix x1 = tall.LeastSquares(rhs1), x2 = tall.LeastSquares(rhs2);
+  ASSERT_TRUE(x1 == S21Matrix(tall_fresh).LeastSquares(rhs1));
+  ASSERT_TRUE(x2 == S21Matrix(tall_fresh).LeastSquares(rhs2));
+  tall.QR(q, r);
+  ASSERT_TRUE(q * r == tall_fresh);
+}
+
+TEST(Operations_tests, Factors_checked_after_late_write) {
+  const int size = 5;
+  S21Matrix a(size, size);
+  for (int m = 0; m < size; m++) a(m, m) = 1;
+  double& ref = a(0, 0);
+  double* raw = a.data();
+  S21Matrix::View block = a.Block(1, 1, 2, 2);
+  EXPECT_DOUBLE_EQ(a.Determinant(), 1);
+  ref = 5;
+  EXPECT_DOUBLE_EQ(a.Determinant(), 5);
+  EXPECT_DOUBLE_EQ(a.InverseMatrix()(0, 0), 0.2);
+  raw[size * size - 1] = 2;
+  EXPECT_DOUBLE_EQ(a.Determinant(), 10);
+  block(0, 0) = -1;
+  EXPECT_DOUBLE_EQ(a.Determinant(), -10);
+  S21Matrix b(size, 1);
+  b(1, 0) = 3;
+  EXPECT_DOUBLE_EQ(a.Solve(b)(1, 0), -3);
+  // Смена знака двух элементов с тем же шагом в буфере
+  block(0, 0) = 1;
+  raw[0] = -5;
+  raw[size * size - 1] = -2;
+  EXPECT_DOUBLE_EQ(a.Solve(b)(1, 0), 3);
+  EXPECT_DOUBLE_EQ(a.Determinant(), 10);
+
+  S21Matrix spd = SpdTestMatrix(size), spd_fresh = SpdTestMatrix(size);
+  double* spd_raw = spd.data();
+  EXPECT_NEAR(spd.DeterminantSPD(), spd_fresh.Determinant(),
+              spd_fresh.Determinant() * 1e-12);
+  spd_raw[0] += 1;
+  spd_fresh(0, 0) += 1;
+  EXPECT_NEAR(spd.Determinant(), spd_fresh.Determinant(),
+              spd_fresh.Determinant() * 1e-12);
+  ASSERT_TRUE(spd.InverseMatrix() == spd_fresh.InverseMatrix());
+}
+
+TEST(Operations_tests, Factors_dropped_on_mutation) {
+  const int size = 6;
+  S21Matrix a = SolveTestMatrix(size), other = SpdTestMatrix(size);
+  auto check = [&](const char* what) {
+    SCOPED_TRACE(what);
+    double det = FreshDeterminant(a);
+    EXPECT_NEAR(a.Determinant(), det, std::fabs(det) * 1e-12);
+    S21Matrix copy(a);
+    ASSERT_TRUE(a.InverseMatrix() == copy.InverseMatrix());
+  };
+  check("initial");
+  a(0, 0) += 3;
+  check("operator()");
+  a += other;
+  check("+=");
+  a -= other * 2.0;
+  check("-= expression");
+  a *= 1.5;
+  check("*= number");
+  a *= other;
+  check("*= matrix");
+  a.mutator(size + 1, size + 1);
+  a(size, size) = 2;
+  check("mutator");
+  a = other;
+  check("assignment");
+  a = SolveTestMatrix(size);
+  check("move assignment");
+  a.data()[1] = 5;
+  check("data()");
+  a.Block(1, 1, 2, 2).Fill(0.5);
+  check("Block");
+  a = a + other;
+  check("expression assignment");
+  a.TransposeInPlace();
+  a.Row(0).MulNumber(-1);
+  check("Row");
+
+  S21Matrix spd = SpdTestMatrix(size);
+  spd.DeterminantSPD();
+  spd(0, 1) += 0.5;
+  EXPECT_NEAR(spd.Determinant(), FreshDeterminant(spd),
+              std::fabs(FreshDeterminant(spd)) * 1e-12);
+  EXPECT_THROW(spd.DeterminantSPD(), std::invalid_argument);
+}
+
 //-------------Overloads-------------------
 
 TEST(Overloads_tests, operator_assign) {
@@ -483,6 +1143,30 @@ TEST(Overloads_tests, operator_assign) {
   ASSERT_TRUE(c == check);
 }
 
+TEST(Overloads_tests, operator_assign_reshape) {
+  S21Matrix a(2, 6), b(4, 3), c(5, 5);
+  a.sequent_filling(1, 1);
+  b = a;
+  EXPECT_EQ(b.acc_rows(), 2);
+  EXPECT_EQ(b.acc_cols(), 6);
+  EXPECT_TRUE(b == a);
+  c = b = b;
+  EXPECT_EQ(c.acc_rows(), 2);
+  EXPECT_TRUE(c == a);
+}
+
+TEST(Overloads_tests, operator_move_assign) {
+  S21Matrix a(3, 2), b;
+  a.sequent_filling(1, 2);
+  S21Matrix check(a);
+  b = std::move(a);
+  EXPECT_EQ(a.acc_rows(), 0);
+  EXPECT_EQ(a.acc_cols(), 0);
+  EXPECT_TRUE(b == check);
+  a = check;
+  EXPECT_TRUE(a == check);
+}
+
 TEST(Overloads_tests, operator_equal) {
   S21Matrix c(2, 2);
   c(0, 0) = 1;
@@ -557,6 +1241,85 @@ TEST(Overloads_tests, operator_sub) {
   ASSERT_TRUE(sum == res);
 }
 
+TEST(Overloads_tests, operator_expression_chain) {
+  S21Matrix a(5, 9), b(5, 9), c(5, 9);
+  a.sequent_filling(-2, 0.3);
+  b.sequent_filling(4, -0.7);
+  c.sequent_filling(1, 0.05);
+  S21Matrix check(5, 9);
+  for (int m = 0; m < 5; m++) {
+    for (int n = 0; n < 9; n++) {
+      check(m, n) = (a(m, n) + b(m, n) * 2) - 0.5 * c(m, n);
+    }
+  }
+  s21::SimdLevel top = s21::DetectSimdLevel();
+  for (int level = s21::kSimdScalar; level <= top; level++) {
+    s21::SetSimdLevel((s21::SimdLevel)level);
+    S21Matrix res = a + b * 2 - 0.5 * c;
+    EXPECT_TRUE(res == check);
+    S21Matrix acc(a);
+    acc = acc + b * 2;
+    acc -= 0.5 * c;
+    EXPECT_TRUE(acc == check);
+  }
+  s21::SetSimdLevel(top);
+}
+
+TEST(Overloads_tests, operator_expression_mixed) {
+  S21Matrix a(2, 3), b(2, 3), c(3, 2), d(3, 3);
+  a.sequent_filling(1, 1);
+  b.sequent_filling(2, 2);
+  c.sequent_filling(-1, 0.5);
+  S21Matrix check = S21Matrix(a * 3) * c;
+  EXPECT_TRUE((a + b) * c == check);
+  EXPECT_THROW(a + d, std::invalid_argument);
+  EXPECT_THROW(a - c, std::invalid_argument);
+  d = b - a;
+  EXPECT_EQ(d.acc_rows(), 2);
+  EXPECT_TRUE(d == a);
+}
+
+TEST(Overloads_tests, operator_expression_matrix_api) {
+  S21Matrix a(3, 3), b(3, 3);
+  a.sequent_filling(1, 1);
+  b(0, 0) = 1;
+  b(1, 2) = 4;
+  b(2, 1) = -2;
+  S21Matrix sum(a), diff(a);
+  sum += b;
+  diff -= b;
+  EXPECT_EQ((a + b).acc_rows(), 3);
+  EXPECT_EQ((a - b).acc_cols(), 3);
+  EXPECT_DOUBLE_EQ((a + b)(1, 2), sum(1, 2));
+  EXPECT_THROW((a + b)(3, 0), std::out_of_range);
+  EXPECT_NEAR((a + b).Determinant(), sum.Determinant(), 1e-9);
+  EXPECT_TRUE((a - b).Transpose() == diff.Transpose());
+  EXPECT_TRUE((a + b).InverseMatrix() == sum.InverseMatrix());
+  EXPECT_TRUE((a + b).CalcComplements() == sum.CalcComplements());
+  EXPECT_TRUE((a * 2.0).EqMatrix(a + a));
+}
+
+static S21Matrix OnesMatrix(int rows, int cols) {
+  S21Matrix m(rows, cols);
+  m.sequent_filling(1, 0);
+  return m;
+}
+
+TEST(Overloads_tests, operator_expression_keeps_temporaries) {
+  S21Matrix a(4, 5);
+  auto c = a + OnesMatrix(4, 5);
+  auto d = OnesMatrix(4, 5) * 3.0 - OnesMatrix(4, 5);
+  S21Matrix scratch = OnesMatrix(4, 5) * 7.0;
+  S21Matrix sum = c, twos = d;
+  EXPECT_DOUBLE_EQ(sum(3, 4), 1);
+  EXPECT_DOUBLE_EQ(c(0, 0), 1);
+  EXPECT_DOUBLE_EQ(twos(2, 1), 2);
+  EXPECT_DOUBLE_EQ(scratch(0, 0), 7);
+  S21Matrix ones = OnesMatrix(3, 3);
+  auto e = ones * ones * 2.0;
+  EXPECT_DOUBLE_EQ(S21Matrix(e)(1, 1), 6);
+}
+
 TEST(Overloads_tests, operator_mult_numb_num_second) {
   S21Matrix c(2, 2);
   double num = 5;
@@ -750,6 +1513,979 @@ TEST(Overloads_tests, operator_index_not_range) {
   EXPECT_THROW(a(-1, 0), std::out_of_range);
 }
 
+//-------------SIMD-------------------
+
+// NaN в сравнении не считается отличием (fabs(NaN) > eps ложно) на всех
+// уровнях SIMD и для всех типов элемента: векторная часть и хвост
+template <typename T>
+static void CheckEqualNan() {
+  S21BasicMatrix<T> a(5, 19);
+  a.sequent_filling(1, (T)0.5);
+  S21BasicMatrix<T> b(a);
+  b(0, 0) = std::numeric_limits<T>::quiet_NaN();
+  b(4, 18) = std::numeric_limits<T>::quiet_NaN();
+  s21::SimdLevel top = s21::DetectSimdLevel();
+  for (int level = s21::kSimdScalar; level <= top; level++) {
+    s21::SetSimdLevel((s21::SimdLevel)level);
+    SCOPED_TRACE(level);
+    EXPECT_TRUE(a == b);
+    EXPECT_TRUE(b == a);
+    S21BasicMatrix<T> c(b);
+    c(2, 7) += 1;
+    EXPECT_FALSE(c == a);
+  }
+  s21::SetSimdLevel(top);
+}
+
+TEST(Simd_tests, elementwise_all_levels) {
+  S21Matrix a(7, 13), b(7, 13);
+  a.sequent_filling(-5, 0.37);
+  b.sequent_filling(2, -0.11);
+  S21Matrix sum(7, 13), diff(7, 13), scaled(7, 13);
+  for (int m = 0; m < 7; m++) {
+    for (int n = 0; n < 13; n++) {
+      sum(m, n) = a(m, n) + b(m, n);
+      diff(m, n) = a(m, n) - b(m, n);
+      scaled(m, n) = a(m, n) * 1.5;
+    }
+  }
+  s21::SimdLevel top = s21::DetectSimdLevel();
+  for (int level = s21::kSimdScalar; level <= top; level++) {
+    s21::SetSimdLevel((s21::SimdLevel)level);
+    EXPECT_TRUE(a + b == sum);
+    EXPECT_TRUE(a - b == diff);
+    EXPECT_TRUE(a * 1.5 == scaled);
+    S21Matrix copy(a);
+    copy(6, 12) += 1e-6;
+    EXPECT_FALSE(copy == a);
+    copy(6, 12) = a(6, 12) + 1e-8;
+    EXPECT_TRUE(copy == a);
+  }
+  s21::SetSimdLevel(top);
+  CheckEqualNan<float>();
+  CheckEqualNan<double>();
+  CheckEqualNan<long double>();
+}
+
+TEST(Simd_tests, mul_matrix_all_levels) {
+  S21Matrix a(97, 70), b(70, 45);
+  a.sequent_filling(-1, 0.0003);
+  b.sequent_filling(1, -0.0002);
+  s21::SimdLevel top = s21::DetectSimdLevel();
+  s21::SetSimdLevel(s21::kSimdScalar);
+  S21Matrix check = a * b;
+  for (int level = s21::kSimdSse2; level <= top; level++) {
+    s21::SetSimdLevel((s21::SimdLevel)level);
+    EXPECT_TRUE(a * b == check);
+  }
+  s21::SetSimdLevel(top);
+}
+
+//-------------Element types-------------------
+
+static_assert(std::is_same<S21Matrix, S21BasicMatrix<double>>::value,
+              "S21Matrix - матрица double");
+
+TEST(ElementType_tests, float_all_levels) {
+  S21MatrixF a(37, 61), b(37, 61);
+  a.sequent_filling(-5, 0.25f);
+  b.sequent_filling(2, -0.125f);
+  S21MatrixF sum(37, 61), expr(37, 61);
+  for (int m = 0; m < 37; m++) {
+    for (int n = 0; n < 61; n++) {
+      sum(m, n) = a(m, n) + b(m, n);
+      expr(m, n) = a(m, n) - b(m, n) * 2;
+    }
+  }
+  S21MatrixF p(37, 61), c(61, 45);
+  p.sequent_filling(-1, 0.0005f);
+  c.sequent_filling(0.1f, -0.0001f);
+  s21::SimdLevel top = s21::DetectSimdLevel();
+  s21::SetSimdLevel(s21::kSimdScalar);
+  S21MatrixF product = p * c;
+  S21MatrixF trans = a.Transpose();
+  for (int level = s21::kSimdScalar; level <= top; level++) {
+    s21::SetSimdLevel((s21::SimdLevel)level);
+    EXPECT_STREQ(s21::Simd<float>().name, s21::Simd<double>().name);
+    EXPECT_TRUE(a + b == sum);
+    EXPECT_TRUE(a - b * 2.0f == expr);
+    EXPECT_TRUE(p * c == product);
+    EXPECT_TRUE(a.Transpose() == trans);
+    S21MatrixF copy(a);
+    copy(36, 60) += 1e-3f;
+    EXPECT_FALSE(copy == a);
+  }
+  s21::SetSimdLevel(top);
+  for (int n = 0; n < 61; n++) EXPECT_EQ(trans(n, 36), a(36, n));
+}
+
+TEST(ElementType_tests, float_gemm_matches_double) {
+  const int m = 150, k = 170, n = 130;
+  S21MatrixF a(m, k), b(k, n);
+  S21Matrix ad(m, k), bd(k, n);
+  a.sequent_filling(-1, 0.0001f);
+  b.sequent_filling(1, -0.0001f);
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < k; j++) ad(i, j) = a(i, j);
+  }
+  for (int i = 0; i < k; i++) {
+    for (int j = 0; j < n; j++) bd(i, j) = b(i, j);
+  }
+  S21MatrixF c = a * b;
+  S21Matrix cd = ad * bd;
+  double worst = 0;
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      double err = fabs(c(i, j) - cd(i, j)) / (1 + fabs(cd(i, j)));
+      worst = std::max(worst, err);
+    }
+  }
+  EXPECT_LT(worst, 1e-5);
+}
+
+TEST(ElementType_tests, float_linalg) {
+  S21MatrixF a(3, 3);
+  a(0, 0) = 2, a(0, 1) = 5, a(0, 2) = 7;
+  a(1, 0) = 6, a(1, 1) = 3, a(1, 2) = 4;
+  a(2, 0) = 5, a(2, 1) = -2, a(2, 2) = -3;
+  EXPECT_NEAR(a.Determinant(), -1.0f, 1e-5f);
+  S21MatrixF inv = a.InverseMatrix();
+  S21MatrixF check(3, 3);
+  check(0, 0) = 1, check(0, 1) = -1, check(0, 2) = 1;
+  check(1, 0) = -38, check(1, 1) = 41, check(1, 2) = -34;
+  check(2, 0) = 27, check(2, 1) = -29, check(2, 2) = 24;
+  EXPECT_TRUE(inv == check);
+  S21MatrixF comp = a.CalcComplements();
+  EXPECT_TRUE(comp == check.Transpose() * -1.0f);
+  S21MatrixF singular(2, 2);
+  singular(0, 0) = 1, singular(0, 1) = 2;
+  singular(1, 0) = 2, singular(1, 1) = 4;
+  EXPECT_EQ(singular.Determinant(), 0.0f);
+  EXPECT_THROW(singular.InverseMatrix(), std::invalid_argument);
+}
+
+TEST(ElementType_tests, long_double_linalg) {
+  const int n = 90;
+  S21MatrixLD a(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) a(i, j) = 1.0L / (1 + (i * 7 + j * 3) % 11);
+    a(i, i) += n;
+  }
+  S21MatrixLD identity(n, n);
+  for (int i = 0; i < n; i++) identity(i, i) = 1;
+  S21MatrixLD inv = a.InverseMatrix();
+  EXPECT_TRUE(a * inv == identity);
+  S21MatrixLD lhs = a + inv * 2.0L;
+  S21MatrixLD rhs(a);
+  rhs += inv * 2.0L;
+  EXPECT_TRUE(lhs == rhs);
+  EXPECT_TRUE(a.Transpose().Transpose() == a);
+  S21MatrixLD b(2, 2);
+  b(0, 0) = 4, b(0, 1) = 1, b(1, 0) = 2, b(1, 1) = 3;
+  EXPECT_EQ(b.Determinant(), 10.0L);
+}
+
+TEST(ElementType_tests, tolerance_per_type) {
+  S21MatrixF f(1, 1), g(1, 1);
+  g(0, 0) = 5e-5f;
+  EXPECT_TRUE(f == g);
+  g(0, 0) = 5e-4f;
+  EXPECT_FALSE(f == g);
+  S21MatrixLD l(1, 1), r(1, 1);
+  r(0, 0) = 1e-10L;
+  EXPECT_TRUE(l == r);
+  r(0, 0) = 1e-8L;
+  EXPECT_FALSE(l == r);
+}
+
+//-------------Views-------------------
+
+TEST(View_tests, slicing) {
+  S21Matrix m(5, 7);
+  m.sequent_filling(0, 1);
+  S21Matrix::View block = m.Block(1, 2, 3, 4);
+  EXPECT_EQ(block.rows(), 3);
+  EXPECT_EQ(block(0, 0), 9);
+  EXPECT_EQ(block(2, 3), 26);
+  EXPECT_EQ(m.Row(4)(0, 6), 34);
+  EXPECT_EQ(m.Col(3)(2, 0), 17);
+  S21Matrix::ConstView t = m.view().Transposed();
+  EXPECT_EQ(t.rows(), 7);
+  EXPECT_EQ(t(6, 1), m(1, 6));
+  S21MatrixView strided = m.view().Strided(2, 3);
+  EXPECT_EQ(strided.rows(), 3);
+  EXPECT_EQ(strided.cols(), 3);
+  EXPECT_EQ(strided(2, 2), m(4, 6));
+  EXPECT_EQ(block.Block(1, 1, 2, 2)(1, 1), m(3, 4));
+  block(0, 0) = -1;
+  EXPECT_EQ(m(1, 2), -1);
+  EXPECT_TRUE(S21Matrix(t) == m.Transpose());
+  EXPECT_TRUE(block.ToMatrix() == S21Matrix(block));
+  EXPECT_TRUE(strided.Transposed().ToMatrix() == strided.Transpose());
+  EXPECT_THROW(m.Block(3, 0, 3, 1), std::out_of_range);
+  EXPECT_THROW(block(3, 0), std::out_of_range);
+  EXPECT_THROW(m.view().Strided(0, 1), std::invalid_argument);
+}
+
+TEST(View_tests, in_place_operations) {
+  S21Matrix m(6, 6), add(2, 6);
+  m.sequent_filling(1, 1);
+  add.sequent_filling(100, 0);
+  S21Matrix copy(m);
+  m.Block(0, 0, 2, 6) += add;
+  m.Row(5) -= m.Row(4);
+  m.Col(0) *= 2.0;
+  m.Block(2, 2, 2, 2).Fill(0);
+  EXPECT_EQ(m(1, 3), copy(1, 3) + 100);
+  EXPECT_EQ(m(0, 0), 2 * (copy(0, 0) + 100));
+  EXPECT_EQ(m(5, 3), 6);
+  EXPECT_EQ(m(3, 3), 0);
+  EXPECT_EQ(m(4, 4), copy(4, 4));
+  // Транспонированный и прореженный виды: поэлементный путь
+  S21Matrix a(3, 3), b(3, 3);
+  a.sequent_filling(0, 1);
+  b.view().Transposed().Assign(a);
+  EXPECT_TRUE(b == a.Transpose());
+  b.view().Transposed().SumMatrix(a.view().Transposed().Transposed());
+  EXPECT_EQ(b(0, 2), 2 * a(2, 0));
+  a.view().Strided(2, 2).SubMatrix(a.view().Strided(2, 2));
+  EXPECT_EQ(a(2, 2), 0);
+  EXPECT_EQ(a(1, 1), 4);
+  EXPECT_THROW(a.Row(0).SumMatrix(a.Col(0)), std::invalid_argument);
+}
+
+TEST(View_tests, read_only_operations) {
+  S21Matrix a(40, 30), b(50, 40);
+  a.sequent_filling(-0.5, 0.001);
+  b.sequent_filling(0.25, -0.002);
+  S21Matrix at = a.Transpose();
+  // Произведение транспонированного вида и блока без копирования
+  S21Matrix product = at.view().Transposed() * b.view().Block(10, 5, 30, 20);
+  EXPECT_TRUE(product == a * b.CreateMiniMatrix(0, 0)
+                                 .view()
+                                 .Block(9, 4, 30, 20)
+                                 .ToMatrix());
+  S21Matrix c(a);
+  c.MulMatrix(b.view().Transposed().Block(0, 0, 30, 7));
+  EXPECT_TRUE(c == a * S21Matrix(b.view().Transposed().Block(0, 0, 30, 7)));
+  EXPECT_TRUE(a.EqMatrix(at.view().Transposed()));
+  EXPECT_TRUE(at.view().Transposed() == a);
+  S21Matrix sq(4, 4);
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) sq(i, j) = (i * 5 + j * 3) % 7 + (i == j) * 9;
+  }
+  S21Matrix wide(4, 8);
+  wide.Block(0, 4, 4, 4).Assign(sq);
+  EXPECT_NEAR(wide.Block(0, 4, 4, 4).Determinant(), sq.Determinant(), 1e-9);
+  EXPECT_TRUE(wide.Block(0, 4, 4, 4).InverseMatrix() == sq.InverseMatrix());
+  EXPECT_NEAR(sq.view().Transposed().Determinant(), sq.Determinant(), 1e-9);
+  S21MatrixF f(3, 3);
+  f.sequent_filling(1, 0.5f);
+  S21ConstMatrixViewF fv = f.view();
+  EXPECT_TRUE(fv.Transposed().Transposed() == f);
+  EXPECT_THROW(a.view() * a.view(), std::invalid_argument);
+}
+
+//-------------Batch-------------------
+
+// Хорошо обусловленная матрица n x n номер b (диагональное преобладание)
+static S21Matrix BatchSample(int b, int n) {
+  S21Matrix m(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) m(i, j) = ((b * 31 + i * 7 + j * 17) % 23 - 11);
+    m(i, i) += 40 + b % 5;
+  }
+  return m;
+}
+
+TEST(Batch_tests, import_export) {
+  std::vector<S21Matrix> matrices;
+  for (int b = 0; b < 37; b++) {
+    S21Matrix m(3, 4);
+    m.sequent_filling(b, 0.5);
+    matrices.push_back(m);
+  }
+  S21MatrixBatch batch(matrices);
+  EXPECT_EQ(batch.count(), 37);
+  EXPECT_EQ(batch.rows(), 3);
+  EXPECT_EQ(batch.cols(), 4);
+  EXPECT_EQ(batch(5, 1, 2), matrices[5](1, 2));
+  EXPECT_EQ(batch.plane(1, 2)[5], matrices[5](1, 2));
+  std::vector<S21Matrix> back = batch.ToMatrices();
+  ASSERT_EQ(back.size(), 37u);
+  for (int b = 0; b < 37; b++) EXPECT_TRUE(back[b] == matrices[b]);
+  S21Matrix m(3, 4);
+  m(2, 3) = 7;
+  batch.set_matrix(36, m);
+  EXPECT_TRUE(batch.matrix(36) == m);
+  EXPECT_THROW(batch.set_matrix(37, m), std::out_of_range);
+  EXPECT_THROW(batch.set_matrix(0, S21Matrix(4, 3)), std::invalid_argument);
+  EXPECT_THROW(batch(0, 3, 0), std::out_of_range);
+  matrices[3] = S21Matrix(3, 3);
+  EXPECT_THROW(S21MatrixBatch{matrices}, std::invalid_argument);
+  EXPECT_THROW(S21MatrixBatch(0, 3, 3), std::invalid_argument);
+}
+
+TEST(Batch_tests, determinant_inverse_all_levels) {
+  s21::SimdLevel top = s21::DetectSimdLevel();
+  for (int n = 1; n <= 5; n++) {
+    std::vector<S21Matrix> matrices;
+    for (int b = 0; b < 45; b++) matrices.push_back(BatchSample(b, n));
+    S21MatrixBatch batch(matrices);
+    for (int level = s21::kSimdScalar; level <= top; level++) {
+      s21::SetSimdLevel((s21::SimdLevel)level);
+      std::vector<double> det = batch.Determinant();
+      S21MatrixBatch inv = batch.InverseMatrix();
+      ASSERT_EQ(det.size(), 45u);
+      for (int b = 0; b < 45; b++) {
+        double check = matrices[b].Determinant();
+        EXPECT_NEAR(det[b], check, 1e-12 * fabs(check));
+        EXPECT_TRUE(inv.matrix(b) == matrices[b].InverseMatrix());
+      }
+    }
+  }
+  s21::SetSimdLevel(top);
+}
+
+TEST(Batch_tests, operations_match_single) {
+  std::vector<S21Matrix> a, b;
+  for (int k = 0; k < 29; k++) {
+    a.push_back(S21Matrix(3, 4));
+    a.back().sequent_filling(k * 0.1, -0.3);
+    b.push_back(S21Matrix(4, 2));
+    b.back().sequent_filling(1 - k, 0.7);
+  }
+  S21MatrixBatch ba(a), bb(b);
+  S21MatrixBatch product = ba * bb;
+  S21MatrixBatch trans = ba.Transpose();
+  S21MatrixBatch sum = ba + ba * 2.0;
+  S21MatrixBatch diff = ba - ba;
+  for (int k = 0; k < 29; k++) {
+    EXPECT_TRUE(product.matrix(k) == a[k] * b[k]);
+    EXPECT_TRUE(trans.matrix(k) == a[k].Transpose());
+    EXPECT_TRUE(sum.matrix(k) == a[k] * 3.0);
+    EXPECT_TRUE(diff.matrix(k) == S21Matrix(3, 4));
+  }
+  EXPECT_TRUE(sum == ba * 3.0);
+  EXPECT_FALSE(sum == ba);
+  EXPECT_THROW(ba * ba, std::invalid_argument);
+  EXPECT_THROW(ba + trans, std::invalid_argument);
+  EXPECT_THROW(ba.Determinant(), std::invalid_argument);
+}
+
+TEST(Batch_tests, singular_and_large_parallel) {
+  const int count = 100003;
+  S21MatrixBatchF batch(count, 4, 4);
+  for (int b = 0; b < count; b++) {
+    for (int i = 0; i < 4; i++) {
+      for (int j = 0; j < 4; j++) {
+        batch(b, i, j) = (float)((b * 13 + i * 5 + j * 3) % 9 - 4);
+      }
+      batch(b, i, i) += 20;
+    }
+  }
+  S21MatrixBatchF inv = batch.InverseMatrix();
+  S21MatrixBatchF identity = batch * inv;
+  S21MatrixF one(4, 4);
+  for (int i = 0; i < 4; i++) one(i, i) = 1;
+  for (int b = 0; b < count; b += 997) {
+    EXPECT_TRUE(identity.matrix(b) == one);
+  }
+  EXPECT_TRUE(identity.matrix(count - 1) == one);
+  batch.set_matrix(count - 1, S21MatrixF(4, 4));
+  EXPECT_EQ(batch.Determinant()[count - 1], 0.0f);
+  EXPECT_THROW(batch.InverseMatrix(), std::invalid_argument);
+}
+
+//-------------Sparse-------------------
+
+// Разреженная матрица rows x cols примерно с per_row ненулевыми в строке
+static S21SparseMatrix SparseSample(int rows, int cols, int per_row,
+                                    S21SparseMatrix::Format format) {
+  std::vector<S21SparseMatrix::Triplet> triplets;
+  unsigned state = rows * 7919u + cols;
+  for (int i = 0; i < rows; i++) {
+    for (int k = 0; k < per_row; k++) {
+      state = state * 1664525u + 1013904223u;
+      int col = (int)(state >> 8) % cols;
+      triplets.push_back({i, col, (int)(state % 19) - 9.5});
+    }
+  }
+  return S21SparseMatrix(rows, cols, triplets, format);
+}
+
+TEST(Sparse_tests, dense_conversion) {
+  S21Matrix dense(7, 9);
+  for (int i = 0; i < 7; i++) {
+    for (int j = 0; j < 9; j++) {
+      if ((i * 9 + j) % 4 == 0) dense(i, j) = i - j + 0.5;
+    }
+  }
+  dense(6, 8) = 1e-9;
+  S21SparseMatrix csr(dense);
+  S21SparseMatrix csc(dense, S21SparseMatrix::kCsc);
+  EXPECT_EQ(csr.nnz(), 17u);
+  EXPECT_EQ(csc.nnz(), 17u);
+  EXPECT_EQ(csr.ptr().size(), 8u);
+  EXPECT_EQ(csc.ptr().size(), 10u);
+  EXPECT_TRUE(csr.ToDense() == dense);
+  EXPECT_TRUE(csc.ToDense() == dense);
+  EXPECT_EQ(csr.at(4, 0), 4.5);
+  EXPECT_EQ(csc.at(4, 0), 4.5);
+  EXPECT_EQ(csr.at(4, 1), 0.0);
+  EXPECT_THROW(csr.at(7, 0), std::out_of_range);
+  EXPECT_EQ(S21SparseMatrix(dense, S21SparseMatrix::kCsr, 1e-6).nnz(), 16u);
+  S21SparseMatrix back = csc.ToFormat(S21SparseMatrix::kCsr);
+  EXPECT_EQ(back.ptr(), csr.ptr());
+  EXPECT_EQ(back.indices(), csr.indices());
+  EXPECT_EQ(back.values(), csr.values());
+  EXPECT_TRUE(csr == csc);
+  EXPECT_THROW(S21SparseMatrix(0, 3), std::invalid_argument);
+}
+
+TEST(Sparse_tests, triplets) {
+  S21SparseMatrix m(3, 4,
+                    {{2, 1, 1.0}, {0, 3, 2.0}, {2, 1, 0.5}, {0, 0, -1.0}},
+                    S21SparseMatrix::kCsc);
+  EXPECT_EQ(m.nnz(), 3u);
+  EXPECT_EQ(m.at(2, 1), 1.5);
+  EXPECT_EQ(m.at(0, 3), 2.0);
+  EXPECT_EQ(m.at(0, 0), -1.0);
+  EXPECT_EQ(m.indices(), std::vector<int>({0, 2, 0}));
+  EXPECT_THROW(S21SparseMatrix(3, 4, {{3, 0, 1.0}}), std::out_of_range);
+}
+
+TEST(Sparse_tests, multiply_dense_and_vector) {
+  for (auto format : {S21SparseMatrix::kCsr, S21SparseMatrix::kCsc}) {
+    S21SparseMatrix a = SparseSample(300, 200, 3, format);
+    S21Matrix dense_a = a.ToDense();
+    for (int n : {1, 7, 600}) {
+      S21Matrix b(200, n);
+      b.sequent_filling(-1, 0.01);
+      EXPECT_TRUE(a * b == dense_a * b);
+    }
+    std::vector<double> x(200);
+    for (int j = 0; j < 200; j++) x[j] = j * 0.25 - 3;
+    std::vector<double> y = a.MulVector(x);
+    for (int i = 0; i < 300; i++) {
+      double check = 0;
+      for (int j = 0; j < 200; j++) check += dense_a(i, j) * x[j];
+      EXPECT_NEAR(y[i], check, 1e-9);
+    }
+    EXPECT_THROW(a * S21Matrix(300, 2), std::invalid_argument);
+    EXPECT_THROW(a.MulVector(std::vector<double>(3)), std::invalid_argument);
+  }
+}
+
+TEST(Sparse_tests, sum_sub_transpose) {
+  S21SparseMatrix a = SparseSample(50, 40, 4, S21SparseMatrix::kCsr);
+  S21SparseMatrix b = SparseSample(50, 40, 2, S21SparseMatrix::kCsc);
+  S21Matrix da = a.ToDense(), db = b.ToDense();
+  S21SparseMatrix sum = a + b;
+  EXPECT_EQ(sum.format(), S21SparseMatrix::kCsr);
+  EXPECT_TRUE(sum.ToDense() == S21Matrix(da + db));
+  EXPECT_TRUE((b - a).ToDense() == S21Matrix(db - da));
+  EXPECT_EQ((a - a).nnz(), 0u);
+  EXPECT_TRUE(a * 3.0 == a + a + a);
+  EXPECT_FALSE(a == b);
+  S21SparseMatrix at = a.Transpose(), bt = b.Transpose();
+  EXPECT_EQ(at.rows(), 40);
+  EXPECT_EQ(bt.format(), S21SparseMatrix::kCsc);
+  EXPECT_TRUE(at.ToDense() == da.Transpose());
+  EXPECT_TRUE(bt.ToDense() == db.Transpose());
+  EXPECT_THROW(a + at, std::invalid_argument);
+}
+
+TEST(Sparse_tests, large_parallel) {
+  const int n = 20000;
+  S21SparseMatrix csr = SparseSample(n, n, 8, S21SparseMatrix::kCsr);
+  S21SparseMatrix csc = csr.ToFormat(S21SparseMatrix::kCsc);
+  EXPECT_TRUE(csr.Transpose().Transpose() == csr);
+  EXPECT_TRUE(csc.Transpose().ToFormat(S21SparseMatrix::kCsr) ==
+              csr.Transpose());
+  std::vector<double> x(n);
+  for (int j = 0; j < n; j++) x[j] = (j % 13) * 0.5 - 3;
+  std::vector<double> y1 = csr.MulVector(x), y2 = csc.MulVector(x);
+  for (int i = 0; i < n; i++) EXPECT_NEAR(y1[i], y2[i], 1e-9);
+  S21Matrix b(n, 3);
+  b.sequent_filling(0, 1e-4);
+  EXPECT_TRUE(csr * b == csc * b);
+  EXPECT_TRUE(csr + csc == csr * 2.0);
+}
+
+//-------------Файлы-------------------
+
+TEST(File_tests, save_load_map) {
+  const char* path = "test_matrix_io.bin";
+  S21Matrix m(37, 53);
+  m.sequent_filling(-3, 0.125);
+  s21::SaveMatrix(m, path);
+  s21::MatrixFileHeader h = s21::ReadMatrixHeader(path);
+  EXPECT_EQ(h.version, s21::kMatrixFileVersion);
+  EXPECT_EQ(h.dtype, s21::DType::kFloat64);
+  EXPECT_EQ(h.rows, 37u);
+  EXPECT_EQ(h.cols, 53u);
+  EXPECT_EQ(h.data_offset % kMatrixAlign, 0u);
+  EXPECT_TRUE(s21::LoadMatrix<double>(path) == m);
+  S21Matrix read_only = s21::MapMatrix<double>(path, s21::MapMode::kReadOnly);
+  EXPECT_TRUE(read_only == m);
+  EXPECT_EQ((uintptr_t)std::as_const(read_only).data() % kMatrixAlign, 0u);
+  {
+    S21Matrix cow = s21::MapMatrix<double>(path);
+    cow(3, 4) = 100;
+    cow += m;
+    EXPECT_EQ(cow(3, 4), 100 + m(3, 4));
+    S21Matrix moved = std::move(cow);
+    EXPECT_EQ(moved(0, 0), 2 * m(0, 0));
+  }
+  EXPECT_TRUE(s21::LoadMatrix<double>(path) == m);
+  EXPECT_TRUE(read_only == m);
+  std::remove(path);
+}
+
+TEST(File_tests, map_read_only_writes) {
+  const char* path = "test_matrix_ro.bin";
+  S21Matrix m(4, 4);
+  m.sequent_filling(1, 1);
+  s21::SaveMatrix(m, path);
+  using s21::MapMode;
+  S21Matrix ro = s21::MapMatrix<double>(path, MapMode::kReadOnly);
+  const double* mapped = std::as_const(ro).data();
+  ro(1, 2) = 100;
+  EXPECT_NE(std::as_const(ro).data(), mapped);
+  EXPECT_EQ(ro(1, 2), 100);
+  EXPECT_EQ(ro(3, 3), m(3, 3));
+  ro = s21::MapMatrix<double>(path, MapMode::kReadOnly);
+  ro = S21Matrix(4, 4);
+  EXPECT_EQ(ro(2, 2), 0);
+  S21Matrix same = s21::MapMatrix<double>(path, MapMode::kReadOnly);
+  same = m;
+  same += m;
+  EXPECT_EQ(same(0, 1), 2 * m(0, 1));
+  S21Matrix expr = s21::MapMatrix<double>(path, MapMode::kReadOnly);
+  expr = expr + m * 2.0;
+  expr -= m;
+  EXPECT_TRUE(expr == m * 2.0);
+  S21Matrix ops = s21::MapMatrix<double>(path, MapMode::kReadOnly);
+  ops.MulNumber(2);
+  ops.TransposeInPlace();
+  ops.Block(0, 0, 2, 2).Fill(0);
+  EXPECT_EQ(ops(3, 0), 2 * m(0, 3));
+  EXPECT_TRUE(s21::LoadMatrix<double>(path) == m);
+  std::remove(path);
+}
+
+TEST(File_tests, types_alignment_endianness) {
+  const char* path = "test_matrix_io.bin";
+  S21MatrixF f(5, 7);
+  f.sequent_filling(1, 0.5f);
+  s21::SaveMatrix(f, path, 4096);
+  EXPECT_EQ(s21::ReadMatrixHeader(path).data_offset, 4096u);
+  EXPECT_TRUE(s21::MapMatrix<float>(path) == f);
+  // Другой тип элемента: файл читается с приведением типа
+  S21Matrix d = s21::MapMatrix<double>(path);
+  S21MatrixLD ld = s21::LoadMatrix<long double>(path);
+  for (int i = 0; i < 5; i++) {
+    for (int j = 0; j < 7; j++) {
+      EXPECT_EQ(d(i, j), f(i, j));
+      EXPECT_EQ(ld(i, j), f(i, j));
+    }
+  }
+  S21MatrixLD big(3, 3);
+  big.sequent_filling(1, 1e-15L);
+  s21::SaveMatrix(big, path);
+  EXPECT_TRUE(s21::MapMatrix<long double>(path) == big);
+  EXPECT_THROW(s21::SaveMatrix(big, path, 100), std::invalid_argument);
+
+  // Файл с обратным порядком байт: заголовок и элементы переставлены
+  S21Matrix m(4, 3);
+  m.sequent_filling(-1, 0.75);
+  s21::SaveMatrix(m, path);
+  std::vector<unsigned char> bytes;
+  {
+    std::ifstream in(path, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(in), {});
+  }
+  auto swap = [&bytes](size_t offset, size_t size) {
+    std::reverse(bytes.begin() + offset, bytes.begin() + offset + size);
+  };
+  swap(8, 4);  // version
+  for (size_t offset : {16, 24, 40, 48}) swap(offset, 8);
+  swap(32, 4);  // alignment
+  bytes[14] = bytes[14] == 1 ? 2 : 1;
+  for (size_t k = 0; k < 12; k++) swap(64 + 8 * k, 8);
+  {
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+  }
+  EXPECT_EQ(s21::ReadMatrixHeader(path).rows, 4u);
+  EXPECT_TRUE(s21::LoadMatrix<double>(path) == m);
+  EXPECT_TRUE(s21::MapMatrix<double>(path) == m);
+  std::remove(path);
+}
+
+TEST(File_tests, errors) {
+  const char* path = "test_matrix_io.bin";
+  EXPECT_THROW(s21::LoadMatrix<double>("no_such_matrix.bin"),
+               std::system_error);
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << std::string(64, 'x');
+  }
+  EXPECT_THROW(s21::LoadMatrix<double>(path), std::runtime_error);
+  S21Matrix m(8, 8);
+  s21::SaveMatrix(m, path);
+  truncate(path, 64 + 8 * 8 * 8 - 1);
+  EXPECT_THROW(s21::MapMatrix<double>(path), std::runtime_error);
+  std::remove(path);
+}
+
+TEST(File_tests, text_round_trip) {
+  S21Matrix m(23, 17);
+  for (int i = 0; i < 23; i++) {
+    for (int j = 0; j < 17; j++) m(i, j) = std::sin(i * 17 + j) * 1e-3 / 7;
+  }
+  m(0, 0) = 1e300;
+  m(0, 1) = -4.9e-324;
+  m(0, 2) = 0.1;
+  for (char delimiter : {' ', ','}) {
+    S21Matrix back =
+        s21::ParseMatrix<double>(s21::FormatMatrix(m, delimiter), delimiter);
+    ASSERT_EQ(back.acc_rows(), 23);
+    ASSERT_EQ(back.acc_cols(), 17);
+    EXPECT_EQ(memcmp(back.data(), m.data(), sizeof(double) * 23 * 17), 0);
+  }
+  EXPECT_EQ(s21::FormatMatrix(S21MatrixF(1, 2)), "0 0\n");
+  S21MatrixF f(2, 2);
+  f(0, 0) = 0.1f;
+  f(1, 1) = -2.5f;
+  EXPECT_EQ(s21::FormatMatrix(f, ','), "0.1,0\n0,-2.5\n");
+  const char* path = "test_matrix_io.txt";
+  s21::SaveMatrixText(m, path);
+  S21Matrix loaded = s21::LoadMatrixText<double>(path);
+  EXPECT_EQ(memcmp(loaded.data(), m.data(), sizeof(double) * 23 * 17), 0);
+  std::remove(path);
+  std::ostringstream out;
+  s21::WriteMatrixText(f, out);
+  EXPECT_EQ(out.str(), "0.1 0\n0 -2.5\n");
+}
+
+TEST(File_tests, text_parse) {
+  S21Matrix m = s21::ParseMatrix<double>("\n 1\t+2  3 \r\n\n4 5e1 -6\n");
+  ASSERT_EQ(m.acc_rows(), 2);
+  ASSERT_EQ(m.acc_cols(), 3);
+  EXPECT_EQ(m(0, 1), 2);
+  EXPECT_EQ(m(1, 1), 50);
+  S21MatrixLD csv = s21::ParseMatrix<long double>("1 , 2\n3,4", ',');
+  EXPECT_EQ(csv(1, 0), 3);
+  EXPECT_THROW(s21::ParseMatrix<double>("1 2\n3\n"), std::runtime_error);
+  EXPECT_THROW(s21::ParseMatrix<double>("1 2x\n"), std::runtime_error);
+  EXPECT_THROW(s21::ParseMatrix<double>("1,2,\n", ','), std::runtime_error);
+  EXPECT_THROW(s21::ParseMatrix<double>("1 2\n", ','), std::runtime_error);
+  EXPECT_THROW(s21::ParseMatrix<double>(" \n\n"), std::runtime_error);
+  try {
+    s21::ParseMatrix<double>("1 2\n\n3 4\n5 a\n");
+    FAIL();
+  } catch (const std::runtime_error& e) {
+    EXPECT_NE(std::string(e.what()).find("строке 4"), std::string::npos);
+  }
+}
+
+TEST(File_tests, text_read_stream) {
+  S21Matrix m(2, 3);
+  std::istringstream in("1 2\n\n +3 4e1\r\n5 6 7\nrest\n");
+  s21::ReadMatrixText(m, in);
+  EXPECT_EQ(m(0, 2), 3);
+  EXPECT_EQ(m(1, 0), 40);
+  EXPECT_EQ(m(1, 2), 6);
+  std::string rest;
+  std::getline(in, rest);
+  EXPECT_EQ(rest, "rest");
+  std::istringstream csv("1.5, 2\n3,4\n5,6\n");
+  S21MatrixF f(3, 2);
+  s21::ReadMatrixText(f, csv, ',');
+  EXPECT_EQ(f(2, 1), 6);
+  std::istringstream bad("1 2 x\n"), short_input("1 2 3\n");
+  EXPECT_THROW(s21::ReadMatrixText(m, bad), std::runtime_error);
+  EXPECT_THROW(s21::ReadMatrixText(m, short_input), std::runtime_error);
+
+  std::istringstream console("0.5 -1\n2 3\n");
+  std::streambuf* saved = std::cin.rdbuf(console.rdbuf());
+  S21Matrix c(2, 2);
+  c.fill_matrix();
+  std::cin.rdbuf(saved);
+  EXPECT_EQ(c(0, 0), 0.5);
+  EXPECT_EQ(c(1, 1), 3);
+}
+
+TEST(File_tests, text_large_parallel) {
+  int threads = S21ThreadPool::ThreadCount();
+  S21ThreadPool::SetThreadCount(4);
+  S21Matrix m(3000, 250);
+  m.sequent_filling(-1000, 1.0 / 3);
+  std::string text = s21::FormatMatrix(m);
+  EXPECT_GT(text.size(), 4 * s21::kTextChunk);
+  S21Matrix back = s21::ParseMatrix<double>(text);
+  EXPECT_EQ(memcmp(back.data(), m.data(), sizeof(double) * 3000 * 250), 0);
+  size_t pos = text.size() / 2;
+  pos = text.find('\n', pos) + 1;
+  text.insert(pos, "1 2\n");
+  try {
+    s21::ParseMatrix<double>(text);
+    FAIL();
+  } catch (const std::runtime_error& e) {
+    std::string line = std::to_string(std::count(
+                           text.begin(), text.begin() + pos, '\n') + 1);
+    EXPECT_NE(std::string(e.what()).find("строке " + line), std::string::npos);
+  }
+  S21ThreadPool::SetThreadCount(threads);
+}
+
+//-------------Strassen-------------------
+
+// Наибольшая относительная разница произведения по Штрассену с порогом
+// crossover и классического
+template <typename T>
+double StrassenError(int m, int k, int n, int crossover) {
+  S21BasicMatrix<T> a(m, k), b(k, n);
+  a.sequent_filling(-1, T(0.37) / k);
+  b.sequent_filling(1, T(-0.29) / n);
+  s21::SetStrassenCrossover(0);
+  S21BasicMatrix<T> classic = a * b;
+  s21::SetStrassenCrossover(crossover);
+  S21BasicMatrix<T> fast = a * b;
+  s21::SetStrassenCrossover(0);
+  double worst = 0;
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      double err = fabs((double)(fast(i, j) - classic(i, j))) /
+                   (1 + fabs((double)classic(i, j)));
+      worst = std::max(worst, err);
+    }
+  }
+  return worst;
+}
+
+TEST(Strassen_tests, odd_and_rectangular_shapes) {
+  const int shapes[][3] = {{64, 64, 64},   {37, 41, 29},  {65, 130, 97},
+                           {100, 17, 90},  {129, 33, 70}, {31, 200, 45}};
+  for (const auto& s : shapes) {
+    for (int crossover : {4, 8, 15}) {
+      EXPECT_LT(StrassenError<double>(s[0], s[1], s[2], crossover), 1e-10)
+          << s[0] << "x" << s[1] << "x" << s[2] << " crossover " << crossover;
+    }
+  }
+  EXPECT_LT(StrassenError<float>(67, 71, 73, 8), 2e-3);
+  EXPECT_LT(StrassenError<long double>(67, 71, 73, 8), 1e-13);
+}
+
+TEST(Strassen_tests, parallel_levels_and_reuse) {
+  int threads = S21ThreadPool::ThreadCount();
+  for (int count : {2, 9, 60}) {
+    S21ThreadPool::SetThreadCount(count);
+    EXPECT_LT(StrassenError<double>(131, 140, 150, 16), 1e-10) << count;
+  }
+  S21ThreadPool::SetThreadCount(threads);
+  S21Matrix a(90, 90), b(90, 90);
+  a.sequent_filling(0.5, 0.001);
+  b.sequent_filling(-0.5, 0.002);
+  s21::SetStrassenCrossover(10);
+  EXPECT_EQ(s21::StrassenCrossover(), 10);
+  S21Matrix first = a * b;
+  S21Matrix big(200, 200);
+  big *= big;  // рабочий буфер растет, затем переиспользуется
+  S21Matrix second = a * b;
+  s21::SetStrassenCrossover(-5);
+  EXPECT_EQ(s21::StrassenCrossover(), 0);
+  EXPECT_EQ(memcmp(first.data(), second.data(), sizeof(double) * 90 * 90), 0);
+}
+
+TEST(Strassen_tests, nested_in_parallel_for) {
+  int threads = S21ThreadPool::ThreadCount();
+  S21ThreadPool::SetThreadCount(4);
+  // Поток, ждущий свои задачи, выполняет чужое произведение, пока его
+  // рабочий буфер занят внешней рекурсией
+  std::vector<S21Matrix> a, b, expected, c(16);
+  for (int i = 0; i < 16; i++) {
+    int n = 128 + 64 * i;
+    a.emplace_back(n, n);
+    b.emplace_back(n, n);
+    a[i].sequent_filling(-1, 0.37 / n);
+    b[i].sequent_filling(1, -0.29 / n);
+    expected.push_back(a[i] * b[i]);
+  }
+  s21::SetStrassenCrossover(32);
+  S21ThreadPool::Instance().ParallelFor(16, [&](int i) { c[i] = a[i] * b[i]; });
+  s21::SetStrassenCrossover(0);
+  S21ThreadPool::SetThreadCount(threads);
+  for (int i = 0; i < 16; i++) {
+    double worst = 0;
+    for (int r = 0; r < c[i].acc_rows(); r++) {
+      for (int j = 0; j < c[i].acc_cols(); j++) {
+        double err = fabs(c[i](r, j) - expected[i](r, j)) /
+                     (1 + fabs(expected[i](r, j)));
+        worst = std::max(worst, err);
+      }
+    }
+    EXPECT_LT(worst, 1e-10) << i;
+  }
+}
+
+//-------------ThreadPool-------------------
+
+TEST(ThreadPool_tests, parallel_for_all_indexes) {
+  S21ThreadPool::SetThreadCount(4);
+  EXPECT_EQ(S21ThreadPool::ThreadCount(), 4);
+  std::vector<int> hits(1000, 0);
+  S21ThreadPool::Instance().ParallelFor(1000, [&](int i) { hits[i]++; });
+  S21ThreadPool::SetThreadCount(0);
+  int sum = 0;
+  for (int h : hits) sum += h;
+  EXPECT_EQ(sum, 1000);
+}
+
+TEST(ThreadPool_tests, parallel_for_exception) {
+  S21ThreadPool::SetThreadCount(3);
+  EXPECT_THROW(S21ThreadPool::Instance().ParallelFor(
+                   10,
+                   [](int i) {
+                     if (i == 7) throw std::out_of_range("task");
+                   }),
+               std::out_of_range);
+  S21ThreadPool::SetThreadCount(0);
+}
+
+//-------------Allocator-------------------
+
+TEST(Allocator_tests, pool_recycles_by_size_class) {
+  S21PoolAllocator pool;
+  S21Allocator::SetDefault(&pool);
+  for (int i = 0; i < 50; i++) {
+    S21Matrix a(100, 100), b(99, 101);
+    a.sequent_filling(i, 1);
+    b = a + a;
+    EXPECT_EQ(b(99, 99), 2 * (i + 9999));
+  }
+  S21PoolAllocator::Stats stats = pool.stats();
+  S21Allocator::SetDefault(nullptr);
+  // 100 x 100 и 99 x 101 попадают в один класс. Одновременно живут 3 буфера
+  // (a, b и результат выражения другой формы), остальные выделения из кэша
+  EXPECT_EQ(stats.misses, 3u);
+  EXPECT_EQ(stats.hits, 147u);
+  EXPECT_GT(stats.cached_bytes, 0u);
+  pool.SetMaxCachedBytes(0);
+  EXPECT_EQ(pool.stats().cached_bytes, 0u);
+}
+
+TEST(Allocator_tests, arena_scope_temporaries) {
+  S21Matrix result(4, 4);
+  {
+    S21ArenaScope arena(1 << 16);
+    S21Matrix sum(4, 4);
+    for (int i = 0; i < 1000; i++) {
+      S21Matrix a(4, 4);
+      a.sequent_filling(1, 1);
+      sum += a * 2.0;
+    }
+    EXPECT_EQ(arena.reserved_bytes(), 1u << 16);
+    {
+      S21ArenaScope inner;
+      S21Matrix t = sum.Transpose();
+      result = t;
+    }
+    result = sum;
+  }
+  EXPECT_EQ(result(3, 3), 32000);
+}
+
+TEST(Allocator_tests, arena_matrix_outlives_scope) {
+  auto make = [] {
+    S21ArenaScope arena;
+    S21Matrix a(3, 3);
+    a.sequent_filling(1, 1);
+    return a;
+  };
+  S21Matrix escaped = make();
+  S21Matrix copy(escaped);
+  EXPECT_EQ(escaped(2, 2), 9);
+  EXPECT_TRUE(copy == escaped);
+}
+
+//-------------FixedMatrix-------------------
+
+// Проверки на этапе компиляции: constexpr-вычисления и размеры в типе
+constexpr S21FixedMatrix<2, 2> kFixed2{4, 7, 2, 6};
+static_assert(kFixed2.Determinant() == 10, "constexpr determinant");
+static_assert(kFixed2.Transpose()(0, 1) == 2, "constexpr transpose");
+static_assert((kFixed2 * S21FixedMatrix<2, 3>{1, 0, 1, 0, 1, 1})(0, 2) == 11,
+              "constexpr product");
+static_assert((kFixed2 * kFixed2.InverseMatrix())
+                  .EqMatrix(S21FixedMatrix<2, 2>::Identity()),
+              "constexpr inverse");
+
+template <typename A, typename B, typename = void>
+struct CanMultiply : std::false_type {};
+template <typename A, typename B>
+struct CanMultiply<A, B,
+                   std::void_t<decltype(std::declval<A>() * std::declval<B>())>>
+    : std::true_type {};
+static_assert(CanMultiply<S21FixedMatrix<2, 3>, S21FixedMatrix<3, 4>>::value,
+              "2x3 * 3x4");
+static_assert(!CanMultiply<S21FixedMatrix<2, 3>, S21FixedMatrix<2, 3>>::value,
+              "2x3 * 2x3 must not compile");
+
+template <int N>
+void CheckFixedAgainstDynamic() {
+  S21FixedMatrix<N, N> a;
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < N; j++) a(i, j) = ((i * 5 + j * 3) % 7 - 3) * 0.5;
+    a(i, i) += N;
+  }
+  S21Matrix dynamic = a.ToMatrix();
+  EXPECT_NEAR(a.Determinant(), dynamic.Determinant(),
+              1e-12 * fabs(dynamic.Determinant()));
+  S21FixedMatrix<N, N> inv = a.InverseMatrix();
+  EXPECT_TRUE(inv.ToMatrix() == dynamic.InverseMatrix());
+  EXPECT_TRUE(a * inv == (S21FixedMatrix<N, N>::Identity()));
+  EXPECT_TRUE(a.Transpose().ToMatrix() == dynamic.Transpose());
+}
+
+TEST(FixedMatrix_tests, closed_form_and_gauss) {
+  CheckFixedAgainstDynamic<1>();
+  CheckFixedAgainstDynamic<2>();
+  CheckFixedAgainstDynamic<3>();
+  CheckFixedAgainstDynamic<4>();
+  CheckFixedAgainstDynamic<6>();
+}
+
+TEST(FixedMatrix_tests, singular_inverse) {
+  S21FixedMatrix<3, 3> a{1, 2, 3, 4, 5, 6, 7, 8, 9};
+  S21FixedMatrix<4, 4> b{1, 2, 3, 4, 2, 4, 6, 8, 0, 1, 0, 1, 5, 5, 5, 5};
+  S21FixedMatrix<5, 5> c;
+  EXPECT_EQ(a.Determinant(), 0);
+  EXPECT_THROW(a.InverseMatrix(), std::invalid_argument);
+  EXPECT_THROW(b.InverseMatrix(), std::invalid_argument);
+  EXPECT_THROW(c.InverseMatrix(), std::invalid_argument);
+  EXPECT_EQ(c.Determinant(), 0);
+}
+
+TEST(FixedMatrix_tests, operations_and_conversion) {
+  S21FixedMatrix<2, 3> a{1, 2, 3, 4, 5, 6};
+  S21FixedMatrix<2, 3> b = a * 2.0 - a;
+  b += a;
+  b *= 0.5;
+  EXPECT_TRUE(b == a);
+  S21FixedMatrix<3, 3> rot{0, -1, 0, 1, 0, 0, 0, 0, 1};
+  a *= rot;
+  EXPECT_EQ(a(1, 0), 5);
+  EXPECT_EQ(a(1, 1), -4);
+  S21Matrix dynamic = a.ToMatrix();
+  EXPECT_EQ(dynamic.acc_rows(), 2);
+  EXPECT_TRUE((S21FixedMatrix<2, 3>(dynamic) == a));
+  EXPECT_THROW((S21FixedMatrix<3, 2>(dynamic)), std::invalid_argument);
+  EXPECT_THROW((S21FixedMatrix<1, 1>{1, 2}), std::invalid_argument);
+}
+
 //-------------main-------------------
 
 int main() {